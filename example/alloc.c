@@ -0,0 +1,101 @@
+#include "recorder.h"
+
+// The heap use reported for each test of the last run.
+static cunit_alloc_stats_t leak, balanced, setup_only, too_many;
+
+// Stores the blocks, so that the compiler cannot leave out the allocations.
+// Per thread, since the tests may run on several at once.
+static __thread void *volatile kept;
+static __thread void *fixture;
+static void *leaked;
+
+static void on_test_end(const cunit_test_report_t *test) {
+	if (!test->alloc) { return; }
+	if (strcmp(test->name, "Leak") == 0) { leak = *test->alloc; }
+	if (strcmp(test->name, "Balanced") == 0) { balanced = *test->alloc; }
+	if (strcmp(test->name, "Setup") == 0) { setup_only = *test->alloc; }
+	if (strcmp(test->name, "Too many") == 0) { too_many = *test->alloc; }
+}
+
+static void setup(void) { fixture = malloc(16); }
+static void teardown(void) { free(fixture); }
+
+static void test_leak(void) {
+	leaked = malloc(100);
+	kept   = leaked;
+	assert_alloc_unfreed_le(16 + 100);
+}
+
+static void test_balanced(void) {
+	void *block = malloc(32);
+	kept        = block;
+	block       = realloc(block, 64);
+	kept        = block;
+	free(block);
+	assert_alloc_count_le(3);
+	assert_alloc_peak_le(16 + 64);
+	assert_alloc_unfreed_le(16);
+}
+
+static void test_setup_only(void) {
+	cunit_alloc_stats_t stats;
+	assert_true(cunit_alloc_stats(&stats));
+	assert_uint64_eq(stats.count, 1);
+	assert_alloc_count_le(1);
+}
+
+static void test_too_many(void) {
+	for (int i = 0; i < 3; i++) {
+		kept = malloc(8);
+		free(kept);
+	}
+	assert_alloc_count_le(2);
+}
+
+// Runs the tests and checks the heap use that was reported.
+static bool run(void) {
+	memset(&leak, 0, sizeof(leak));
+	memset(&balanced, 0, sizeof(balanced));
+	memset(&setup_only, 0, sizeof(setup_only));
+	memset(&too_many, 0, sizeof(too_many));
+	recorder_test_end = on_test_end;
+	cunit_add_reporter(&recorder);
+	CUNIT_SUITE_BEGIN("Alloc", setup, teardown)
+	CUNIT_TEST("Leak", test_leak)
+	CUNIT_TEST("Balanced", test_balanced)
+	CUNIT_TEST("Setup", test_setup_only)
+	CUNIT_TEST("Too many", test_too_many)
+	CUNIT_SUITE_END()
+
+	if (cunit_run() != 1 || recorded.failed != 1) { return false; }
+	free(leaked);
+	leaked = NULL;
+
+	// The setup and teardown of each test count as well.
+	if (leak.count != 2 || leak.frees != 1 || leak.bytes != 116 || leak.peak != 116 || leak.unfreed != 100 || leak.unfreed_count != 1) { return false; }
+	if (balanced.count != 3 || balanced.frees != 3 || balanced.bytes != 112 || balanced.peak != 80 || balanced.unfreed != 0) { return false; }
+	if (setup_only.count != 1 || setup_only.unfreed != 0) { return false; }
+	// Reporting the failure is not counted.
+	return too_many.count == 4 && too_many.frees == 4;
+}
+
+int main(void) {
+	cunit_init();
+	if (!cunit_alloc_tracking()) { return -1; }
+
+	// Outside of a test nothing is counted.
+	cunit_alloc_stats_t stats;
+	if (cunit_alloc_stats(&stats)) { return -1; }
+
+	if (!run()) { return -1; }
+
+	// Each worker thread counts the allocations of its own tests.
+	cunit_set_jobs(2);
+	if (!run()) { return -1; }
+
+	// A forked worker sends the counters back with the result.
+	cunit_set_jobs(2);
+	cunit_set_exec_mode(CUNIT_EXEC_MODE_FORK);
+	if (!run()) { return -1; }
+	return 0;
+}
@@ -0,0 +1,120 @@
+#include "recorder.h"
+
+// Two large equal buffers, for the benchmark.
+#define LARGE ((size_t)64 << 20)
+static uint8_t *large_l, *large_r;
+
+// Returns the offset the last failure reported, or UINT64_MAX if it reported none.
+static uint64_t offset(void) {
+	unsigned long long at = 0;
+	return sscanf(recorded.message, "memory differs at offset %llu", &at) == 1 ? at : UINT64_MAX;
+}
+
+static void test_equal(void) {
+	const int8_t   i8[]  = {-1, 0, 1};
+	const int16_t  i16[] = {-300, 0, 300};
+	const int32_t  i32[] = {-70000, 0, 70000};
+	const int64_t  i64[] = {-5000000000ll, 0, 5000000000ll};
+	const uint8_t  u8[]  = {0, 1, 255};
+	const uint16_t u16[] = {0, 1, 65535};
+	const uint32_t u32[] = {0, 1, 4000000000u};
+	const uint64_t u64[] = {0, 1, 18000000000000000000ull};
+	int8_t         i8_copy[3];
+	memcpy(i8_copy, i8, sizeof(i8));
+
+	assert_array_eq_i8(i8, i8_copy, 3);
+	assert_array_eq_i16(i16, i16, 3);
+	assert_array_eq_i32(i32, i32, 3);
+	assert_array_eq_i64(i64, i64, 3);
+	assert_array_eq_u8(u8, u8, 3);
+	assert_array_eq_u16(u16, u16, 3);
+	assert_array_eq_u32(u32, u32, 3);
+	assert_array_eq_u64(u64, u64, 3);
+	assert_mem_eq(i64, i64, sizeof(i64));
+	assert_array_eq_i32((const int32_t *)NULL, (const int32_t *)NULL, 5);
+	assert_int_eq(recorded.failures, 0);
+}
+
+static void test_window(void) {
+	int32_t l[20], r[20];
+	for (int i = 0; i < 20; i++) { l[i] = r[i] = i; }
+	r[10] = -1;
+	assert_false(check_array_eq_i32(l, r, 20));
+	assert_str_eq(recorded.message,
+				  "arrays differ at index 10 of 20: {..., 6, 7, 8, 9, [10], 11, 12, 13, 14, ...} != {..., 6, 7, 8, 9, [-1], 11, 12, 13, 14, ...}");
+
+	// The window ends at either end of the arrays.
+	const uint8_t a[] = {1, 2, 3}, b[] = {9, 2, 3};
+	assert_false(check_array_eq_u8(a, b, 3));
+	assert_str_eq(recorded.message, "arrays differ at index 0 of 3: {[1], 2, 3} != {[9], 2, 3}");
+
+	// Only the first `n` elements are compared, and the mismatch is in whole elements.
+	const int64_t c[] = {1, -2, 3}, d[] = {1, 2, 4};
+	assert_true(check_array_eq_i64(c, d, 1));
+	assert_false(check_array_eq_i64(c, d, 3));
+	assert_str_eq(recorded.message, "arrays differ at index 1 of 3: {1, [-2], 3} != {1, [2], 4}");
+
+	const uint8_t e[] = {1, 2, 3, 4}, f[] = {1, 2, 7, 4};
+	assert_false(check_mem_eq(e, f, 4));
+	assert_str_eq(recorded.message, "memory differs at offset 2 of 4: `01 02 [03] 04` != `01 02 [07] 04`");
+
+	assert_false(check_array_eq_u16((const uint16_t *)NULL, (const uint16_t *)b, 1));
+	assert_str_eq(recorded.message, "(null) != array");
+	assert_int_eq(recorded.failures, 5);
+}
+
+// Every size and position, so that each block size and tail of the SIMD loops is crossed.
+static void test_positions(void) {
+	static uint8_t l[300], r[300];
+	for (int i = 0; i < 300; i++) { l[i] = r[i] = (uint8_t)(i * 7); }
+	for (size_t size = 0; size <= 300; size++) {
+		assert_true(check_mem_eq(l, r, size));
+		for (size_t at = 0; at < size; at++) {
+			r[at] ^= 0x80;
+			recorded.message[0] = '\0';
+			assert_false(check_mem_eq(l, r, size));
+			assert_uint64_eq(offset(), at);
+			r[at] ^= 0x80;
+		}
+	}
+}
+
+// A mismatch at the very end of large buffers.
+static void test_large(void) {
+	large_r[LARGE - 1] = 0;
+	assert_false(check_mem_eq(large_l, large_r, LARGE));
+	assert_uint64_eq(offset(), LARGE - 1);
+	large_r[LARGE - 1] = large_l[LARGE - 1];
+}
+
+static void bench_mem_eq(void) {
+	const bool equal = check_mem_eq(large_l, large_r, LARGE);
+	cunit_do_not_optimize(equal);
+}
+
+int main(void) {
+	cunit_init();
+	cunit_set_reporter(&recorder);
+	cunit_set_bench_time(0.02);
+	cunit_set_bench_repetitions(3);
+	large_l = (uint8_t *)malloc(LARGE);
+	large_r = (uint8_t *)malloc(LARGE);
+	if (!large_l || !large_r) { return -1; }
+	memset(large_l, 0x5A, LARGE);
+	memset(large_r, 0x5A, LARGE);
+
+	CUNIT_SUITE_BEGIN("Array equality", NULL, NULL)
+	CUNIT_TEST("Equal", test_equal)
+	CUNIT_TEST("Window", test_window)
+	CUNIT_TEST("Positions", test_positions)
+	CUNIT_TEST("Large", test_large)
+	CUNIT_BENCH("64 MB", bench_mem_eq)
+	CUNIT_SUITE_END()
+
+	const int result = cunit_run();
+	free(large_l);
+	free(large_r);
+	if (result != 0 || recorded.failed != 0 || recorded.median <= 0) { return -1; }
+	printf("assert_mem_eq: %.1f GB/s on 64 MB\n", (double)LARGE / recorded.median);
+	return 0;
+}
@@ -0,0 +1,56 @@
+#include "cunit.h"
+
+// The number of assertions per benchmark iteration.
+#define ASSERTIONS 1000
+
+static int values[ASSERTIONS];
+
+// Passing assertions, compared in the caller.
+static void bench_inline(void) {
+	for (int i = 0; i < ASSERTIONS; i++) { assert_int_eq(values[i], i); }
+	cunit_clobber_memory();
+}
+
+// The same assertions through the out-of-line comparison they used to call.
+static void bench_out_of_line(void) {
+	for (int i = 0; i < ASSERTIONS; i++) {
+		if (!__cunit_compare_int32(CUNIT_CTX_CURR, values[i], i, CUnit_Equal, STR_NULL)) { cunit__handle_fail(CUNIT_CTX_CURR); }
+	}
+	cunit_clobber_memory();
+}
+
+// Failing checks still report their operands, and the note is formatted only then.
+static int formatted;
+static int note(void) { return ++formatted; }
+
+static void test_failure_path(void) {
+	int calls = 0;
+	check_int_eq(++calls, 1, "note %d", note());
+	assert_int_eq(calls, 1);
+	assert_int_eq(formatted, 0);
+	check_int64_lt(++calls, 0, "note %d", note());
+	assert_int_eq(calls, 2);
+	assert_int_eq(formatted, 1);
+}
+
+int main(void) {
+	cunit_init();
+	cunit_set_bench_time(0.002);
+	cunit_set_bench_repetitions(5);
+	for (int i = 0; i < ASSERTIONS; i++) { values[i] = i; }
+
+	CUNIT_SUITE_BEGIN("Assertions", NULL, NULL)
+	CUNIT_TEST("Failure path", test_failure_path)
+	CUNIT_BENCH("Inline", bench_inline)
+	CUNIT_BENCH("Out of line", bench_out_of_line)
+	CUNIT_SUITE_END()
+
+	if (cunit_run_suite("Assertions") != 0) { return -1; }
+	cunit_bench_stats_t inline_stats, call_stats;
+	if (!cunit_bench_stats("Assertions", "Inline", &inline_stats) || !cunit_bench_stats("Assertions", "Out of line", &call_stats)) { return -1; }
+	printf("assert_int_eq: %.3g assertions/s inline, %.3g assertions/s out of line\n", ASSERTIONS * 1e9 / inline_stats.median,
+		   ASSERTIONS * 1e9 / call_stats.median);
+
+	cunit_cleanup();
+	return 0;
+}
@@ -0,0 +1,104 @@
+#include "recorder.h"
+
+// What was reported for the last run.
+static uint64_t       many, failing, nothing, suite_total;
+static cunit_status_t nothing_status;
+
+static void on_test_end(const cunit_test_report_t *test) {
+	if (strcmp(test->name, "Many") == 0) { many = test->assertions; }
+	if (strcmp(test->name, "Failing") == 0) { failing = test->assertions; }
+	if (strcmp(test->name, "Nothing") == 0) {
+		nothing        = test->assertions;
+		nothing_status = test->status;
+	}
+}
+
+static void on_suite_end(const cunit_suite_report_t *suite) {
+	if (strcmp(suite->name, "Counts") == 0) { suite_total = suite->assertions; }
+}
+
+static int fixture;
+
+static void setup(void) {
+	fixture = 1;
+	check_int_eq(fixture, 1);
+}
+
+static void test_many(void) {
+	for (int i = 0; i < 1000; i++) { assert_int_eq(i % 7 < 7, 1); }
+	check_str_eq("a", "a");
+}
+
+// A failed check counts, and so does the assertion that ends the test.
+static void test_failing(void) {
+	check_int_eq(1, 2);
+	assert_null(&fixture);
+	check_true(true);
+}
+
+static void test_nothing(void) { fixture++; }
+
+static void bench_nothing(void) { cunit_do_not_optimize(fixture); }
+
+static void add_suites(void) {
+	recorder_test_end  = on_test_end;
+	recorder_suite_end = on_suite_end;
+	cunit_add_reporter(&recorder);
+	cunit_set_bench_time(0.0005);
+	cunit_set_bench_repetitions(3);
+
+	CUNIT_SUITE_BEGIN("Counts", setup, NULL)
+	CUNIT_TEST("Many", test_many)
+	CUNIT_TEST("Failing", test_failing)
+	CUNIT_SUITE_END()
+
+	CUNIT_SUITE_BEGIN("Empty", NULL, NULL)
+	CUNIT_TEST("Nothing", test_nothing)
+	CUNIT_BENCH("Bench", bench_nothing)
+	CUNIT_SUITE_END()
+}
+
+// Runs the tests and checks the counts that were reported.
+static bool run(cunit_zero_assertions_t mode) {
+	memset(&recorded, 0, sizeof(recorded));
+	many = failing = nothing = suite_total = 0;
+	cunit_set_zero_assertions(mode);
+	add_suites();
+
+	// Only the test that made no assertions fails in addition, and only when asked to.
+	const int expected = mode == CUNIT_ZERO_ASSERTIONS_FAIL ? 2 : 1;
+	if (cunit_run() != expected) { return false; }
+	if (nothing_status != (mode == CUNIT_ZERO_ASSERTIONS_FAIL ? CUNIT_STATUS_FAILED : CUNIT_STATUS_PASSED)) { return false; }
+
+	// The setup of each test makes one check.
+	return many == 1 + 1000 + 1 && failing == 1 + 2 && nothing == 0 && suite_total == many + failing && recorded.assertions == suite_total;
+}
+
+int main(void) {
+	cunit_init();
+
+	if (!run(CUNIT_ZERO_ASSERTIONS_WARN)) { return -1; }
+	if (!run(CUNIT_ZERO_ASSERTIONS_IGNORE)) { return -1; }
+	if (!run(CUNIT_ZERO_ASSERTIONS_FAIL)) { return -1; }
+
+	// Each worker thread counts the assertions of its own tests.
+	cunit_set_jobs(2);
+	if (!run(CUNIT_ZERO_ASSERTIONS_FAIL)) { return -1; }
+
+#ifndef _WIN32
+	// A forked worker sends the count back with the result.
+	cunit_set_jobs(2);
+	cunit_set_exec_mode(CUNIT_EXEC_MODE_FORK);
+	if (!run(CUNIT_ZERO_ASSERTIONS_FAIL)) { return -1; }
+#endif
+
+	// The counts stay available after cunit_run_suite().
+	add_suites();
+	if (cunit_run_suite("Counts") != 1) { return -1; }
+	uint64_t count = 0;
+	if (!cunit_test_assertions("Counts", "Many", &count) || count != 1002) { return -1; }
+	if (cunit_test_assertions("Counts", "Missing", &count)) { return -1; }
+	if (cunit_assertion_count() != 1002 + 3) { return -1; }
+	cunit_cleanup();
+	return 0;
+}
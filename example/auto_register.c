@@ -0,0 +1,39 @@
+#include "cunit.h"
+
+int auto_runs;
+
+CUNIT_TEST_AUTO(Auto, First) {
+	auto_runs++;
+	assert_true(true);
+}
+
+CUNIT_TEST_AUTO(Auto, Second) {
+	auto_runs++;
+	assert_int_eq(1 + 1, 2);
+}
+
+CUNIT_TEST_AUTO(Other, Only) { auto_runs++; }
+
+static void test_manual(void) { auto_runs++; }
+
+int main(void) {
+	// The tests of both files are found without registering them here, and
+	// suites of the same name are merged.
+	cunit_init();
+	if (cunit_suite_count() != 2) { return -1; }
+	if (cunit_run_suite("Other") != 0 || auto_runs != 1) { return -1; }
+	cunit_cleanup();
+
+	// Tests registered by hand sit next to them.
+	auto_runs = 0;
+	cunit_init();
+	CUNIT_SUITE_BEGIN("Manual", NULL, NULL)
+	CUNIT_TEST("Manual", test_manual)
+	CUNIT_SUITE_END()
+	if (cunit_run() != 0 || auto_runs != 5) { return -1; }
+
+	// The registry is gone after the run; the next one finds the tests again.
+	auto_runs = 0;
+	if (cunit_run() != 0 || auto_runs != 4) { return -1; }
+	return 0;
+}
@@ -0,0 +1,5 @@
+#include "cunit.h"
+
+extern int auto_runs;
+
+CUNIT_TEST_AUTO(Auto, Third) { auto_runs++; }
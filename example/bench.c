@@ -0,0 +1,50 @@
+#include "cunit.h"
+
+static int data[256];
+
+static void bench_sum(void) {
+	int sum = 0;
+	for (int i = 0; i < 256; i++) { sum += data[i]; }
+	cunit_do_not_optimize(sum);
+}
+
+static void bench_fill(void) {
+	memset(data, 1, sizeof(data));
+	cunit_clobber_memory();
+}
+
+static void bench_failing(void) { assert_int_eq(data[0], -1); }
+
+static void test_plain(void) { assert_true(true); }
+
+int main(void) {
+	cunit_init();
+	cunit_set_jobs(2);
+	cunit_set_bench_time(0.002);
+	cunit_set_bench_repetitions(5);
+
+	CUNIT_SUITE_BEGIN("Bench", NULL, NULL)
+	CUNIT_TEST("Plain", test_plain)
+	CUNIT_BENCH("Sum", bench_sum)
+	CUNIT_BENCH("Fill", bench_fill)
+	CUNIT_BENCH("Failing", bench_failing)
+	CUNIT_SUITE_END()
+
+	// Only the failing benchmark fails; it has no statistics.
+	if (cunit_run_suite("Bench") != 1) { return -1; }
+	cunit_bench_stats_t stats;
+	if (cunit_bench_stats("Bench", "Failing", &stats) || cunit_bench_stats("Bench", "Plain", &stats)) { return -1; }
+
+	const char *const names[] = {"Sum", "Fill"};
+	for (int i = 0; i < 2; i++) {
+		if (!cunit_bench_stats("Bench", names[i], &stats)) { return -1; }
+		if (stats.repetitions != 5 || stats.iterations < 1) { return -1; }
+		if (!(stats.min > 0.0 && stats.min <= stats.median && stats.min <= stats.mean)) { return -1; }
+		if (stats.stddev < 0.0 || stats.mad < 0.0) { return -1; }
+		// Repetitions were calibrated to the target time; warmed-up ones may run a little faster.
+		if (stats.min * (double)stats.iterations < 0.001 * 1e9) { return -1; }
+	}
+
+	cunit_cleanup();
+	return 0;
+}
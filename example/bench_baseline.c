@@ -0,0 +1,65 @@
+#include <string.h>
+
+#include "cunit.h"
+
+// The regressions reported, and the failures that named a place in the code.
+static int regressions, placed;
+
+static void on_failure(void *data, const cunit_failure_t *failure) {
+	(void)data;
+	regressions += failure->message && strstr(failure->message, "Baseline / Slow regressed") != NULL;
+	placed += failure->ctx.file != NULL;
+}
+
+static const cunit_reporter_t failures = {NULL, NULL, NULL, NULL, on_failure, NULL, NULL, NULL, NULL};
+
+static void bench_work(void) {
+	int sum = 0;
+	for (int i = 0; i < 64; i++) { sum += i * i; }
+	cunit_do_not_optimize(sum);
+}
+
+// Runs the benchmarks against `baseline` and returns the number that failed.
+static int run(const char *baseline, bool update, double percent) {
+	cunit_init();
+	cunit_add_reporter(&failures);
+	cunit_set_bench_time(0.001);
+	cunit_set_bench_repetitions(5);
+	cunit_set_bench_baseline(baseline);
+	cunit_set_bench_update(update);
+	// Only the percentage decides, so that noise on a loaded machine cannot hide the regression.
+	cunit_set_bench_threshold(percent, 0.0);
+	CUNIT_SUITE_BEGIN("Baseline", NULL, NULL)
+	CUNIT_BENCH("Slow", bench_work)
+	CUNIT_BENCH("Fast", bench_work)
+	CUNIT_BENCH("New", bench_work)
+	CUNIT_SUITE_END()
+	const int failed = cunit_run_suite("Baseline");
+	cunit_cleanup();
+	return failed;
+}
+
+int main(void) {
+	const char *baseline = "bench_baseline.txt";
+	FILE       *file     = fopen(baseline, "w");
+	if (!file) { return -1; }
+	// "Slow" has a baseline it can never match, "Fast" one it always beats.
+	fputs("Baseline\tSlow\t0.001\t0\t0.001\t0\n", file);
+	fputs("Baseline\tFast\t1e12\t0\t1e12\t0\n", file);
+	fclose(file);
+
+	// Only "Slow" regresses; "New" is recorded. A generous threshold keeps
+	// "New" from failing on noise in the second run.
+	if (run(baseline, false, 10.0) != 1) { return -1; }
+	if (run(baseline, false, 1000.0) != 1) { return -1; }
+
+	// A regression is the benchmark's own failure, not that of a line in cunit.
+	if (regressions != 2 || placed != 0) { return -1; }
+
+	// Update mode records every benchmark instead of comparing.
+	if (run(baseline, true, 10.0) != 0) { return -1; }
+	if (run(baseline, false, 1000.0) != 0) { return -1; }
+
+	remove(baseline);
+	return 0;
+}
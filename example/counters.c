@@ -0,0 +1,61 @@
+#include "recorder.h"
+
+// The counters reported for the loop test of the last run, if any.
+static cunit_counters_t loop;
+static bool             measured;
+
+static void on_test_end(const cunit_test_report_t *test) {
+	if (strcmp(test->name, "Loop") != 0) { return; }
+	measured = test->counters != NULL;
+	if (test->counters) { loop = *test->counters; }
+}
+
+static void test_loop(void) {
+	volatile uint64_t sum = 0;
+	for (uint64_t i = 0; i < 1000000; i++) { sum += i; }
+	assert_uint64_eq(sum, 499999500000ull);
+}
+
+static void test_other(void) { assert_true(true); }
+
+// Runs the tests and checks the counters of the loop, if the system grants them.
+static bool run(bool counters) {
+	memset(&loop, 0, sizeof(loop));
+	measured          = false;
+	recorder_test_end = on_test_end;
+	cunit_set_counters(counters);
+	cunit_add_reporter(&recorder);
+	CUNIT_SUITE_BEGIN("Counters", NULL, NULL)
+	CUNIT_TEST("Loop", test_loop)
+	CUNIT_TEST("Other", test_other)
+	CUNIT_SUITE_END()
+
+	if (cunit_run() != 0) { return false; }
+	if (!counters) { return !measured; }
+	// Without permission to count, the tests run as if counters were disabled.
+	if (!measured) { return true; }
+	if (!loop.available) { return false; }
+	// The loop alone retires a few instructions per iteration.
+	if ((loop.available & CUNIT_COUNTER_INSTRUCTIONS) && loop.instructions < 1000000) { return false; }
+	return !(loop.available & CUNIT_COUNTER_CYCLES) || loop.cycles > 0;
+}
+
+int main(void) {
+	cunit_init();
+
+	// Counters are off by default.
+	if (!run(false)) { return -1; }
+	if (!run(true)) { return -1; }
+
+	// Each worker thread counts its own tests.
+	cunit_set_jobs(2);
+	if (!run(true)) { return -1; }
+
+#ifndef _WIN32
+	// A forked worker opens counters of its own.
+	cunit_set_jobs(2);
+	cunit_set_exec_mode(CUNIT_EXEC_MODE_FORK);
+	if (!run(true)) { return -1; }
+#endif
+	return 0;
+}
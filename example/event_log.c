@@ -0,0 +1,78 @@
+#include <string.h>
+
+#include "cunit.h"
+
+// Counts the events replayed from a log.
+typedef struct {
+	int suites, tests, passed, failures, fatal, wrong;
+} counter_t;
+
+static void on_suite_begin(void *data, const char *suite) {
+	counter_t *c = (counter_t *)data;
+	if (!suite || strcmp(suite, "Log") != 0) { c->wrong++; }
+	c->suites++;
+}
+
+static void on_failure(void *data, const cunit_failure_t *failure) {
+	counter_t *c = (counter_t *)data;
+	if (!failure->ctx.file || !strstr(failure->ctx.file, "event_log.c") || failure->ctx.line <= 0) { c->wrong++; }
+	if (failure->fatal) {
+		c->fatal++;
+		return;
+	}
+	if (!failure->message || !failure->note) {
+		c->wrong++;
+	} else if (strcmp(failure->note, strcmp(failure->message, "1 < 2") == 0 ? "soft" : "hard") != 0) {
+		c->wrong++;
+	}
+	c->failures++;
+}
+
+static void on_test_end(void *data, const cunit_test_report_t *test) {
+	counter_t *c = (counter_t *)data;
+	if (!test->suite || !test->name || test->timing->total.wall < 0.0) { c->wrong++; }
+	if (test->status == CUNIT_STATUS_PASSED) { c->passed++; }
+	c->tests++;
+}
+
+// Replays `path` and checks what arrives.
+static bool replay(const char *path) {
+	counter_t              counter;
+	const cunit_reporter_t reporter = {&counter, NULL, on_suite_begin, NULL, on_failure, on_test_end, NULL, NULL, NULL};
+	memset(&counter, 0, sizeof(counter));
+	if (!cunit_log_replay(path, &reporter)) { return false; }
+	return counter.suites == 1 && counter.tests == 3 && counter.passed == 2 && counter.failures == 2 && counter.fatal == 1 && counter.wrong == 0;
+}
+
+static void test_pass(void) { assert_true(true); }
+static void test_check(void) { check_int_eq(1, 2, "soft"); }
+static void test_fail(void) { assert_int_eq(3, 4, "hard"); }
+
+int main(void) {
+	const char *log = "event_log.bin";
+
+	cunit_init();
+	cunit_set_jobs(2);
+	cunit_set_reporter(cunit_log_reporter(log));
+	CUNIT_SUITE_BEGIN("Log", NULL, NULL)
+	CUNIT_TEST("Pass", test_pass)
+	CUNIT_TEST("Check", test_check)
+	CUNIT_TEST("Fail", test_fail)
+	CUNIT_SUITE_END()
+	if (cunit_run_suite("Log") != 1) { return -1; }
+
+	// The log is readable while the run is still going, as it would be after a crash.
+	if (!replay(log)) { return -1; }
+	cunit_cleanup();
+	if (!replay(log)) { return -1; }
+
+	// Anything else is rejected.
+	FILE *file = fopen(log, "wb");
+	if (!file) { return -1; }
+	fputs("not a log\n", file);
+	fclose(file);
+	if (cunit_log_replay(log, cunit_console_reporter())) { return -1; }
+
+	remove(log);
+	return 0;
+}
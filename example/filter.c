@@ -0,0 +1,98 @@
+#include "cunit.h"
+
+static unsigned ran;
+
+#define DEFINE_TEST(name, bit) \
+	static void test_##name(void) { ran |= 1u << (bit); }
+DEFINE_TEST(connect, 0)
+DEFINE_TEST(send, 1)
+DEFINE_TEST(slow_send, 2)
+DEFINE_TEST(ping, 3)
+DEFINE_TEST(read, 4)
+DEFINE_TEST(slow_write, 5)
+
+static void register_tests(void) {
+	CUNIT_SUITE_BEGIN("Net", NULL, NULL)
+	CUNIT_TEST("Connect", test_connect)
+	CUNIT_TEST("Send", test_send)
+	CUNIT_TEST_TAGGED("SlowSend", test_slow_send, "slow,io")
+	CUNIT_SUITE_END()
+	CUNIT_SUITE_BEGIN("NetExtra", NULL, NULL)
+	CUNIT_TEST_TAGGED("Ping", test_ping, "fast")
+	CUNIT_SUITE_END()
+	CUNIT_SUITE_BEGIN("Disk", NULL, NULL)
+	CUNIT_TEST_TAGGED("Read", test_read, "io")
+	CUNIT_TEST_TAGGED("SlowWrite", test_slow_write, "slow disk")
+	CUNIT_SUITE_END()
+}
+
+// Runs the tests selected by `filter` on one shard and returns which of them ran.
+static unsigned run(const char *filter, int index, int count) {
+	ran = 0;
+	cunit_init();
+	cunit_set_filter(filter);
+	cunit_set_shard(index, count);
+	register_tests();
+	if (cunit_suite_count() != 3 || cunit_run() != 0) { return ~0u; }
+	return ran;
+}
+
+int main(void) {
+	if (run(NULL, 0, 1) != 0x3f) { return -1; }
+	if (run("", 0, 1) != 0x3f) { return -1; }
+
+	// A pattern without a slash selects whole suites.
+	if (run("Net", 0, 1) != 0x07) { return -1; }
+	if (run("Net*:-*/Slow*", 0, 1) != 0x0b) { return -1; }
+	if (run("*/?ead:NetExtra/P*", 0, 1) != 0x18) { return -1; }
+	if (run("-Net*", 0, 1) != 0x30) { return -1; }
+	if (run("Nothing", 0, 1) != 0) { return -1; }
+
+	// Tags.
+	if (run("@io", 0, 1) != 0x14) { return -1; }
+	if (run("@slow:-Disk", 0, 1) != 0x04) { return -1; }
+	if (run("@f*:Disk/Read", 0, 1) != 0x18) { return -1; }
+
+	// Names without wildcards are looked up; negative patterns still apply to what they name.
+	if (run("Net/Send", 0, 1) != 0x02) { return -1; }
+	if (run("Net/Send:Disk:-Disk/Read", 0, 1) != 0x22) { return -1; }
+	if (run("NetExtra:-@fast", 0, 1) != 0) { return -1; }
+	if (run("Net/Nope:Nope", 0, 1) != 0) { return -1; }
+
+#ifndef _WIN32
+	// Regular expressions match "Suite/Test".
+	if (run("~^Disk/.*Write$", 0, 1) != 0x20) { return -1; }
+	if (run("~Send$:-@slow", 0, 1) != 0x02) { return -1; }
+#endif
+
+	// Only the selected tests are dealt to the shards.
+	const unsigned first = run("Net*", 0, 2), second = run("Net*", 1, 2);
+	if ((first & second) != 0 || (first | second) != 0x0f || first != 0x05) { return -1; }
+
+	// Suites are looked up by name, and the filter still applies.
+	ran = 0;
+	cunit_init();
+	cunit_set_filter("@io");
+	register_tests();
+	if (cunit_run_suite("Nope") != -1) { return -1; }
+	if (cunit_run_suite("Disk") != 0 || ran != 0x10) { return -1; }
+
+	cunit_timing_t timing;
+	if (!cunit_test_timing("Disk", "Read", &timing) || cunit_test_timing("Disk", "SlowWrite", &timing)) { return -1; }
+	cunit_cleanup();
+
+	// A name selects every suite and test registered under it.
+	ran = 0;
+	cunit_init();
+	cunit_set_filter("Twice/Again");
+	CUNIT_SUITE_BEGIN("Twice", NULL, NULL)
+	CUNIT_TEST("Again", test_connect)
+	CUNIT_TEST("Other", test_ping)
+	CUNIT_TEST("Again", test_send)
+	CUNIT_SUITE_END()
+	CUNIT_SUITE_BEGIN("Twice", NULL, NULL)
+	CUNIT_TEST("Again", test_read)
+	CUNIT_SUITE_END()
+	if (cunit_run() != 0 || ran != 0x13) { return -1; }
+	return 0;
+}
@@ -0,0 +1,229 @@
+#include "recorder.h"
+
+// Two large arrays of floats a few ulps apart, for the benchmark.
+#define LARGE ((size_t)16 << 20)
+static float *large_l, *large_r;
+
+// Reads the number of mismatches the last failure reported, and the index of the first, or 0.
+static void mismatches(unsigned long long *count, unsigned long long *first) {
+	const char *at = strstr(recorded.message, "first at index ");
+	*count = *first = 0;
+	sscanf(recorded.message, "%llu of", count);
+	if (at) { sscanf(at, "first at index %llu", first); }
+}
+
+// Counts the pairs that are not within a tolerance, one at a time and independently of cunit:
+// ulps are counted on the bits offset from the middle of the unsigned range.
+static uint32_t key_f(float f) {
+	uint32_t bits;
+	memcpy(&bits, &f, sizeof(bits));
+	return bits & 0x80000000u ? 0x80000000u - (bits & 0x7FFFFFFFu) : 0x80000000u + bits;
+}
+static size_t reference_f(const float *l, const float *r, size_t count, cunit_tolerance_t tolerance) {
+	size_t far = 0;
+	for (size_t i = 0; i < count; i++) {
+		if (isnan(l[i]) || isnan(r[i])) {
+			far += !(isnan(l[i]) && isnan(r[i]));
+		} else if (l[i] != r[i]) {
+			const uint32_t a = key_f(l[i]), b = key_f(r[i]);
+			const float    diff = fabsf(l[i] - r[i]);
+			switch (tolerance.kind) {
+				case CUNIT_TOLERANCE_ULPS: far += (a > b ? a - b : b - a) > tolerance.value; break;
+				case CUNIT_TOLERANCE_REL: far += !(isfinite(diff) && diff <= (float)tolerance.value * fmaxf(fabsf(l[i]), fabsf(r[i]))); break;
+				default: far += !(diff <= (float)tolerance.value); break;
+			}
+		}
+	}
+	return far;
+}
+
+static uint64_t key_d(double f) {
+	uint64_t bits;
+	memcpy(&bits, &f, sizeof(bits));
+	return bits >> 63 ? (1ull << 63) - (bits & ~(1ull << 63)) : (1ull << 63) + bits;
+}
+static size_t reference_d(const double *l, const double *r, size_t count, cunit_tolerance_t tolerance) {
+	size_t far = 0;
+	for (size_t i = 0; i < count; i++) {
+		if (isnan(l[i]) || isnan(r[i])) {
+			far += !(isnan(l[i]) && isnan(r[i]));
+		} else if (l[i] != r[i]) {
+			const uint64_t a = key_d(l[i]), b = key_d(r[i]);
+			const double   diff = fabs(l[i] - r[i]);
+			switch (tolerance.kind) {
+				case CUNIT_TOLERANCE_ULPS: far += (a > b ? a - b : b - a) > (uint64_t)tolerance.value; break;
+				case CUNIT_TOLERANCE_REL: far += !(isfinite(diff) && diff <= tolerance.value * fmax(fabs(l[i]), fabs(r[i]))); break;
+				default: far += !(diff <= tolerance.value); break;
+			}
+		}
+	}
+	return far;
+}
+
+static void test_equal(void) {
+	const float  f[] = {0.0f, -0.0f, 1.5f, -2.25f, INFINITY, -INFINITY, NAN, FLT_MAX, FLT_MIN};
+	const float  g[] = {-0.0f, 0.0f, 1.5f, -2.25f, INFINITY, -INFINITY, NAN, FLT_MAX, FLT_MIN};
+	const double d[] = {0.0, -0.0, 1.5, -2.25, INFINITY, -INFINITY, NAN, DBL_MAX, DBL_MIN};
+	const double e[] = {-0.0, 0.0, 1.5, -2.25, INFINITY, -INFINITY, NAN, DBL_MAX, DBL_MIN};
+
+	assert_float_array_near(f, g, 9, cunit_ulps(0));
+	assert_float_array_near(f, g, 9, cunit_rel(0));
+	assert_float_array_near(f, g, 9, cunit_abs(0));
+	assert_double_array_near(d, e, 9, cunit_ulps(0));
+	assert_double_array_near(d, e, 9, cunit_rel(0));
+	assert_double_array_near(d, e, 9, cunit_abs(0));
+	assert_float_array_near((const float *)NULL, (const float *)NULL, 3, cunit_ulps(0));
+}
+
+static void test_tolerances(void) {
+	const float  one[]  = {1.0f};
+	const float  next[] = {nextafterf(nextafterf(1.0f, 2.0f), 2.0f)};
+	const float  tiny[] = {nextafterf(0.0f, -1.0f)}, other_tiny[] = {nextafterf(0.0f, 1.0f)};
+	const float  max[] = {FLT_MAX}, inf[] = {INFINITY}, nan[] = {NAN};
+	const double big[] = {1e6}, bigger[] = {1e6 + 1}, small[] = {1e-9}, smaller[] = {2e-9};
+
+	assert_true(check_float_array_near(one, next, 1, cunit_ulps(2)));
+	assert_false(check_float_array_near(one, next, 1, cunit_ulps(1)));
+	assert_true(check_float_array_near(tiny, other_tiny, 1, cunit_ulps(2)));  // -0 and +0 are one number
+	assert_false(check_float_array_near(tiny, other_tiny, 1, cunit_ulps(1)));
+	assert_true(check_float_array_near(max, inf, 1, cunit_ulps(1)));
+	assert_false(check_float_array_near(one, nan, 1, cunit_ulps(UINT64_MAX)));
+	assert_false(check_float_array_near(nan, one, 1, cunit_abs(INFINITY)));
+
+	assert_true(check_double_array_near(big, bigger, 1, cunit_rel(1e-6)));
+	assert_false(check_double_array_near(big, bigger, 1, cunit_abs(0.5)));
+	assert_true(check_double_array_near(small, smaller, 1, cunit_abs(1e-8)));
+	assert_false(check_double_array_near(small, smaller, 1, cunit_rel(0.1)));
+	assert_false(check_float_array_near(one, inf, 1, cunit_rel(10)));
+}
+
+static void test_message(void) {
+	float l[20], r[20];
+	for (int i = 0; i < 20; i++) { l[i] = r[i] = 1.0f; }
+	r[3]  = 1.5f;
+	r[12] = 3.0f;
+	assert_false(check_float_array_near(l, r, 20, cunit_abs(0.25)));
+	assert_str_eq(recorded.message, "2 of 20 elements differ by more than 0.25; first at index 3, worst at index 12: 1 != 3 (2)");
+
+	const double a[] = {1.0, 2.0, NAN, 4.0}, b[] = {1.0, 2.0, 3.0, 4.0000000000000018};
+	assert_false(check_double_array_near(a, b, 4, cunit_ulps(1)));
+	assert_str_eq(recorded.message, "2 of 4 elements differ by more than 1 ulps; first at index 2, worst at index 2: nan != 3 (inf ulps)");
+	assert_false(check_double_array_near(b, b + 1, 3, cunit_rel(0.1)));
+	assert_str_eq(recorded.message, "3 of 3 elements differ by more than 0.1 relative; first at index 0, worst at index 0: 1 != 2 (0.5 relative)");
+
+	assert_false(check_float_array_near(l, (const float *)NULL, 20, cunit_ulps(4)));
+	assert_str_eq(recorded.message, "array != (null)");
+}
+
+// Every size and position, so that each vector block and tail is crossed.
+static void test_positions(void) {
+	float              f[100], g[100];
+	double             d[100], e[100];
+	unsigned long long count, first;
+	for (int i = 0; i < 100; i++) {
+		f[i] = g[i] = (float)i * 0.37f - 11.0f;
+		d[i] = e[i] = (double)i * 0.37 - 11.0;
+	}
+	for (size_t size = 0; size <= 100; size++) {
+		for (size_t at = 0; at < size; at++) {
+			g[at] = nextafterf(nextafterf(nextafterf(f[at], INFINITY), INFINITY), INFINITY);
+			e[at] = nextafter(nextafter(nextafter(d[at], -INFINITY), -INFINITY), -INFINITY);
+			assert_true(check_float_array_near(f, g, size, cunit_ulps(3)));
+			assert_true(check_double_array_near(d, e, size, cunit_ulps(3)));
+			assert_false(check_float_array_near(f, g, size, cunit_ulps(2)));
+			mismatches(&count, &first);
+			assert_true(count == 1 && first == at);
+			assert_false(check_double_array_near(d, e, size, cunit_ulps(2)));
+			mismatches(&count, &first);
+			assert_true(count == 1 && first == at);
+			g[at] = f[at];
+			e[at] = d[at];
+		}
+	}
+}
+
+// Random arrays full of zeros, infinities, NaNs and nearby numbers, counted as the reference counts them.
+static uint64_t state = 0x9E3779B97F4A7C15ull;
+
+static uint32_t next_random(void) {
+	state = state * 6364136223846793005ull + 1442695040888963407ull;
+	return (uint32_t)(state >> 33);
+}
+
+static double random_value(double near) {
+	switch (next_random() % 10) {
+		case 0: return 0.0;
+		case 1: return -0.0;
+		case 2: return INFINITY;
+		case 3: return -INFINITY;
+		case 4: return NAN;
+		case 5: return -near;
+		case 6: return near * (1 + (double)(next_random() % 8) * 1e-7);
+		case 7: return (double)next_random() * 1e-40;
+		default: return near;
+	}
+}
+
+static void test_random(void) {
+	float              f[67], g[67];
+	double             d[67], e[67];
+	unsigned long long found, first;
+	for (int trial = 0; trial < 2000; trial++) {
+		for (int i = 0; i < 67; i++) {
+			const double near = (double)(next_random() % 1000) - 500;
+			f[i]              = (float)random_value(near);
+			g[i]              = (float)random_value(near);
+			d[i]              = random_value(near);
+			e[i]              = random_value(near);
+		}
+		const size_t            count     = next_random() % 68;
+		const cunit_tolerance_t tolerance = trial % 3 == 0 ? cunit_ulps(next_random() % 16) : trial % 3 == 1 ? cunit_rel(1e-6) : cunit_abs(1e-4);
+
+		const size_t far_f = reference_f(f, g, count, tolerance);
+		recorded.message[0] = '\0';
+		assert_true(check_float_array_near(f, g, count, tolerance) == (far_f == 0));
+		mismatches(&found, &first);
+		assert_uint64_eq(found, far_f);
+
+		const size_t far_d = reference_d(d, e, count, tolerance);
+		recorded.message[0] = '\0';
+		assert_true(check_double_array_near(d, e, count, tolerance) == (far_d == 0));
+		mismatches(&found, &first);
+		assert_uint64_eq(found, far_d);
+	}
+}
+
+static void bench_float_array_near(void) {
+	const bool near = check_float_array_near(large_l, large_r, LARGE, cunit_ulps(4));
+	cunit_do_not_optimize(near);
+}
+
+int main(void) {
+	cunit_init();
+	cunit_set_reporter(&recorder);
+	cunit_set_bench_time(0.02);
+	cunit_set_bench_repetitions(3);
+	large_l = (float *)malloc(LARGE * sizeof(float));
+	large_r = (float *)malloc(LARGE * sizeof(float));
+	if (!large_l || !large_r) { return -1; }
+	for (size_t i = 0; i < LARGE; i++) {
+		large_l[i] = (float)i * 0.25f;
+		large_r[i] = nextafterf(large_l[i], INFINITY);
+	}
+
+	CUNIT_SUITE_BEGIN("Float arrays", NULL, NULL)
+	CUNIT_TEST("Equal", test_equal)
+	CUNIT_TEST("Tolerances", test_tolerances)
+	CUNIT_TEST("Message", test_message)
+	CUNIT_TEST("Positions", test_positions)
+	CUNIT_TEST("Random", test_random)
+	CUNIT_BENCH("16M floats", bench_float_array_near)
+	CUNIT_SUITE_END()
+
+	const int result = cunit_run();
+	free(large_l);
+	free(large_r);
+	if (result != 0 || recorded.failed != 0 || recorded.median <= 0) { return -1; }
+	printf("assert_float_array_near: %.1f GB/s on 2 x 64 MB\n", (double)(2 * LARGE * sizeof(float)) / recorded.median);
+	return 0;
+}
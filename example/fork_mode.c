@@ -0,0 +1,97 @@
+#ifdef __linux__
+#define _GNU_SOURCE
+#endif
+#include <signal.h>
+
+#include "recorder.h"
+
+#ifdef __linux__
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+void test_pass(void) { assert_true(true); }
+
+void test_fail(void) { assert_int_eq(1, 2); }
+
+void test_crash(void) { raise(SIGSEGV); }
+
+void test_exit(void) { exit(3); }
+
+#ifndef _WIN32
+// In FAIL_FAST mode the run stops at the first failure, and the tests that finished are reported.
+static bool run_fail_fast(void) {
+	memset(&recorded, 0, sizeof(recorded));
+	cunit_set_exec_mode(CUNIT_EXEC_MODE_FORK);
+	cunit_set_jobs(1);
+	cunit_set_error_mode(CUNIT_ERROR_MODE_FAIL_FAST);
+	cunit_set_reporter(&recorder);
+
+	CUNIT_SUITE_BEGIN("Fail Fast", NULL, NULL)
+	CUNIT_TEST("Pass", test_pass)
+	CUNIT_TEST("Fail", test_fail)
+	CUNIT_TEST("Pass", test_pass)
+	CUNIT_TEST("Pass", test_pass)
+	CUNIT_SUITE_END()
+
+	return cunit_run() == 1 && recorded.total == 2 && recorded.passed == 1 && recorded.failed == 1 && recorded.failures == 2;
+}
+#endif
+
+#ifdef __linux__
+// The file descriptor limit of the parent, taken from it so that it cannot start another worker.
+static struct rlimit limit;
+
+// Leaves the parent no file descriptors for the pipes of a new worker, and crashes this one.
+void test_starve(void) {
+	const struct rlimit none = {0, limit.rlim_max};
+	prlimit(getppid(), RLIMIT_NOFILE, &none, NULL);
+	raise(SIGSEGV);
+}
+
+// Runs in the parent, which gets its file descriptors back.
+void test_restore(void) { assert_int_eq(setrlimit(RLIMIT_NOFILE, &limit), 0); }
+
+// The tests left once no worker can be started run in-process, and are counted and reported once.
+static bool run_unisolated(void) {
+	memset(&recorded, 0, sizeof(recorded));
+	getrlimit(RLIMIT_NOFILE, &limit);
+	cunit_set_exec_mode(CUNIT_EXEC_MODE_FORK);
+	cunit_set_jobs(1);
+	cunit_set_reporter(&recorder);
+
+	CUNIT_SUITE_BEGIN("Unisolated", NULL, NULL)
+	CUNIT_TEST("Starve", test_starve)
+	CUNIT_TEST("Restore", test_restore)
+	CUNIT_TEST("Fail", test_fail)
+	CUNIT_TEST("Pass", test_pass)
+	CUNIT_SUITE_END()
+
+	// The failure of the test left to run in-process is reported after the run began, in order.
+	return cunit_run() == 2 && recorded.unisolated == 3 && recorded.passed == 2 && recorded.failed == 2 && recorded.failures == 2 && !recorded.early;
+}
+#endif
+
+int main(void) {
+	cunit_init();
+	cunit_set_exec_mode(CUNIT_EXEC_MODE_FORK);
+	cunit_set_jobs(2);
+
+	CUNIT_SUITE_BEGIN("Fork Tests", NULL, NULL)
+	CUNIT_TEST("Pass", test_pass)
+	CUNIT_TEST("Crash", test_crash)
+	CUNIT_TEST("Pass", test_pass)
+	CUNIT_TEST("Fail", test_fail)
+	CUNIT_TEST("Exit", test_exit)
+	CUNIT_TEST("Pass", test_pass)
+	CUNIT_SUITE_END()
+
+	if (cunit_run() != 3) { return -1; }
+#ifndef _WIN32
+	if (!run_fail_fast()) { return -1; }
+#endif
+#ifdef __linux__
+	if (!run_unisolated()) { return -1; }
+#endif
+	return 0;
+}
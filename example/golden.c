@@ -0,0 +1,152 @@
+#include "recorder.h"
+
+#ifdef __linux__
+#include <sys/resource.h>
+#endif
+
+// Two large equal files, for the benchmark.
+#define LARGE ((size_t)128 << 20)
+static const char *large_l = "golden_large_l.bin", *large_r = "golden_large_r.bin";
+
+static bool write_file(const char *path, const void *data, size_t size) {
+	FILE *file = fopen(path, "wb");
+	if (!file) { return false; }
+	const bool ok = fwrite(data, 1, size, file) == size;
+	return fclose(file) == 0 && ok;
+}
+
+static void test_golden(void) {
+	const char *path = "golden_output.txt";
+	const char  text[] = "id,name\n1,alice\n2,bob\n";
+	remove(path);
+
+	assert_false(check_matches_golden(text, sizeof(text) - 1, path));
+	assert_str_eq(recorded.message, "cannot read golden file `golden_output.txt`; set CUNIT_UPDATE_GOLDEN=1 to create it");
+
+	// Update mode writes the golden file, and leaves no temporary file behind.
+	cunit_set_update_golden(true);
+	assert_matches_golden(text, sizeof(text) - 1, path);
+	cunit_set_update_golden(false);
+	assert_null(fopen("golden_output.txt.tmp", "rb"));
+	assert_matches_golden(text, sizeof(text) - 1, path);
+
+	const char changed[] = "id,name\n1,alice\n2,carol\n";
+	assert_false(check_matches_golden(changed, sizeof(changed) - 1, path));
+	assert_str_eq(recorded.message,
+				  "golden file `golden_output.txt` and data differ at offset 18 (22 != 24 bytes):\n"
+				  "  00000000  69 64 2C 6E 61 6D 65 0A  31 2C 61 6C 69 63 65 0A  |id,name.1,alice.|\n"
+				  "- 00000010  32 2C 62 6F 62 0A                                 |2,bob.|\n"
+				  "+ 00000010  32 2C 63 61 72 6F                                 |2,caro|\n"
+				  "                  ^^ ^^ ^^ ^^");
+	cunit_set_update_golden(true);
+	assert_matches_golden(changed, sizeof(changed) - 1, path);
+	cunit_set_update_golden(false);
+	assert_matches_golden(changed, sizeof(changed) - 1, path);
+	assert_false(check_matches_golden(changed, 10, path));
+	assert_str_eq(recorded.message, "golden file `golden_output.txt` and data differ at offset 10 (24 != 10 bytes)");
+
+	// An empty golden file matches no data.
+	cunit_set_update_golden(true);
+	assert_matches_golden((const char *)NULL, 0, path);
+	cunit_set_update_golden(false);
+	assert_matches_golden("", 0, path);
+	assert_false(check_matches_golden((const char *)NULL, 4, path));
+	assert_str_eq(recorded.message, "data is (null)");
+	remove(path);
+}
+
+static void test_file_eq(void) {
+	uint8_t l[100], r[100];
+	for (int i = 0; i < 100; i++) { l[i] = r[i] = (uint8_t)i; }
+	r[40] = 0xFF;
+	assert_true(write_file("golden_l.bin", l, 100));
+	assert_true(write_file("golden_r.bin", r, 100));
+	assert_true(write_file("golden_short.bin", l, 50));
+
+	assert_file_eq("golden_l.bin", "golden_l.bin");
+	assert_false(check_file_eq("golden_l.bin", "golden_r.bin"));
+	assert_not_null(strstr(recorded.message, "files `golden_l.bin` and `golden_r.bin` differ at offset 40 of 100:\n"));
+	assert_not_null(strstr(recorded.message, "\n- 00000020  20 21 22 23 24 25 26 27  28 29 2A 2B 2C 2D 2E 2F  | !\"#$%&'()*+,-./|\n"));
+	assert_not_null(strstr(recorded.message, "\n+ 00000020  20 21 22 23 24 25 26 27  FF 29 2A 2B 2C 2D 2E 2F  | !\"#$%&'.)*+,-./|\n"));
+	assert_false(check_file_eq("golden_short.bin", "golden_l.bin"));
+	assert_str_eq(recorded.message, "files `golden_short.bin` and `golden_l.bin` differ at offset 50 (50 != 100 bytes)");
+	assert_false(check_file_eq("golden_l.bin", "golden_missing.bin"));
+	assert_str_eq(recorded.message, "cannot read file `golden_missing.bin`");
+
+	remove("golden_l.bin");
+	remove("golden_r.bin");
+	remove("golden_short.bin");
+}
+
+// Every position of a difference around the chunks the files are compared in.
+static void test_large(void) {
+	const size_t offsets[] = {0, ((size_t)16 << 20) - 1, (size_t)16 << 20, LARGE - 1};
+	uint8_t      byte      = 0;
+	FILE        *file      = fopen(large_r, "r+b");
+	assert_not_null(file);
+	for (size_t i = 0; i < sizeof(offsets) / sizeof(offsets[0]); i++) {
+		fseek(file, (long)offsets[i], SEEK_SET);
+		assert_true(fread(&byte, 1, 1, file) == 1);
+		fseek(file, (long)offsets[i], SEEK_SET);
+		byte ^= 0x5A;
+		fwrite(&byte, 1, 1, file);
+		fflush(file);
+		assert_false(check_file_eq(large_l, large_r));
+		char expected[64];
+		snprintf(expected, sizeof(expected), " differ at offset %llu of %llu:", (unsigned long long)offsets[i], (unsigned long long)LARGE);
+		assert_not_null(strstr(recorded.message, expected));
+		fseek(file, (long)offsets[i], SEEK_SET);
+		byte ^= 0x5A;
+		fwrite(&byte, 1, 1, file);
+		fflush(file);
+	}
+	fclose(file);
+
+#ifdef __linux__
+	// Comparing holds a chunk of each file in memory at a time, not the files.
+	struct rusage before, after;
+	getrusage(RUSAGE_SELF, &before);
+	assert_file_eq(large_l, large_r);
+	getrusage(RUSAGE_SELF, &after);
+	assert_true((after.ru_maxrss - before.ru_maxrss) * 1024 < (long)(LARGE / 2));
+#endif
+}
+
+static void bench_file_eq(void) {
+	const bool equal = check_file_eq(large_l, large_r);
+	cunit_do_not_optimize(equal);
+}
+
+int main(void) {
+	cunit_init();
+	cunit_set_reporter(&recorder);
+	cunit_set_bench_time(0.02);
+	cunit_set_bench_repetitions(3);
+
+	uint8_t *block = (uint8_t *)malloc((size_t)1 << 20);
+	if (!block) { return -1; }
+	FILE *l = fopen(large_l, "wb"), *r = fopen(large_r, "wb");
+	if (!l || !r) { return -1; }
+	for (size_t at = 0; at < LARGE; at += (size_t)1 << 20) {
+		for (size_t i = 0; i < ((size_t)1 << 20); i++) { block[i] = (uint8_t)((at + i) * 31 >> 3); }
+		fwrite(block, 1, (size_t)1 << 20, l);
+		fwrite(block, 1, (size_t)1 << 20, r);
+	}
+	fclose(l);
+	fclose(r);
+	free(block);
+
+	CUNIT_SUITE_BEGIN("Golden files", NULL, NULL)
+	CUNIT_TEST("Golden", test_golden)
+	CUNIT_TEST("File eq", test_file_eq)
+	CUNIT_TEST("Large", test_large)
+	CUNIT_BENCH("2 x 128 MB files", bench_file_eq)
+	CUNIT_SUITE_END()
+
+	const int result = cunit_run();
+	remove(large_l);
+	remove(large_r);
+	if (result != 0 || recorded.failed != 0 || recorded.median <= 0) { return -1; }
+	printf("assert_file_eq: %.1f GB/s on 2 x 128 MB\n", (double)(2 * LARGE) / recorded.median);
+	return 0;
+}
@@ -0,0 +1,120 @@
+#include "recorder.h"
+
+// Two large equal buffers, for the benchmark.
+#define LARGE ((size_t)64 << 20)
+static uint8_t *large_l, *large_r;
+
+// Counts the lines of the last recorded.message.
+static int lines(void) {
+	int n = 1;
+	for (const char *p = recorded.message; *p; p++) { n += *p == '\n'; }
+	return n;
+}
+
+static void test_message(void) {
+	uint8_t l[40], r[40];
+	for (int i = 0; i < 40; i++) { l[i] = r[i] = (uint8_t)('A' + i); }
+	r[18] = 0x00;
+	r[21] = 0xFF;
+
+	assert_str_hex(l, l, 40);
+	assert_false(check_str_hex(l, r, 40));
+	assert_str_eq(recorded.message,
+				  "memory differs at offset 18 of 40:\n"
+				  "  00000000  41 42 43 44 45 46 47 48  49 4A 4B 4C 4D 4E 4F 50  |ABCDEFGHIJKLMNOP|\n"
+				  "- 00000010  51 52 53 54 55 56 57 58  59 5A 5B 5C 5D 5E 5F 60  |QRSTUVWXYZ[\\]^_`|\n"
+				  "+ 00000010  51 52 00 54 55 FF 57 58  59 5A 5B 5C 5D 5E 5F 60  |QR.TU.WXYZ[\\]^_`|\n"
+				  "                  ^^       ^^\n"
+				  "  00000020  61 62 63 64 65 66 67 68                           |abcdefgh|");
+
+	assert_false(check_str_hex(l, (const uint8_t *)NULL, 40));
+	assert_str_eq(recorded.message, "memory != (null)");
+}
+
+static void test_context(void) {
+	uint8_t l[256], r[256];
+	for (int i = 0; i < 256; i++) { l[i] = r[i] = (uint8_t)i; }
+	r[0x10] ^= 1;
+	r[0x90] ^= 1;
+	r[0xF0] ^= 1;
+
+	// With 2 rows of context, the first two differences are apart and the third is left out.
+	assert_false(check_str_hex(l, r, 256));
+	assert_not_null(strstr(recorded.message, "\n  00000000 "));
+	assert_not_null(strstr(recorded.message, "\n  00000030 "));
+	assert_null(strstr(recorded.message, "\n  00000040 "));
+	assert_not_null(strstr(recorded.message, "\n  ... more differences from offset 144"));
+	assert_int_eq(lines(), 1 + 3 + 3 + 1);
+
+	cunit_set_hex_context(0);
+	cunit_set_hex_ranges(0);
+	assert_false(check_str_hex(l, r, 256));
+	assert_null(strstr(recorded.message, "more differences"));
+	assert_not_null(strstr(recorded.message, "\n- 00000090 "));
+	assert_not_null(strstr(recorded.message, "\n+ 000000F0 "));
+	assert_int_eq(lines(), 1 + 3 + 1 + 3 + 1 + 3);
+
+	// Differences whose context would touch are one range.
+	cunit_set_hex_context(4);
+	assert_false(check_str_hex(l, r, 256));
+	assert_null(strstr(recorded.message, "\n  ..."));
+	assert_int_eq(lines(), 1 + 16 + 3 * 2);
+
+	cunit_set_hex_context(2);
+	cunit_set_hex_ranges(1);
+}
+
+// A large buffer that differs at many places shows a bounded recorded.message.
+static void test_large(void) {
+	for (size_t i = 0; i < 4096; i++) { large_r[i] ^= 1; }
+	large_r[LARGE - 1] ^= 1;
+	assert_false(check_str_hex(large_l, large_r, LARGE));
+	assert_int_eq(lines(), 1 + 3 * 64 + 1);
+	assert_true(strlen(recorded.message) < 20000);
+	assert_not_null(strstr(recorded.message, "\n+ 000003F0 "));
+	assert_not_null(strstr(recorded.message, "\n  ... more differences from offset 1024"));
+
+	for (size_t i = 16; i < 4096; i++) { large_r[i] ^= 1; }
+	cunit_set_hex_ranges(0);
+	assert_false(check_str_hex(large_l, large_r, LARGE));
+	assert_int_eq(lines(), 1 + 3 + 2 + 1 + 2 + 3);
+	assert_not_null(strstr(recorded.message, "\n+ 03FFFFF0 "));
+	cunit_set_hex_ranges(1);
+
+	large_r[0] ^= 1;
+	large_r[LARGE - 1] ^= 1;
+}
+
+static void bench_str_hex(void) {
+	const bool equal = check_str_hex(large_l, large_r, LARGE);
+	cunit_do_not_optimize(equal);
+}
+
+int main(void) {
+	cunit_init();
+	cunit_set_reporter(&recorder);
+	cunit_set_bench_time(0.02);
+	cunit_set_bench_repetitions(3);
+
+	large_l = (uint8_t *)malloc(LARGE);
+	large_r = (uint8_t *)malloc(LARGE);
+	if (!large_l || !large_r) { return -1; }
+	for (size_t i = 0; i < LARGE; i++) {
+		large_l[i] = (uint8_t)(i * 7);
+		large_r[i] = large_l[i];
+	}
+
+	CUNIT_SUITE_BEGIN("Hex diff", NULL, NULL)
+	CUNIT_TEST("Message", test_message)
+	CUNIT_TEST("Context", test_context)
+	CUNIT_TEST("Large", test_large)
+	CUNIT_BENCH("64 MB", bench_str_hex)
+	CUNIT_SUITE_END()
+
+	const int result = cunit_run();
+	free(large_l);
+	free(large_r);
+	if (result != 0 || recorded.failed != 0 || recorded.median <= 0) { return -1; }
+	printf("assert_str_hex: %.1f GB/s on 2 x 64 MB\n", (double)(2 * LARGE) / recorded.median);
+	return 0;
+}
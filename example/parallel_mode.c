@@ -0,0 +1,43 @@
+#include "cunit.h"
+
+static int fixture_depth = 0;
+static int fixture_max   = 0;
+
+static void setup(void) {
+	if (++fixture_depth > fixture_max) { fixture_max = fixture_depth; }
+}
+
+static void teardown(void) { --fixture_depth; }
+
+void test_pass(void) {
+	volatile unsigned sum = 0;
+	for (unsigned i = 0; i < 100000; i++) { sum += i; }
+	assert_true(sum > 0);
+}
+
+void test_fail(void) {
+	assert_int_eq(1, 2);
+	assert_true(false);
+}
+
+void test_fixture(void) { assert_int_eq(fixture_depth, 1); }
+
+int main(void) {
+	cunit_init();
+	cunit_set_jobs(4);
+
+	CUNIT_SUITE_BEGIN("Parallel Tests", NULL, NULL)
+	for (int i = 0; i < 64; i++) { CUNIT_TEST("Pass", test_pass) }
+	CUNIT_TEST("Fail", test_fail)
+	CUNIT_TEST("Fail", test_fail)
+	CUNIT_SUITE_END()
+
+	CUNIT_SUITE_BEGIN("Fixture Tests", setup, teardown)
+	for (int i = 0; i < 16; i++) { CUNIT_TEST("Fixture", test_fixture) }
+	CUNIT_SUITE_END()
+
+	const int failed_count = cunit_run();
+	if (failed_count != 2) { return -1; }
+	if (fixture_max != 1) { return -1; }
+	return 0;
+}
@@ -0,0 +1,70 @@
+#ifndef CUNIT_EXAMPLE_RECORDER_H
+#define CUNIT_EXAMPLE_RECORDER_H
+
+#include "cunit.h"
+
+// What a reporter saw of the last run, for the examples that check what cunit reports.
+typedef struct {
+	char     message[65536];  // The message of the last failure.
+	int      failures;        // The number of failures.
+	int      early;           // The number of failures reported before the run began.
+	bool     begun;           // Whether the run began.
+	double   median;          // The median of the last benchmark, in nanoseconds.
+	int      passed;          // The tests of the run that passed.
+	int      failed;          // The tests of the run that failed.
+	int      total;           // The tests of the run.
+	int      unisolated;      // The tests of the run that ran in-process in fork mode.
+	uint64_t assertions;      // The checks and assertions of the run.
+} recorded_t;
+
+static recorded_t recorded;
+
+// Called for each test and suite that ends, for what an example records of them.
+static void (*recorder_test_end)(const cunit_test_report_t *test)    = NULL;
+static void (*recorder_suite_end)(const cunit_suite_report_t *suite) = NULL;
+
+static void recorder_on_run_begin(void *data, int total) {
+	(void)data, (void)total;
+	recorded.begun = true;
+}
+
+static void recorder_on_failure(void *data, const cunit_failure_t *failure) {
+	(void)data;
+	recorded.failures++;
+	recorded.early += !recorded.begun;
+	snprintf(recorded.message, sizeof(recorded.message), "%s", failure->message ? failure->message : "");
+}
+
+static void recorder_on_test_end(void *data, const cunit_test_report_t *test) {
+	(void)data;
+	if (test->bench) { recorded.median = test->bench->median; }
+	if (recorder_test_end) { recorder_test_end(test); }
+}
+
+static void recorder_on_suite_end(void *data, const cunit_suite_report_t *suite) {
+	(void)data;
+	if (recorder_suite_end) { recorder_suite_end(suite); }
+}
+
+static void recorder_on_run_end(void *data, const cunit_run_report_t *run) {
+	(void)data;
+	recorded.passed     = run->passed;
+	recorded.failed     = run->failed;
+	recorded.total      = run->total;
+	recorded.unisolated = run->unisolated;
+	recorded.assertions = run->assertions;
+}
+
+static const cunit_reporter_t recorder = {
+	NULL,                   // data
+	recorder_on_run_begin,  // run_begin
+	NULL,                   // suite_begin
+	NULL,                   // test_begin
+	recorder_on_failure,    // failure
+	recorder_on_test_end,   // test_end
+	recorder_on_suite_end,  // suite_end
+	recorder_on_run_end,    // run_end
+	NULL,                   // flush
+};
+
+#endif  // CUNIT_EXAMPLE_RECORDER_H
@@ -0,0 +1,35 @@
+#include "cunit.h"
+
+#define SUITE_COUNT 100
+#define TEST_COUNT  100000
+
+static char names[TEST_COUNT][16];
+static char suites[SUITE_COUNT][16];
+static int  runs;
+
+static void test_count(void) { runs++; }
+
+// Registers TEST_COUNT generated tests, as table-driven code would, and runs them silently.
+static bool run(void) {
+	runs = 0;
+	cunit_init();
+	cunit_set_reporter(NULL);
+	for (int s = 0; s < SUITE_COUNT; s++) {
+		CUNIT_SUITE_BEGIN(suites[s], NULL, NULL)
+		for (int t = s; t < TEST_COUNT; t += SUITE_COUNT) { CUNIT_TEST(names[t], test_count) }
+		CUNIT_SUITE_END()
+	}
+	if (cunit_suite_count() != SUITE_COUNT) { return false; }
+	return cunit_run() == 0 && runs == TEST_COUNT;
+}
+
+int main(void) {
+	for (int s = 0; s < SUITE_COUNT; s++) { snprintf(suites[s], sizeof(suites[s]), "Suite %d", s); }
+	for (int t = 0; t < TEST_COUNT; t++) { snprintf(names[t], sizeof(names[t]), "Test %d", t); }
+
+	// The registry is released at the end of each run and built again from scratch.
+	for (int i = 0; i < 3; i++) {
+		if (!run()) { return -1; }
+	}
+	return 0;
+}
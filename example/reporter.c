@@ -0,0 +1,91 @@
+#include <string.h>
+
+#include "cunit.h"
+
+// Counts events and checks that they arrive in order.
+typedef struct {
+	int         runs, suites, tests, failures, fatal, ended, passed, out_of_order;
+	const char *current;
+} counter_t;
+
+static void on_run_begin(void *data, int total) {
+	counter_t *c = (counter_t *)data;
+	if (total != 4) { c->out_of_order++; }
+	c->runs++;
+}
+
+static void on_suite_begin(void *data, const char *suite) {
+	(void)suite;
+	((counter_t *)data)->suites++;
+}
+
+static void on_test_begin(void *data, const char *suite, const char *test) {
+	(void)suite;
+	counter_t *c = (counter_t *)data;
+	if (c->current) { c->out_of_order++; }
+	c->current = test;
+	c->tests++;
+}
+
+static void on_failure(void *data, const cunit_failure_t *failure) {
+	counter_t *c = (counter_t *)data;
+	if (!c->current || !failure->ctx.file || failure->ctx.line <= 0) { c->out_of_order++; }
+	if (failure->fatal) {
+		c->fatal++;
+	} else {
+		c->failures++;
+	}
+}
+
+static void on_test_end(void *data, const cunit_test_report_t *test) {
+	counter_t *c = (counter_t *)data;
+	if (!c->current || strcmp(c->current, test->name) != 0) { c->out_of_order++; }
+	if (test->status == CUNIT_STATUS_PASSED) { c->passed++; }
+	c->current = NULL;
+	c->ended++;
+}
+
+static void on_run_end(void *data, const cunit_run_report_t *run) {
+	counter_t *c = (counter_t *)data;
+	if (run->total != 4 || run->failed != 1) { c->out_of_order++; }
+	c->runs++;
+}
+
+static void test_pass(void) { assert_true(true); }
+static void test_check(void) {
+	check_true(false);
+	check_true(false, "second");
+}
+static void test_assert(void) { assert_true(false, "stop here"); }
+
+int main(void) {
+	static counter_t counter;
+	static const cunit_reporter_t reporter = {
+		&counter, on_run_begin, on_suite_begin, on_test_begin, on_failure, on_test_end, NULL, on_run_end, NULL,
+	};
+
+	cunit_init();
+	cunit_set_jobs(4);
+	cunit_add_reporter(&reporter);
+	CUNIT_SUITE_BEGIN("Reporter", NULL, NULL)
+	CUNIT_TEST("Pass", test_pass)
+	CUNIT_TEST("Check", test_check)
+	CUNIT_TEST("Assert", test_assert)
+	CUNIT_TEST("Pass Again", test_pass)
+	CUNIT_SUITE_END()
+
+	// Failures recorded on pool threads are delivered between their test's begin and end.
+	if (cunit_run() != 1) { return -1; }
+	if (counter.out_of_order != 0 || counter.runs != 2 || counter.suites != 1) { return -1; }
+	if (counter.tests != 4 || counter.ended != 4 || counter.passed != 3) { return -1; }
+	if (counter.failures != 3 || counter.fatal != 1) { return -1; }
+
+	// Without any reporter the run is silent but still counted.
+	cunit_init();
+	cunit_set_reporter(NULL);
+	CUNIT_SUITE_BEGIN("Silent", NULL, NULL)
+	CUNIT_TEST("Assert", test_assert)
+	CUNIT_SUITE_END()
+	if (cunit_run() != 1) { return -1; }
+	return 0;
+}
@@ -0,0 +1,63 @@
+#include "cunit.h"
+
+static char order[16];
+static bool broken;
+
+// Appends the letter of the running test to `order`.
+static void ran(char letter) {
+	const size_t length = strlen(order);
+	if (length + 1 < sizeof(order)) { order[length] = letter; }
+}
+
+static void test_one(void) { ran('1'); }
+static void test_two(void) { ran('2'); }
+static void test_good(void) { ran('g'); }
+static void test_flaky(void) {
+	ran('F');
+	assert_false(broken);
+}
+
+// Runs the tests and checks the number of failures and the order they ran in.
+static bool run(int expected_failures, const char *expected_order) {
+	memset(order, 0, sizeof(order));
+	CUNIT_SUITE_BEGIN("A", NULL, NULL)
+	CUNIT_TEST("One", test_one)
+	CUNIT_TEST("Two", test_two)
+	CUNIT_SUITE_END()
+	CUNIT_SUITE_BEGIN("B", NULL, NULL)
+	CUNIT_TEST("Good", test_good)
+	CUNIT_TEST("Flaky", test_flaky)
+	CUNIT_SUITE_END()
+	return cunit_run() == expected_failures && strcmp(order, expected_order) == 0;
+}
+
+int main(void) {
+	const char *failed_file = "rerun_failed.txt";
+	remove(failed_file);
+
+	// A normal run records the failure.
+	broken = true;
+	cunit_init();
+	cunit_set_failed_file(failed_file);
+	if (!run(1, "12gF")) { return -1; }
+
+	// Only the failed test runs; the options are taken out of argv.
+	char  arg0[] = "rerun", arg1[] = "--last-failed", arg2[] = "--failed-file=rerun_failed.txt", arg3[] = "--other";
+	char *argv[] = {arg0, arg1, arg2, arg3, NULL};
+	if (cunit_parse_args(4, argv) != 2 || argv[1] != arg3 || argv[2] != NULL) { return -1; }
+	if (!run(1, "F")) { return -1; }
+
+	// The failed test and its suite go first; once it passes it is dropped.
+	broken = false;
+	cunit_set_failed_file(failed_file);
+	cunit_set_rerun_mode(CUNIT_RERUN_FAILED_FIRST);
+	if (!run(0, "Fg12")) { return -1; }
+
+	// With nothing left to rerun, everything runs.
+	cunit_set_failed_file(failed_file);
+	cunit_set_rerun_mode(CUNIT_RERUN_LAST_FAILED);
+	if (!run(0, "12gF")) { return -1; }
+
+	remove(failed_file);
+	return 0;
+}
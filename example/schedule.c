@@ -0,0 +1,64 @@
+#include "cunit.h"
+
+#define ORDER_FILE "schedule_order.txt"
+
+// Appends the name of the running test to ORDER_FILE. Tests run in forked
+// workers, so this is how the parent learns the order in which they started.
+static void record(const char *name) {
+	FILE *file = fopen(ORDER_FILE, "a");
+	if (!file) { return; }
+	fputs(name, file);
+	fclose(file);
+}
+
+static void test_quick(void) { record("q"); }
+static void test_long(void) { record("L"); }
+static void test_new(void) { record("N"); }
+
+// Writes the history of a previous run, where "Long" took far longer than the rest.
+static bool write_timings(const char *timing_file) {
+	FILE *file = fopen(timing_file, "w");
+	if (!file) { return false; }
+	fprintf(file, "Schedule\tQuick\t0.001\nSchedule\tLong\t1\n");
+	return fclose(file) == 0;
+}
+
+// Runs four quick tests, then "Long" and optionally "New", one at a time in a
+// forked worker, and checks the order in which they started.
+static bool run(const char *timing_file, bool with_new, const char *expected) {
+	char order[16] = {0};
+	remove(ORDER_FILE);
+	cunit_init();
+	cunit_set_exec_mode(CUNIT_EXEC_MODE_FORK);
+	cunit_set_jobs(1);
+	cunit_set_timing_file(timing_file);
+	CUNIT_SUITE_BEGIN("Schedule", NULL, NULL)
+	for (int i = 0; i < 4; i++) { CUNIT_TEST("Quick", test_quick) }
+	CUNIT_TEST("Long", test_long)
+	if (with_new) { CUNIT_TEST("New", test_new) }
+	CUNIT_SUITE_END()
+	if (cunit_run() != 0) { return false; }
+
+	FILE *file = fopen(ORDER_FILE, "r");
+	if (!file) { return false; }
+	const bool read = fgets(order, sizeof(order), file) != NULL;
+	fclose(file);
+	remove(ORDER_FILE);
+	return read && strcmp(order, expected) == 0;
+}
+
+int main(void) {
+	const char *timing_file = "schedule_timings.txt";
+
+	// Without history the tests start in registration order.
+	if (!run(NULL, false, "qqqqL")) { return -1; }
+
+	// With history the longest test starts first.
+	if (!write_timings(timing_file) || !run(timing_file, false, "Lqqqq")) { return -1; }
+
+	// A test without history counts as the longest test on record.
+	if (!write_timings(timing_file) || !run(timing_file, true, "LNqqqq")) { return -1; }
+
+	remove(timing_file);
+	return 0;
+}
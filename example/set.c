@@ -0,0 +1,181 @@
+#include "recorder.h"
+
+// An allow-list of IDs and many IDs to check against it, for the benchmark.
+#define ALLOWED 100000
+#define IDS     1000000
+static uint32_t    *allowed_ids, *ids;
+static cunit_set_t *allowed;
+
+// Every size and position for each element size, so that each block and tail of the scan is crossed.
+static void test_scan(void) {
+	static uint8_t  u8[200];
+	static int16_t  i16[200];
+	static uint32_t u32[200];
+	static int64_t  i64[200];
+	static void    *ptr[200];
+	for (size_t size = 0; size <= 200; size++) {
+		for (size_t at = 0; at <= size; at++) {
+			for (size_t i = 0; i < size; i++) {
+				u8[i]  = (uint8_t)i;
+				i16[i] = (int16_t)(i - 100);
+				u32[i] = (uint32_t)i << 16;
+				i64[i] = (int64_t)i << 40;
+				ptr[i] = &u8[i];
+			}
+			// The wanted value is at `at`, or nowhere when `at` is `size`. Before it is a 64-bit
+			// element whose lower half matches and upper half does not.
+			if (at < size) {
+				u8[at]  = 0xEE;
+				i16[at] = -1000;
+				u32[at] = 0xDEADBEEF;
+				i64[at] = -7;
+				ptr[at] = &i64[0];
+			}
+			if (at > 0) { i64[at - 1] = (int64_t)0xFFFFFFF9; }
+			const bool present = at < size;
+			assert_true(check_in_array(CUNIT_VALUE_UINT8(0xEE), u8, size) == present);
+			assert_true(check_in_array(CUNIT_VALUE_INT16(-1000), i16, size) == present);
+			assert_true(check_in_array(CUNIT_VALUE_UINT32(0xDEADBEEF), u32, size) == present);
+			assert_true(check_in_array(CUNIT_VALUE_INT64(-7), i64, size) == present);
+			assert_true(check_in_array(CUNIT_VALUE_POINTER(&i64[0]), ptr, size) == present);
+		}
+	}
+
+	const float  f[] = {1.0f, INFINITY};
+	const double d[] = {-INFINITY, NAN};
+	assert_in_array(CUNIT_VALUE_FLOAT(INFINITY), f, 2);
+	assert_in_array(CUNIT_VALUE_DOUBLE(-INFINITY), d, 2);
+	assert_in_array(CUNIT_VALUE_DOUBLE(NAN), d, 2);
+	assert_not_in_array(CUNIT_VALUE_FLOAT(-INFINITY), f, 2);
+}
+
+static void test_integers(void) {
+	const int32_t values[] = {5, -3, 0, 5, 70000, -3};
+	cunit_set_t  *set      = cunit_set_new(CUnitType_Int32, values, 6);
+	assert_not_null(set);
+	assert_uint64_eq(cunit_set_size(set), 4);
+
+	assert_in_set(CUNIT_VALUE_INT32(5), set);
+	assert_in_set(CUNIT_VALUE_INT32(0), set);
+	assert_in_set(CUNIT_VALUE_INT8(-3), set);  // Integers compare by value, whatever their width
+	assert_in_set(CUNIT_VALUE_UINT64(70000), set);
+	assert_not_in_set(CUNIT_VALUE_UINT64(-3), set);  // Not -3, whatever its bits
+	assert_not_in_set(CUNIT_VALUE_INT32(6), set);
+	assert_not_in_set(CUNIT_VALUE_POINTER(NULL), set);
+	assert_not_in_set(CUNIT_VALUE_STRING("5"), set);
+
+	const int32_t good[] = {0, 5, 5, -3}, bad[] = {5, 1, 70000, 2, 3};
+	assert_all_in_set(good, 4, set);
+	assert_false(check_all_in_set(bad, 5, set));
+	assert_str_eq(recorded.message, "3 of 5 elements are not in set; first at index 1: 1");
+	assert_false(check_in_set(CUNIT_VALUE_INT32(6), set));
+	assert_str_eq(recorded.message, "6 is not in set");
+	assert_false(check_not_in_set(CUNIT_VALUE_INT32(5), set));
+	assert_str_eq(recorded.message, "5 is in set");
+	cunit_set_free(set);
+
+	assert_false(check_in_set(CUNIT_VALUE_INT32(6), (const cunit_set_t *)NULL));
+	assert_str_eq(recorded.message, "set is (null)");
+	assert_null(cunit_set_new(CUnitType_Invalid, values, 6));
+
+	// A negative value and an unsigned one with the same bits are different values.
+	const int64_t  negative[]   = {-1, INT64_MIN};
+	const uint64_t large[]      = {UINT64_MAX, (uint64_t)INT64_MAX + 1};
+	cunit_set_t   *signed_set   = cunit_set_new(CUnitType_Int64, negative, 2);
+	cunit_set_t   *unsigned_set = cunit_set_new(CUnitType_Uint64, large, 2);
+	assert_in_set(CUNIT_VALUE_INT(-1), signed_set);
+	assert_not_in_set(CUNIT_VALUE_UINT64(UINT64_MAX), signed_set);
+	assert_not_in_set(CUNIT_VALUE_UINT64((uint64_t)INT64_MAX + 1), signed_set);
+	assert_in_set(CUNIT_VALUE_UINT64(UINT64_MAX), unsigned_set);
+	assert_not_in_set(CUNIT_VALUE_INT(-1), unsigned_set);
+	assert_not_in_set(CUNIT_VALUE_INT64(INT64_MIN), unsigned_set);
+	cunit_set_free(signed_set);
+	cunit_set_free(unsigned_set);
+}
+
+static void test_strings(void) {
+	char         name[]  = "bob";
+	const char  *names[] = {"alice", name, NULL, "alice", ""};
+	cunit_set_t *set     = cunit_set_new(CUnitType_String, names, 5);
+	name[0]              = 'r';  // The set holds copies
+	assert_uint64_eq(cunit_set_size(set), 4);
+	assert_in_set(CUNIT_VALUE_STRING("bob"), set);
+	assert_in_set(CUNIT_VALUE_STRING("alice"), set);
+	assert_in_set(CUNIT_VALUE_STRING(""), set);
+	assert_in_set(CUNIT_VALUE_STRING(NULL), set);
+	assert_not_in_set(CUNIT_VALUE_STRING("rob"), set);
+	assert_not_in_set(CUNIT_VALUE_STRING("alic"), set);
+	cunit_set_free(set);
+}
+
+static void test_floats(void) {
+	const double values[] = {1.0, -0.5, NAN, 1e300, -INFINITY, 1.0};
+	cunit_set_t *set      = cunit_set_new(CUnitType_Float64, values, 6);
+	assert_uint64_eq(cunit_set_size(set), 5);
+	assert_in_set(CUNIT_VALUE_DOUBLE(1.0 + DBL_EPSILON), set);
+	assert_in_set(CUNIT_VALUE_DOUBLE(-0.5), set);
+	assert_in_set(CUNIT_VALUE_DOUBLE(NAN), set);
+	assert_in_set(CUNIT_VALUE_DOUBLE(1e300), set);
+	assert_in_set(CUNIT_VALUE_DOUBLE(-INFINITY), set);
+	assert_not_in_set(CUNIT_VALUE_DOUBLE(1.0 + 4 * DBL_EPSILON), set);
+	assert_not_in_set(CUNIT_VALUE_DOUBLE(INFINITY), set);
+	cunit_set_free(set);
+
+	// A set of floats finds what check_in_array() finds.
+	const float floats[] = {0.0f, 0.25f, 1.0f, 3.0f, 1e-7f};
+	set                  = cunit_set_new(CUnitType_Float32, floats, 5);
+	for (int i = -400; i <= 400; i++) {
+		const float x = 1.0f + (float)i * FLT_EPSILON / 8;
+		assert_true(cunit_set_contains(set, CUNIT_VALUE_FLOAT(x)) == check_in_array(CUNIT_VALUE_FLOAT(x), floats, 5));
+		const float y = (float)i * 1e-9f;
+		assert_true(cunit_set_contains(set, CUNIT_VALUE_FLOAT(y)) == check_in_array(CUNIT_VALUE_FLOAT(y), floats, 5));
+	}
+	cunit_set_free(set);
+}
+
+static void test_pointers(void) {
+	int          a, b, c;
+	void *const  pointers[] = {&a, &b, NULL};
+	cunit_set_t *set        = cunit_set_new(CUnitType_Pointer, pointers, 3);
+	assert_in_set(CUNIT_VALUE_POINTER(&b), set);
+	assert_in_set(CUNIT_VALUE_POINTER(NULL), set);
+	assert_not_in_set(CUNIT_VALUE_POINTER(&c), set);
+	cunit_set_free(set);
+}
+
+static void bench_all_in_set(void) {
+	const bool in = check_all_in_set(ids, IDS, allowed);
+	cunit_do_not_optimize(in);
+}
+
+int main(void) {
+	cunit_init();
+	cunit_set_reporter(&recorder);
+	cunit_set_bench_time(0.02);
+	cunit_set_bench_repetitions(3);
+
+	allowed_ids = (uint32_t *)malloc(ALLOWED * sizeof(uint32_t));
+	ids         = (uint32_t *)malloc(IDS * sizeof(uint32_t));
+	if (!allowed_ids || !ids) { return -1; }
+	for (uint32_t i = 0; i < ALLOWED; i++) { allowed_ids[i] = i * 2654435761u; }
+	for (uint32_t i = 0; i < IDS; i++) { ids[i] = allowed_ids[(i * 7919u) % ALLOWED]; }
+	allowed = cunit_set_new(CUnitType_Uint32, allowed_ids, ALLOWED);
+	if (!allowed) { return -1; }
+
+	CUNIT_SUITE_BEGIN("Sets", NULL, NULL)
+	CUNIT_TEST("Scan", test_scan)
+	CUNIT_TEST("Integers", test_integers)
+	CUNIT_TEST("Strings", test_strings)
+	CUNIT_TEST("Floats", test_floats)
+	CUNIT_TEST("Pointers", test_pointers)
+	CUNIT_BENCH("1M IDs in 100k", bench_all_in_set)
+	CUNIT_SUITE_END()
+
+	const int result = cunit_run();
+	cunit_set_free(allowed);
+	free(allowed_ids);
+	free(ids);
+	if (result != 0 || recorded.failed != 0 || recorded.median <= 0) { return -1; }
+	printf("assert_all_in_set: %.1f M lookups/s in a set of %d\n", IDS / recorded.median * 1e3, ALLOWED);
+	return 0;
+}
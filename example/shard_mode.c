@@ -0,0 +1,100 @@
+#include "cunit.h"
+
+#define TEST_COUNT  12
+#define SHARD_COUNT 3
+
+static int runs[TEST_COUNT];
+static int current;
+
+#define DEFINE_TEST(n) \
+	static void test_##n(void) { runs[n]++; }
+DEFINE_TEST(0)
+DEFINE_TEST(1)
+DEFINE_TEST(2)
+DEFINE_TEST(3)
+DEFINE_TEST(4)
+DEFINE_TEST(5)
+DEFINE_TEST(6)
+DEFINE_TEST(7)
+DEFINE_TEST(8)
+DEFINE_TEST(9)
+DEFINE_TEST(10)
+DEFINE_TEST(11)
+
+static const cunit_test_func_t tests[TEST_COUNT] = {test_0, test_1, test_2, test_3, test_4, test_5, test_6, test_7, test_8, test_9, test_10, test_11};
+static const char *const       names[TEST_COUNT] = {"T0", "T1", "T2", "T3", "T4", "T5", "T6", "T7", "T8", "T9", "T10", "T11"};
+
+// The timing history every shard starts from. T0 is as long as all other tests
+// together, so it must get a shard of its own.
+static char history[512];
+
+// Writes the timing history once, for all shards to share.
+static bool write_timings(const char *timing_file) {
+	int length = snprintf(history, sizeof(history), "Shard A\tT0\t%d\n", TEST_COUNT - 1);
+	for (int i = 1; i < TEST_COUNT; i++) {
+		length += snprintf(history + length, sizeof(history) - (size_t)length, "%s\t%s\t1\n", i < TEST_COUNT / 2 ? "Shard A" : "Shard B", names[i]);
+	}
+	FILE *file = fopen(timing_file, "w");
+	if (!file) { return false; }
+	fputs(history, file);
+	return fclose(file) == 0;
+}
+
+// Returns whether the timing file still holds the history it was written with.
+static bool kept_timings(const char *timing_file) {
+	char  contents[sizeof(history)] = {0};
+	FILE *file                      = fopen(timing_file, "r");
+	if (!file) { return false; }
+	const size_t size = fread(contents, 1, sizeof(contents) - 1, file);
+	fclose(file);
+	return size == strlen(history) && memcmp(contents, history, size) == 0;
+}
+
+// Runs one shard and returns how many tests it ran.
+static int run_shard(int index, const char *timing_file) {
+	int before = 0, after = 0;
+	for (int i = 0; i < TEST_COUNT; i++) { before += runs[i]; }
+
+	cunit_init();
+	cunit_set_shard(index, SHARD_COUNT);
+	cunit_set_timing_file(timing_file);
+	CUNIT_SUITE_BEGIN("Shard A", NULL, NULL)
+	for (current = 0; current < TEST_COUNT / 2; current++) { CUNIT_TEST(names[current], tests[current]) }
+	CUNIT_SUITE_END()
+	CUNIT_SUITE_BEGIN("Shard B", NULL, NULL)
+	for (; current < TEST_COUNT; current++) { CUNIT_TEST(names[current], tests[current]) }
+	CUNIT_SUITE_END()
+	if (cunit_run() != 0) { return -1; }
+
+	for (int i = 0; i < TEST_COUNT; i++) { after += runs[i]; }
+	return after - before;
+}
+
+// Checks that every test ran exactly `expected` times so far.
+static bool check_runs(int expected) {
+	for (int i = 0; i < TEST_COUNT; i++) {
+		if (runs[i] != expected) { return false; }
+	}
+	return true;
+}
+
+int main(void) {
+	const char *timing_file = "shard_mode_timings.txt";
+
+	// Round-robin without history: every shard gets the same number of tests.
+	for (int shard = 0; shard < SHARD_COUNT; shard++) {
+		if (run_shard(shard, NULL) != TEST_COUNT / SHARD_COUNT) { return -1; }
+	}
+	if (!check_runs(1)) { return -1; }
+
+	// Balanced by duration: shard 0 only runs the long test. The shards run one after
+	// another from the same file, which none of them updates, so they split it alike.
+	if (!write_timings(timing_file)) { return -1; }
+	if (run_shard(0, timing_file) != 1 || runs[0] != 2) { return -1; }
+	for (int shard = 1; shard < SHARD_COUNT; shard++) {
+		if (run_shard(shard, timing_file) <= 0) { return -1; }
+	}
+	const bool kept = kept_timings(timing_file);
+	remove(timing_file);
+	return kept && check_runs(2) ? 0 : -1;
+}
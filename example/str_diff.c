@@ -0,0 +1,206 @@
+#include "recorder.h"
+
+// A large generated document, a copy with a few lines changed, and one with every line changed.
+#define RECORDS 200000
+static char *document, *edited, *rewritten;
+
+static int lines(void) {
+	int n = 1;
+	for (const char *p = recorded.message; *p; p++) { n += *p == '\n'; }
+	return n;
+}
+
+static void test_message(void) {
+	assert_false(check_str_eq("hello world", "hello"));
+	assert_str_eq(recorded.message, "hello world != hello");
+	assert_false(check_str_ne("same", "same"));
+	assert_str_eq(recorded.message, "same == same");
+	assert_false(check_str_eq("text", NULL));
+	assert_str_eq(recorded.message, "text != (null)");
+
+	assert_false(check_str_eq("a\nb\nc\nd\ne\nf\ng\nh\ni\nj\nk\nl\n", "a\nb\nc\nd\nE\nf\ng\nh\ni\nj\nk\nl\n"));
+	assert_str_eq(recorded.message,
+				  "strings differ at line 5, column 1:\n"
+				  "@@ -2,7 +2,7 @@\n"
+				  " b\n"
+				  " c\n"
+				  " d\n"
+				  "-e\n"
+				  "+E\n"
+				  " f\n"
+				  " g\n"
+				  " h");
+
+	assert_false(check_str_eq("{\n  \"id\": 1,\n  \"name\": \"x\"\n}", "{\n  \"id\": 1,\n  \"tags\": [],\n  \"name\": \"y\"\n}"));
+	assert_str_eq(recorded.message,
+				  "strings differ at line 3, column 4:\n"
+				  "@@ -1,4 +1,5 @@\n"
+				  " {\n"
+				  "   \"id\": 1,\n"
+				  "-  \"name\": \"x\"\n"
+				  "+  \"tags\": [],\n"
+				  "+  \"name\": \"y\"\n"
+				  " }");
+
+	assert_false(check_str_eq("one\ntwo", "one\ntwo\n"));
+	assert_str_eq(recorded.message,
+				  "strings differ at line 2, column 4:\n"
+				  "@@ -1,2 +1,2 @@\n"
+				  " one\n"
+				  "-two\n"
+				  "\\ No newline at end\n"
+				  "+two");
+
+	assert_false(check_str_eq("", "a\nb"));
+	assert_str_eq(recorded.message, "strings differ at line 1, column 1:\n@@ -0,0 +1,2 @@\n+a\n+b");
+
+	assert_false(check_str_n("x\ny\nz", "x\ny\nq", 5));
+	assert_str_eq(recorded.message, "strings differ at line 3, column 1:\n@@ -1,3 +1,3 @@\n x\n y\n-z\n+q");
+	assert_true(check_str_n("x\ny\nz", "x\ny\nq", 4));
+}
+
+// A long line is cut to the bytes around its first difference.
+static void test_long_line(void) {
+	char l[1000], r[1000];
+	for (int i = 0; i < 999; i++) { l[i] = r[i] = (char)('a' + i % 26); }
+	l[999] = r[999] = '\0';
+	r[700]          = '#';
+	assert_false(check_str_eq(l, r));
+	assert_not_null(strstr(recorded.message, "strings differ at line 1, column 701:\n@@ -1,1 +1,1 @@\n-..."));
+	assert_int_eq(lines(), 4);
+	assert_true(strlen(recorded.message) < 400);
+	assert_not_null(strchr(recorded.message, '#'));
+}
+
+// Random lists of lines: the diff is a patch from one to the other, with as few changes as can be.
+static uint64_t state = 0x9E3779B97F4A7C15ull;
+
+static uint32_t next_random(void) {
+	state = state * 6364136223846793005ull + 1442695040888963407ull;
+	return (uint32_t)(state >> 33);
+}
+
+static size_t random_lines(char *s, char *items) {
+	const size_t n = next_random() % 13;
+	for (size_t i = 0; i < n; i++) {
+		items[i] = (char)('a' + next_random() % 4);
+		s[2 * i]     = items[i];
+		s[2 * i + 1] = '\n';
+	}
+	s[2 * n] = '\0';
+	return n;
+}
+
+// Applies the hunks of the last recorded.message to the lines of `a`, and counts the lines it changes.
+static size_t patch(const char *a, size_t n, char *result, size_t *changes) {
+	size_t      size = 0, at = 0;
+	const char *p    = strchr(recorded.message, '\n');
+	*changes         = 0;
+	while (p && *++p) {
+		if (*p == '@') {
+			unsigned long from, count;
+			if (sscanf(p, "@@ -%lu,%lu", &from, &count) != 2) { return SIZE_MAX; }
+			for (size_t line = count ? from - 1 : from; at < line; at++) { result[size++] = a[at]; }
+		} else if (*p == '+') {
+			result[size++] = p[1];
+			++*changes;
+		} else if (*p == '-' || *p == ' ') {
+			if (at >= n || a[at] != p[1]) { return SIZE_MAX; }
+			if (*p == ' ') { result[size++] = a[at]; }
+			*changes += *p == '-';
+			at++;
+		}
+		p = strchr(p, '\n');
+	}
+	while (at < n) { result[size++] = a[at++]; }
+	return size;
+}
+
+static size_t longest_common(const char *a, size_t n, const char *b, size_t m) {
+	size_t lcs[13][13] = {{0}};
+	for (size_t i = 1; i <= n; i++) {
+		for (size_t j = 1; j <= m; j++) {
+			lcs[i][j] = a[i - 1] == b[j - 1] ? lcs[i - 1][j - 1] + 1 : lcs[i - 1][j] > lcs[i][j - 1] ? lcs[i - 1][j] : lcs[i][j - 1];
+		}
+	}
+	return lcs[n][m];
+}
+
+static void test_random(void) {
+	char l[32], r[32], a[16], b[16], result[32];
+	for (int trial = 0; trial < 5000; trial++) {
+		const size_t n = random_lines(l, a), m = random_lines(r, b);
+		if (strcmp(l, r) == 0) { continue; }
+		assert_false(check_str_eq(l, r));
+		size_t       changes;
+		const size_t size = patch(a, n, result, &changes);
+		assert_uint64_eq(size, m);
+		assert_true(memcmp(result, b, m) == 0);
+		assert_uint64_eq(changes, n + m - 2 * longest_common(a, n, b, m));
+	}
+}
+
+// Large documents give a bounded recorded.message in bounded time, whatever their differences.
+static void test_large(void) {
+	assert_false(check_str_eq(document, edited));
+	assert_not_null(strstr(recorded.message, "strings differ at line 100001, column 27:\n@@ -99998,9 +99998,10 @@\n"));
+	assert_not_null(strstr(recorded.message, "\n-  {\"id\": 100000, \"name\": \"record 100000\"},\n+  {\"id\": 100000, \"name\": \"changed\"},\n"));
+	assert_not_null(strstr(recorded.message, "\n+  {\"id\": 0, \"name\": \"inserted\"},\n"));
+
+	assert_false(check_str_eq(document, rewritten));
+	assert_not_null(strstr(recorded.message, "strings differ at line 2, column 10:\n"));
+	assert_true(lines() <= 110);
+	assert_not_null(strstr(recorded.message, "\n...\n... not diffed past 10000 lines"));
+	assert_true(strlen(recorded.message) < 16384);
+}
+
+static void bench_large_diff(void) {
+	const bool equal = check_str_eq(document, rewritten);
+	cunit_do_not_optimize(equal);
+}
+
+int main(void) {
+	cunit_init();
+	cunit_set_reporter(&recorder);
+	cunit_set_bench_time(0.02);
+	cunit_set_bench_repetitions(3);
+
+	const size_t size = (size_t)RECORDS * 64;
+	document          = (char *)malloc(size);
+	edited            = (char *)malloc(size);
+	rewritten         = (char *)malloc(size);
+	if (!document || !edited || !rewritten) { return -1; }
+	size_t d = 0, e = 0, w = 0;
+	d += (size_t)sprintf(document + d, "[\n");
+	e += (size_t)sprintf(edited + e, "[\n");
+	w += (size_t)sprintf(rewritten + w, "[\n");
+	for (int i = 1; i <= RECORDS; i++) {
+		d += (size_t)sprintf(document + d, "  {\"id\": %d, \"name\": \"record %d\"},\n", i, i);
+		w += (size_t)sprintf(rewritten + w, "  {\"id\": %d, \"name\": \"record %d\"},\n", i + 1, i);
+		if (i == 100000) {
+			e += (size_t)sprintf(edited + e, "  {\"id\": %d, \"name\": \"changed\"},\n", i);
+		} else {
+			e += (size_t)sprintf(edited + e, "  {\"id\": %d, \"name\": \"record %d\"},\n", i, i);
+		}
+		if (i == 100002) { e += (size_t)sprintf(edited + e, "  {\"id\": 0, \"name\": \"inserted\"},\n"); }
+	}
+	sprintf(document + d, "]\n");
+	sprintf(edited + e, "]\n");
+	sprintf(rewritten + w, "]\n");
+
+	CUNIT_SUITE_BEGIN("String diff", NULL, NULL)
+	CUNIT_TEST("Message", test_message)
+	CUNIT_TEST("Long line", test_long_line)
+	CUNIT_TEST("Random", test_random)
+	CUNIT_TEST("Large", test_large)
+	CUNIT_BENCH("Every line of 8 MB changed", bench_large_diff)
+	CUNIT_SUITE_END()
+
+	const int result = cunit_run();
+	free(document);
+	free(edited);
+	free(rewritten);
+	if (result != 0 || recorded.failed != 0 || recorded.median <= 0) { return -1; }
+	printf("assert_str_eq: a failed check on every line of %d changed takes %.2f ms\n", RECORDS, recorded.median / 1e6);
+	return 0;
+}
@@ -0,0 +1,163 @@
+#include "recorder.h"
+
+#ifndef _WIN32
+#include <pthread.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+// What was reported of the tests of the last run.
+static int            ended;
+static cunit_status_t hang_status;
+static double         hang_time;
+static char           order[16];
+
+// Volatile, since a hung test is left by a jump from a signal handler.
+static volatile int hangs;
+
+static void on_test_end(const cunit_test_report_t *test) {
+	ended++;
+	if (strcmp(test->name, "Hang") == 0) {
+		hang_status = test->status;
+		hang_time   = test->timing->total.wall;
+	}
+}
+
+// Appends the letter of the running test to `order`.
+static void ran(char letter) {
+	const size_t length = strlen(order);
+	if (length + 1 < sizeof(order)) { order[length] = letter; }
+}
+
+static void test_fast(void) { ran('f'); }
+static void test_after(void) { ran('a'); }
+static void test_later(void) { ran('l'); }
+static void test_hang(void) {
+	hangs++;
+	for (volatile unsigned spin = 0;; spin++) {}
+}
+
+// Registers the tests, runs them and checks what was reported.
+static bool run(double hang_timeout, int expected_ended, const char *expected_order) {
+	memset(&recorded, 0, sizeof(recorded));
+	memset(order, 0, sizeof(order));
+	ended             = 0;
+	hang_status       = CUNIT_STATUS_PASSED;
+	hang_time         = 0;
+	recorder_test_end = on_test_end;
+	cunit_add_reporter(&recorder);
+	CUNIT_SUITE_BEGIN("A", NULL, NULL)
+	CUNIT_TEST("Fast", test_fast)
+	CUNIT_TEST_TIMEOUT("Hang", test_hang, hang_timeout)
+	CUNIT_TEST("After", test_after)
+	CUNIT_SUITE_END()
+	CUNIT_SUITE_BEGIN("B", NULL, NULL)
+	CUNIT_TEST("Later", test_later)
+	CUNIT_SUITE_END()
+
+	hangs = 0;
+	if (cunit_run() != 1) { return false; }
+	if (hang_status != CUNIT_STATUS_TIMEOUT || hang_time < 0.2 || recorded.failed != 1) { return false; }
+	if (expected_order && hangs != 1) { return false; }
+	if (expected_ended && (ended != expected_ended || recorded.total != expected_ended || recorded.passed != expected_ended - 1)) { return false; }
+	return !expected_order || strcmp(order, expected_order) == 0;
+}
+
+#ifndef _WIN32
+// Held by a hung test and wanted by the reporter, as a lock of malloc or stdio may be.
+static pthread_mutex_t held = PTHREAD_MUTEX_INITIALIZER;
+
+static void test_hang_locked(void) {
+	pthread_mutex_lock(&held);
+	for (volatile unsigned spin = 0;; spin++) {}
+}
+
+static void on_test_end_locked(void *data, const cunit_test_report_t *test) {
+	(void)data, (void)test;
+	pthread_mutex_lock(&held);
+	pthread_mutex_unlock(&held);
+}
+
+static const cunit_reporter_t locked = {NULL, NULL, NULL, NULL, NULL, on_test_end_locked, NULL, NULL, NULL};
+
+// A run that cannot be reported after a test was interrupted ends the process instead of hanging.
+static bool run_locked(void) {
+	fflush(stdout);
+	const pid_t pid = fork();
+	if (pid < 0) { return false; }
+	if (pid == 0) {
+		alarm(10);
+		cunit_set_reporter(&locked);
+		CUNIT_SUITE_BEGIN("Locked", NULL, NULL)
+		CUNIT_TEST_TIMEOUT("Hang", test_hang_locked, 0.2)
+		CUNIT_SUITE_END()
+		cunit_run();
+		_exit(EXIT_SUCCESS);
+	}
+	int status;
+	if (waitpid(pid, &status, 0) != pid) { return false; }
+	return WIFEXITED(status) && WEXITSTATUS(status) == EXIT_FAILURE;
+}
+
+static void on_test_end_slow(void *data, const cunit_test_report_t *test) {
+	(void)data, (void)test;
+	ended++;
+	const struct timespec pause = {0, 300000000};
+	nanosleep(&pause, NULL);
+}
+
+static const cunit_reporter_t slow = {NULL, NULL, NULL, NULL, NULL, on_test_end_slow, NULL, NULL, NULL};
+
+// A report that takes longer than the grace period in all, but keeps making progress, is not cut short.
+static bool run_slow(void) {
+	fflush(stdout);
+	const pid_t pid = fork();
+	if (pid < 0) { return false; }
+	if (pid == 0) {
+		alarm(10);
+		cunit_set_reporter(&slow);
+		cunit_set_jobs(2);
+		CUNIT_SUITE_BEGIN("Slow", NULL, NULL)
+		CUNIT_TEST_TIMEOUT("Hang", test_hang, 0.2)
+		CUNIT_TEST("Fast", test_fast)
+		CUNIT_TEST("Fast", test_fast)
+		CUNIT_TEST("Fast", test_fast)
+		CUNIT_TEST("Fast", test_fast)
+		CUNIT_TEST("Fast", test_fast)
+		CUNIT_SUITE_END()
+		ended = 0;
+		_exit(cunit_run() == 1 && ended == 6 ? EXIT_SUCCESS : 2);
+	}
+	int status;
+	if (waitpid(pid, &status, 0) != pid) { return false; }
+	return WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS;
+}
+#endif
+
+int main(void) {
+	cunit_init();
+
+#ifndef _WIN32
+	if (!run_locked()) { return -1; }
+	if (!run_slow()) { return -1; }
+#endif
+
+	// In-process, the hung test is interrupted and the run ends after reporting it.
+	if (!run(0.2, 2, "f")) { return -1; }
+
+	// The same thread can be interrupted again; the global timeout applies as well.
+	cunit_set_timeout(0.2);
+	if (!run(0, 2, "f")) { return -1; }
+
+	// On the thread pool, the tests that have not started yet are left out.
+	cunit_set_jobs(2);
+	cunit_set_timeout(0.2);
+	if (!run(0, 0, NULL)) { return -1; }
+
+	// A forked worker is killed and the other tests still run.
+	cunit_set_jobs(2);
+	cunit_set_exec_mode(CUNIT_EXEC_MODE_FORK);
+	if (!run(0.2, 4, NULL)) { return -1; }
+	return 0;
+}
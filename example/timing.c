@@ -0,0 +1,40 @@
+#include "cunit.h"
+
+// Burns some CPU time so that the phase being measured is clearly non-zero.
+static void spin(void) {
+	volatile unsigned long sink = 0;
+	for (unsigned long i = 0; i < 2000000ul; i++) { sink += i; }
+}
+
+static void setup(void) { spin(); }
+static void test_idle(void) {}
+static void test_busy(void) {
+	spin();
+	spin();
+}
+
+int main(void) {
+	cunit_init();
+	CUNIT_SUITE_BEGIN("Timing", setup, NULL)
+	CUNIT_TEST("Idle", test_idle)
+	CUNIT_TEST("Busy", test_busy)
+	CUNIT_SUITE_END()
+	if (cunit_run_suite("Timing") != 0) { return -1; }
+
+	cunit_timing_t idle, busy, suite;
+	if (!cunit_test_timing("Timing", "Idle", &idle) || !cunit_test_timing("Timing", "Busy", &busy)) { return -1; }
+	if (!cunit_suite_timing("Timing", &suite)) { return -1; }
+	if (cunit_test_timing("Timing", "Missing", &idle) || cunit_suite_timing("Missing", &suite)) { return -1; }
+
+	// Setup time is measured apart from the body, and CPU time is measured at all.
+	if (idle.setup.wall <= 0.0 || idle.setup.cpu <= 0.0 || idle.teardown.wall != 0.0) { return -1; }
+	if (busy.body.wall <= idle.body.wall || busy.body.cpu <= 0.0) { return -1; }
+	if (busy.total.wall < busy.setup.wall + busy.body.wall) { return -1; }
+
+	// The suite totals are the sum of its tests.
+	const double sum = idle.total.wall + busy.total.wall;
+	if (suite.total.wall < sum * 0.999 || suite.total.wall > sum * 1.001) { return -1; }
+
+	cunit_cleanup();
+	return 0;
+}
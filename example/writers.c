@@ -0,0 +1,122 @@
+#include <string.h>
+
+#include "cunit.h"
+
+#ifndef _WIN32
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+static void test_pass(void) { assert_true(true); }
+static void test_check(void) { check_int_eq(1, 2, "soft"); }
+static void test_fail(void) { assert_int_eq(3, 4, "hard"); }
+
+// Reads a whole file into `buf`, returning false if it does not fit.
+static bool read_file(const char *path, char *buf, size_t size) {
+	FILE *file = fopen(path, "rb");
+	if (!file) { return false; }
+	const size_t n = fread(buf, 1, size - 1, file);
+	fclose(file);
+	buf[n] = '\0';
+	return n < size - 1;
+}
+
+static int count_lines(const char *s) {
+	int lines = 0;
+	for (; *s; s++) { lines += *s == '\n'; }
+	return lines;
+}
+
+static bool ends_with(const char *s, const char *suffix) {
+	const size_t n = strlen(s), m = strlen(suffix);
+	return n >= m && strcmp(s + n - m, suffix) == 0;
+}
+
+// Whether the JUnit file was a complete document after every test; the reporter checking it comes after the writer.
+static bool complete = true;
+
+static void on_test_end(void *data, const cunit_test_report_t *test) {
+	(void)test;
+	static char junit[16384];
+	complete = complete && read_file((const char *)data, junit, sizeof(junit)) && ends_with(junit, "  </testsuite>\n</testsuites>\n");
+}
+
+#ifndef _WIN32
+// A failure that ends the process in FAIL_FAST mode is written to both files, which stay complete.
+static bool run_fail_fast(int jobs, const char *junit_path, const char *json_path, char *junit, char *json, size_t size) {
+	fflush(stdout);
+	const pid_t pid = fork();
+	if (pid < 0) { return false; }
+	if (pid == 0) {
+		cunit_cleanup();
+		cunit_init();
+		cunit_set_jobs(jobs);
+		cunit_set_error_mode(CUNIT_ERROR_MODE_FAIL_FAST);
+		cunit_add_reporter(cunit_junit_reporter(junit_path));
+		cunit_add_reporter(cunit_json_reporter(json_path));
+		CUNIT_SUITE_BEGIN("Writers", NULL, NULL)
+		CUNIT_TEST("Fail", test_fail)
+		CUNIT_SUITE_END()
+		CUNIT_SUITE_BEGIN("Later", NULL, NULL)
+		CUNIT_TEST("Pass", test_pass)
+		CUNIT_SUITE_END()
+		cunit_run();
+		_exit(EXIT_SUCCESS);
+	}
+	int status;
+	if (waitpid(pid, &status, 0) != pid || !WIFEXITED(status) || WEXITSTATUS(status) != EXIT_FAILURE) { return false; }
+	if (!read_file(junit_path, junit, size) || !read_file(json_path, json, size)) { return false; }
+	if (!ends_with(junit, "    </testcase>\n  </testsuite>\n</testsuites>\n") || !strstr(junit, "<failure message=\"3 &lt; 4\"")) { return false; }
+	return strstr(json, "\"test\":\"Fail\",\"status\":\"failed\"") && ends_with(json, "}\n");
+}
+#endif
+
+int main(void) {
+	static char junit[16384], json[16384];
+	const char *junit_path = "writers.xml";
+	const char *json_path  = "writers.jsonl";
+
+	cunit_init();
+	cunit_set_jobs(2);
+	cunit_add_reporter(cunit_junit_reporter(junit_path));
+	cunit_add_reporter(cunit_json_reporter(json_path));
+	const cunit_reporter_t checker = {(void *)junit_path, NULL, NULL, NULL, NULL, on_test_end, NULL, NULL, NULL};
+	cunit_add_reporter(&checker);
+	CUNIT_SUITE_BEGIN("Writers", NULL, NULL)
+	CUNIT_TEST("Pass", test_pass)
+	CUNIT_TEST("Check", test_check)
+	CUNIT_TEST("Fail <&\">", test_fail)
+	CUNIT_SUITE_END()
+	CUNIT_SUITE_BEGIN("Later", NULL, NULL)
+	CUNIT_TEST("Pass", test_pass)
+	CUNIT_SUITE_END()
+	if (cunit_run_suite("Writers") != 1 || !complete) { return -1; }
+
+	// The files are complete while the process is still running.
+	if (!read_file(junit_path, junit, sizeof(junit)) || !read_file(json_path, json, sizeof(json))) { return -1; }
+	if (!ends_with(junit, "  </testsuite>\n</testsuites>\n")) { return -1; }
+	if (!strstr(junit, "<testcase classname=\"Writers\" name=\"Pass\" time=\"")) { return -1; }
+	if (!strstr(junit, "name=\"Fail &lt;&amp;&quot;&gt;\"") || !strstr(junit, "<failure message=\"3 &lt; 4\" type=\"assertion\">")) { return -1; }
+	if (!strstr(junit, "<system-out>example/writers.c:11: 1 &lt; 2 (soft)\n</system-out>")) { return -1; }
+	if (count_lines(json) != 5 || !ends_with(json, "}\n")) { return -1; }
+	if (!strstr(json, "{\"event\":\"test\",\"suite\":\"Writers\",\"test\":\"Fail <&\\\">\",\"status\":\"failed\"")) { return -1; }
+	if (!strstr(json, "{\"file\":\"example/writers.c\",\"line\":12,\"func\":\"test_fail\",\"message\":\"3 < 4\",\"note\":\"hard\",\"fatal\":false}")) {
+		return -1;
+	}
+
+	// A second suite of the same run goes into the same files.
+	if (cunit_run_suite("Later") != 0) { return -1; }
+	cunit_cleanup();
+	if (!read_file(junit_path, junit, sizeof(junit)) || !read_file(json_path, json, sizeof(json))) { return -1; }
+	if (!strstr(junit, "<testsuite name=\"Later\">") || !ends_with(junit, "</testsuites>\n")) { return -1; }
+	if (count_lines(json) != 8) { return -1; }
+
+#ifndef _WIN32
+	if (!run_fail_fast(1, junit_path, json_path, junit, json, sizeof(junit))) { return -1; }
+	if (!run_fail_fast(2, junit_path, json_path, junit, json, sizeof(junit))) { return -1; }
+#endif
+
+	remove(junit_path);
+	remove(json_path);
+	return 0;
+}
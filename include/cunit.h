@@ -21,9 +21,13 @@
  *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
  *    SOFTWARE.
  */
+#include "cunit/alloc.h"
 #include "cunit/assert.h"
+#include "cunit/bench.h"
 #include "cunit/compare.h"
 #include "cunit/ctx.h"
 #include "cunit/def.h"
+#include "cunit/reporter.h"
+#include "cunit/set.h"
 #include "cunit/suite.h"
 #include "cunit/value.h"
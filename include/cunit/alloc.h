@@ -0,0 +1,111 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 tayne3
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ * 2. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *    SOFTWARE.
+ */
+#ifndef CUNIT_ALLOC_H
+#define CUNIT_ALLOC_H
+
+#include "assert.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ========================================================================== */
+/*                              TYPE DEFINITIONS                              */
+/* ========================================================================== */
+
+/**
+ * @brief Heap use of a test, counted on the thread that runs it
+ * @note Sizes are the sizes requested, without the allocator's overhead. A block
+ *       that realloc() resizes counts as freed and allocated again.
+ */
+typedef struct {
+	uint64_t count;         /**< Number of blocks allocated (malloc, calloc and realloc) */
+	uint64_t frees;         /**< Number of blocks freed, including those moved by realloc */
+	uint64_t bytes;         /**< Bytes allocated in total */
+	uint64_t peak;          /**< Largest number of bytes allocated by the test and live at once */
+	uint64_t unfreed;       /**< Bytes allocated by the test and not freed by it */
+	uint64_t unfreed_count; /**< Blocks allocated by the test and not freed by it */
+} cunit_alloc_stats_t;
+
+/* ========================================================================== */
+/*                             ALLOCATION API                                 */
+/* ========================================================================== */
+
+/**
+ * @brief Check whether heap allocations are tracked
+ * @return true if the program is linked with the allocation wrappers
+ * @note Tracking is enabled by linking the test program with cunit::alloc, which wraps
+ *       malloc, calloc, realloc and free with the GNU linker's --wrap option (so it is not
+ *       available on Windows or macOS). Every test then records its heap use from the start
+ *       of its setup to the end of its teardown, shown after the test and passed to reporters.
+ *       Only calls made from objects linked into the program are seen: memory that libc
+ *       allocates itself (strdup(), fopen(), ...) is not, and freeing it is ignored.
+ */
+bool cunit_alloc_tracking(void);
+
+/**
+ * @brief Get the heap use of the running test so far
+ * @param stats Receives the counters (must not be NULL)
+ * @return true if allocations are tracked and a test is running on the calling thread
+ */
+bool cunit_alloc_stats(cunit_alloc_stats_t *stats);
+
+/**
+ * @brief The counters that the allocation checks compare
+ */
+typedef enum {
+	CUNIT_ALLOC_COUNT,   /**< cunit_alloc_stats_t::count */
+	CUNIT_ALLOC_BYTES,   /**< cunit_alloc_stats_t::bytes */
+	CUNIT_ALLOC_PEAK,    /**< cunit_alloc_stats_t::peak */
+	CUNIT_ALLOC_UNFREED, /**< cunit_alloc_stats_t::unfreed */
+} cunit_alloc_counter_t;
+
+bool __cunit_check_alloc(const cunit_context_t ctx, cunit_alloc_counter_t counter, uint64_t limit, const char *format, ...);
+
+/**
+ * @brief Check that the running test made at most `n` allocations so far
+ * @note Fails if allocations are not tracked (see cunit_alloc_tracking()).
+ * @example
+ * @code
+ * static void test_lookup_does_not_allocate(void) {
+ *     map_lookup(map, "key");
+ *     assert_alloc_count_le(0);
+ * }
+ * @endcode
+ */
+#define check_alloc_count_le(__n, ...)   __cunit_check_alloc(CUNIT_CTX_CURR, CUNIT_ALLOC_COUNT, (uint64_t)(__n), STR_NULL __VA_ARGS__)
+#define check_alloc_bytes_le(__n, ...)   __cunit_check_alloc(CUNIT_CTX_CURR, CUNIT_ALLOC_BYTES, (uint64_t)(__n), STR_NULL __VA_ARGS__)
+#define check_alloc_peak_le(__n, ...)    __cunit_check_alloc(CUNIT_CTX_CURR, CUNIT_ALLOC_PEAK, (uint64_t)(__n), STR_NULL __VA_ARGS__)
+#define check_alloc_unfreed_le(__n, ...) __cunit_check_alloc(CUNIT_CTX_CURR, CUNIT_ALLOC_UNFREED, (uint64_t)(__n), STR_NULL __VA_ARGS__)
+
+#define assert_alloc_count_le(__n, ...)   ___cunit_assert_check_1(check_alloc_count_le, __n, __VA_ARGS__)
+#define assert_alloc_bytes_le(__n, ...)   ___cunit_assert_check_1(check_alloc_bytes_le, __n, __VA_ARGS__)
+#define assert_alloc_peak_le(__n, ...)    ___cunit_assert_check_1(check_alloc_peak_le, __n, __VA_ARGS__)
+#define assert_alloc_unfreed_le(__n, ...) ___cunit_assert_check_1(check_alloc_unfreed_le, __n, __VA_ARGS__)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CUNIT_ALLOC_H */
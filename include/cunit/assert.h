@@ -42,22 +42,31 @@ extern "C" {
 	do {                                                                            \
 		if (!__func(__1, __2, __3, __VA_ARGS__)) { cunit__handle_fail(CUNIT_CTX_CURR); } \
 	} while (0)
+#define ___cunit_assert_check_4(__func, __1, __2, __3, __4, ...)                         \
+	do {                                                                                 \
+		if (!__func(__1, __2, __3, __4, __VA_ARGS__)) { cunit__handle_fail(CUNIT_CTX_CURR); } \
+	} while (0)
+
+// A scalar check compares in the caller, and only a failure calls into cunit:
+// the format and its arguments are evaluated only then.
+#define ___cunit_check_fast(__compare, __l, __r, __cond, ...) \
+	(__cunit_count_assertion(), __compare((__l), (__r), (__cond)) ? true : __cunit_compare_report(CUNIT_CTX_CURR, STR_NULL __VA_ARGS__))
 
-#define ___cunit_check_bool_compare(__l, __r, ...)           __cunit_compare_bool(CUNIT_CTX_CURR, (__l), (__r), CUnit_Equal, STR_NULL __VA_ARGS__)
-#define ___cunit_check_char_compare(__l, __r, ...)           __cunit_compare_char(CUNIT_CTX_CURR, (__l), (__r), CUnit_Equal, STR_NULL __VA_ARGS__)
-#define ___cunit_check_ptr_compare(__l, __r, __cond, ...)    __cunit_compare_ptr(CUNIT_CTX_CURR, (__l), (__r), (__cond), STR_NULL __VA_ARGS__)
-#define ___cunit_check_float_compare(__l, __r, __cond, ...)  __cunit_compare_float(CUNIT_CTX_CURR, (__l), (__r), (__cond), STR_NULL __VA_ARGS__)
-#define ___cunit_check_double_compare(__l, __r, __cond, ...) __cunit_compare_double(CUNIT_CTX_CURR, (__l), (__r), (__cond), STR_NULL __VA_ARGS__)
+#define ___cunit_check_bool_compare(__l, __r, ...)           ___cunit_check_fast(__cunit_compare_bool_fast, __l, __r, CUnit_Equal, __VA_ARGS__)
+#define ___cunit_check_char_compare(__l, __r, ...)           ___cunit_check_fast(__cunit_compare_char_fast, __l, __r, CUnit_Equal, __VA_ARGS__)
+#define ___cunit_check_ptr_compare(__l, __r, __cond, ...)    ___cunit_check_fast(__cunit_compare_ptr_fast, __l, __r, __cond, __VA_ARGS__)
+#define ___cunit_check_float_compare(__l, __r, __cond, ...)  ___cunit_check_fast(__cunit_compare_float_fast, __l, __r, __cond, __VA_ARGS__)
+#define ___cunit_check_double_compare(__l, __r, __cond, ...) ___cunit_check_fast(__cunit_compare_double_fast, __l, __r, __cond, __VA_ARGS__)
 
-#define ___cunit_check_int8_compare(__l, __r, __cond, ...)  __cunit_compare_int8(CUNIT_CTX_CURR, (__l), (__r), (__cond), STR_NULL __VA_ARGS__)
-#define ___cunit_check_int16_compare(__l, __r, __cond, ...) __cunit_compare_int16(CUNIT_CTX_CURR, (__l), (__r), (__cond), STR_NULL __VA_ARGS__)
-#define ___cunit_check_int32_compare(__l, __r, __cond, ...) __cunit_compare_int32(CUNIT_CTX_CURR, (__l), (__r), (__cond), STR_NULL __VA_ARGS__)
-#define ___cunit_check_int64_compare(__l, __r, __cond, ...) __cunit_compare_int64(CUNIT_CTX_CURR, (__l), (__r), (__cond), STR_NULL __VA_ARGS__)
+#define ___cunit_check_int8_compare(__l, __r, __cond, ...)  ___cunit_check_fast(__cunit_compare_int8_fast, __l, __r, __cond, __VA_ARGS__)
+#define ___cunit_check_int16_compare(__l, __r, __cond, ...) ___cunit_check_fast(__cunit_compare_int16_fast, __l, __r, __cond, __VA_ARGS__)
+#define ___cunit_check_int32_compare(__l, __r, __cond, ...) ___cunit_check_fast(__cunit_compare_int32_fast, __l, __r, __cond, __VA_ARGS__)
+#define ___cunit_check_int64_compare(__l, __r, __cond, ...) ___cunit_check_fast(__cunit_compare_int64_fast, __l, __r, __cond, __VA_ARGS__)
 
-#define ___cunit_check_uint8_compare(__l, __r, __cond, ...)  __cunit_compare_uint8(CUNIT_CTX_CURR, (__l), (__r), (__cond), STR_NULL __VA_ARGS__)
-#define ___cunit_check_uint16_compare(__l, __r, __cond, ...) __cunit_compare_uint16(CUNIT_CTX_CURR, (__l), (__r), (__cond), STR_NULL __VA_ARGS__)
-#define ___cunit_check_uint32_compare(__l, __r, __cond, ...) __cunit_compare_uint32(CUNIT_CTX_CURR, (__l), (__r), (__cond), STR_NULL __VA_ARGS__)
-#define ___cunit_check_uint64_compare(__l, __r, __cond, ...) __cunit_compare_uint64(CUNIT_CTX_CURR, (__l), (__r), (__cond), STR_NULL __VA_ARGS__)
+#define ___cunit_check_uint8_compare(__l, __r, __cond, ...)  ___cunit_check_fast(__cunit_compare_uint8_fast, __l, __r, __cond, __VA_ARGS__)
+#define ___cunit_check_uint16_compare(__l, __r, __cond, ...) ___cunit_check_fast(__cunit_compare_uint16_fast, __l, __r, __cond, __VA_ARGS__)
+#define ___cunit_check_uint32_compare(__l, __r, __cond, ...) ___cunit_check_fast(__cunit_compare_uint32_fast, __l, __r, __cond, __VA_ARGS__)
+#define ___cunit_check_uint64_compare(__l, __r, __cond, ...) ___cunit_check_fast(__cunit_compare_uint64_fast, __l, __r, __cond, __VA_ARGS__)
 
 #define check_bool(__l, __r, ...) ___cunit_check_bool_compare(__l, __r, __VA_ARGS__)
 #define check_true(__v, ...)      ___cunit_check_bool_compare(__v, true, __VA_ARGS__)
@@ -82,6 +91,39 @@ extern "C" {
 #define assert_str_case(__l, __r, ...)     ___cunit_assert_check_2(check_str_case, __l, __r, __VA_ARGS__)
 #define assert_str_hex(__l, __r, __n, ...) ___cunit_assert_check_3(check_str_hex, __l, __r, __n, __VA_ARGS__)
 
+// Yields an array argument as a pointer to its element type, and warns if it points to another type.
+#define ___cunit_array_of(__type, __p) (1 ? (__p) : (const __type *)0)
+
+#define ___cunit_check_array_eq(__type, __t, __l, __r, __n, ...) \
+	__cunit_check_array_eq(CUNIT_CTX_CURR, ___cunit_array_of(__type, __l), ___cunit_array_of(__type, __r), (size_t)(__n), __t, STR_NULL __VA_ARGS__)
+
+#define check_array_eq_i8(__l, __r, __n, ...)  ___cunit_check_array_eq(int8_t, CUnitType_Int8, __l, __r, __n, __VA_ARGS__)
+#define check_array_eq_i16(__l, __r, __n, ...) ___cunit_check_array_eq(int16_t, CUnitType_Int16, __l, __r, __n, __VA_ARGS__)
+#define check_array_eq_i32(__l, __r, __n, ...) ___cunit_check_array_eq(int32_t, CUnitType_Int32, __l, __r, __n, __VA_ARGS__)
+#define check_array_eq_i64(__l, __r, __n, ...) ___cunit_check_array_eq(int64_t, CUnitType_Int64, __l, __r, __n, __VA_ARGS__)
+#define check_array_eq_u8(__l, __r, __n, ...)  ___cunit_check_array_eq(uint8_t, CUnitType_Uint8, __l, __r, __n, __VA_ARGS__)
+#define check_array_eq_u16(__l, __r, __n, ...) ___cunit_check_array_eq(uint16_t, CUnitType_Uint16, __l, __r, __n, __VA_ARGS__)
+#define check_array_eq_u32(__l, __r, __n, ...) ___cunit_check_array_eq(uint32_t, CUnitType_Uint32, __l, __r, __n, __VA_ARGS__)
+#define check_array_eq_u64(__l, __r, __n, ...) ___cunit_check_array_eq(uint64_t, CUnitType_Uint64, __l, __r, __n, __VA_ARGS__)
+#define check_mem_eq(__l, __r, __size, ...)    __cunit_check_mem_eq(CUNIT_CTX_CURR, (const void *)(__l), (const void *)(__r), (size_t)(__size), STR_NULL __VA_ARGS__)
+
+#define assert_array_eq_i8(__l, __r, __n, ...)  ___cunit_assert_check_3(check_array_eq_i8, __l, __r, __n, __VA_ARGS__)
+#define assert_array_eq_i16(__l, __r, __n, ...) ___cunit_assert_check_3(check_array_eq_i16, __l, __r, __n, __VA_ARGS__)
+#define assert_array_eq_i32(__l, __r, __n, ...) ___cunit_assert_check_3(check_array_eq_i32, __l, __r, __n, __VA_ARGS__)
+#define assert_array_eq_i64(__l, __r, __n, ...) ___cunit_assert_check_3(check_array_eq_i64, __l, __r, __n, __VA_ARGS__)
+#define assert_array_eq_u8(__l, __r, __n, ...)  ___cunit_assert_check_3(check_array_eq_u8, __l, __r, __n, __VA_ARGS__)
+#define assert_array_eq_u16(__l, __r, __n, ...) ___cunit_assert_check_3(check_array_eq_u16, __l, __r, __n, __VA_ARGS__)
+#define assert_array_eq_u32(__l, __r, __n, ...) ___cunit_assert_check_3(check_array_eq_u32, __l, __r, __n, __VA_ARGS__)
+#define assert_array_eq_u64(__l, __r, __n, ...) ___cunit_assert_check_3(check_array_eq_u64, __l, __r, __n, __VA_ARGS__)
+#define assert_mem_eq(__l, __r, __size, ...)    ___cunit_assert_check_3(check_mem_eq, __l, __r, __size, __VA_ARGS__)
+
+#define check_matches_golden(__data, __size, __path, ...) \
+	__cunit_check_matches_golden(CUNIT_CTX_CURR, (const void *)(__data), (size_t)(__size), (const char *)(__path), STR_NULL __VA_ARGS__)
+#define check_file_eq(__l, __r, ...) __cunit_check_file_eq(CUNIT_CTX_CURR, (const char *)(__l), (const char *)(__r), STR_NULL __VA_ARGS__)
+
+#define assert_matches_golden(__data, __size, __path, ...) ___cunit_assert_check_3(check_matches_golden, __data, __size, __path, __VA_ARGS__)
+#define assert_file_eq(__l, __r, ...)                      ___cunit_assert_check_2(check_file_eq, __l, __r, __VA_ARGS__)
+
 #define check_ptr_eq(__l, __r, ...) ___cunit_check_ptr_compare(__l, __r, CUnit_Equal, __VA_ARGS__)
 #define check_ptr_ne(__l, __r, ...) ___cunit_check_ptr_compare(__l, __r, CUnit_NotEqual, __VA_ARGS__)
 
@@ -150,6 +192,15 @@ extern "C" {
 #define assert_float64_gt assert_double_gt
 #define assert_float64_ge assert_double_ge
 
+// Elements within a tolerance of each other, such as cunit_ulps(4), cunit_rel(1e-6) or cunit_abs(1e-9).
+#define check_float_array_near(__l, __r, __n, __tolerance, ...) \
+	__cunit_check_float_array_near(CUNIT_CTX_CURR, ___cunit_array_of(float, __l), ___cunit_array_of(float, __r), (size_t)(__n), (__tolerance), STR_NULL __VA_ARGS__)
+#define check_double_array_near(__l, __r, __n, __tolerance, ...) \
+	__cunit_check_double_array_near(CUNIT_CTX_CURR, ___cunit_array_of(double, __l), ___cunit_array_of(double, __r), (size_t)(__n), (__tolerance), STR_NULL __VA_ARGS__)
+
+#define assert_float_array_near(__l, __r, __n, __tolerance, ...)  ___cunit_assert_check_4(check_float_array_near, __l, __r, __n, __tolerance, __VA_ARGS__)
+#define assert_double_array_near(__l, __r, __n, __tolerance, ...) ___cunit_assert_check_4(check_double_array_near, __l, __r, __n, __tolerance, __VA_ARGS__)
+
 #define check_int_eq(__l, __r, ...) ___cunit_check_int32_compare(__l, __r, CUnit_Equal, __VA_ARGS__)
 #define check_int_ne(__l, __r, ...) ___cunit_check_int32_compare(__l, __r, CUnit_NotEqual, __VA_ARGS__)
 #define check_int_lt(__l, __r, ...) ___cunit_check_int32_compare(__l, __r, CUnit_Less, __VA_ARGS__)
@@ -0,0 +1,175 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 tayne3
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ * 2. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *    SOFTWARE.
+ */
+#ifndef CUNIT_BENCH_H
+#define CUNIT_BENCH_H
+
+#include "suite.h"
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ========================================================================== */
+/*                              TYPE DEFINITIONS                              */
+/* ========================================================================== */
+
+/**
+ * @brief Function pointer type for benchmarks; called once per iteration
+ */
+typedef void (*cunit_bench_func_t)(void);
+
+/**
+ * @brief Statistics of a benchmark run, in nanoseconds per iteration
+ */
+typedef struct {
+	uint64_t iterations;  /**< Iterations per repetition, as calibrated */
+	int      repetitions; /**< Number of timed repetitions */
+	double   min;         /**< Fastest repetition */
+	double   median;      /**< Median repetition */
+	double   mean;        /**< Mean of the repetitions */
+	double   stddev;      /**< Sample standard deviation of the repetitions */
+	double   mad;         /**< Median absolute deviation from the median */
+} cunit_bench_stats_t;
+
+/* ========================================================================== */
+/*                               BENCHMARK API                                */
+/* ========================================================================== */
+
+/**
+ * @brief Add a benchmark to the current suite
+ * @param name Benchmark name (must not be NULL)
+ * @param bench_func Function to measure, called once per iteration (must not be NULL)
+ * @note A benchmark is a test: it is selected, sharded and reported like one, and fails
+ *       if an assertion inside it fails. Benchmarks always run one at a time on the main
+ *       thread, after any tests run in parallel, so that they do not disturb each other.
+ */
+void cunit_bench(const char *name, cunit_bench_func_t bench_func);
+
+/**
+ * @brief Set the time each benchmark repetition should take
+ * @param seconds Target time per repetition (default 0.01 s)
+ * @note Can also be set with the CUNIT_BENCH_TIME environment variable.
+ *       The iteration count is calibrated until one repetition takes at least this long.
+ */
+void cunit_set_bench_time(double seconds);
+
+/**
+ * @brief Set the number of timed repetitions of each benchmark
+ * @param repetitions Number of repetitions (default 10, at most 1000)
+ * @note Can also be set with the CUNIT_BENCH_REPETITIONS environment variable.
+ */
+void cunit_set_bench_repetitions(int repetitions);
+
+/**
+ * @brief Get the statistics of a benchmark from the last run
+ * @param suite_name Name of the suite
+ * @param bench_name Name of the benchmark
+ * @param stats Receives the statistics (must not be NULL)
+ * @return true if the benchmark exists and completed its measurement, false otherwise
+ * @note Results are available until cunit_cleanup(), i.e. after cunit_run_suite() but not after cunit_run().
+ */
+bool cunit_bench_stats(const char *suite_name, const char *bench_name, cunit_bench_stats_t *stats);
+
+/**
+ * @brief Set the file that holds the benchmark baseline
+ * @param path Path of the baseline file (NULL disables it); the string must outlive the run
+ * @note Can also be set with the CUNIT_BENCH_BASELINE environment variable.
+ *       Benchmarks found in the file are compared against it (see cunit_set_bench_threshold());
+ *       benchmarks missing from it are added after the run. Existing entries are only replaced
+ *       in update mode (see cunit_set_bench_update()).
+ */
+void cunit_set_bench_baseline(const char *path);
+
+/**
+ * @brief Enable or disable baseline update mode
+ * @param update true to record every benchmark that completes instead of comparing
+ * @note Can also be enabled with the CUNIT_BENCH_UPDATE=1 environment variable.
+ */
+void cunit_set_bench_update(bool update);
+
+/**
+ * @brief Set when a benchmark counts as regressed against its baseline
+ * @param percent How much slower than the baseline median the median may be (default 10)
+ * @param sigmas How many robust standard deviations (1.4826 x MAD of both runs combined)
+ *               the slowdown must also exceed, so that noise alone does not fail (default 3, 0 = off)
+ * @note Can also be set with the CUNIT_BENCH_THRESHOLD and CUNIT_BENCH_SIGMAS environment variables.
+ *       A regressed benchmark fails like a test whose assertion failed.
+ */
+void cunit_set_bench_threshold(double percent, double sigmas);
+
+/**
+ * @brief Add a benchmark to the current suite block
+ * @param name Benchmark name
+ * @param func Benchmark function
+ */
+#define CUNIT_BENCH(name, func) cunit_bench(name, func);
+
+/* ========================================================================== */
+/*                              OPTIMIZER BARRIERS                            */
+/* ========================================================================== */
+
+/**
+ * @fn void cunit_clobber_memory(void)
+ * @brief Make the compiler assume that all memory may have been read and written
+ * @note Use it to keep stores made by a benchmark from being removed or moved out of the loop.
+ */
+
+// clang-format off
+# if defined(__GNUC__) || defined(__clang__)
+static inline void __cunit_do_not_optimize(const void *p) { __asm__ __volatile__("" : : "r"(p) : "memory"); }
+static inline void cunit_clobber_memory(void) { __asm__ __volatile__("" : : : "memory"); }
+# else
+// An opaque call: the compiler must assume it reads `p` and everything reachable from it.
+void __cunit_bench_escape(const void *p);
+static inline void __cunit_do_not_optimize(const void *p) { __cunit_bench_escape(p); }
+#   if defined(_MSC_VER)
+static inline void cunit_clobber_memory(void) { _ReadWriteBarrier(); }
+#   else
+static inline void cunit_clobber_memory(void) { __cunit_bench_escape(NULL); }
+#   endif
+# endif
+// clang-format on
+
+/**
+ * @brief Keep the compiler from optimizing away a value computed by a benchmark
+ * @param value An lvalue holding the result; it is treated as read and possibly modified
+ * @example
+ * @code
+ * static void bench_strlen(void) {
+ *     size_t length = strlen(text);
+ *     cunit_do_not_optimize(length);
+ * }
+ * @endcode
+ */
+#define cunit_do_not_optimize(value) __cunit_do_not_optimize((const void *)&(value))
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CUNIT_BENCH_H */
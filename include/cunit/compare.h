@@ -39,8 +39,29 @@ extern "C" {
 #define CUnit_GreaterEqual 0x05
 #define CUnit_NotEqual     0x06
 
-void cunit__handle_pass(const cunit_context_t ctx);
-void cunit__handle_fail(const cunit_context_t ctx);
+// Orders two numbers: -1, 0 or 1.
+#define CUNIT_NUMBER_COMPARE(l, r) (((l) > (r)) - ((l) < (r)))
+
+// Orders two floating-point numbers, taking those within `epsilon` of each other as equal
+// and NaN as equal to NaN and less than any number.
+#define CUNIT_FLOAT_COMPARE(l, r, epsilon) \
+	((l) != (l) ? (r) != (r) ? 0 : -1 : (r) != (r) ? 1 : ((l) - (r) <= (epsilon) && (r) - (l) <= (epsilon)) ? 0 : CUNIT_NUMBER_COMPARE(l, r))
+
+// Whether the order of two values (see CUNIT_NUMBER_COMPARE()) satisfies a comparison flag.
+#define CUNIT_ORDER_SATISFIES(result, cond) (((cond) & ((result) < 0 ? CUnit_Less : (result) > 0 ? CUnit_Greater : CUnit_Equal)) != 0)
+
+// Counts a check or assertion made by the calling thread. A plain thread-local
+// increment, except on Windows, where a DLL cannot share thread-local data.
+extern CUNIT_THREAD_LOCAL uint64_t __cunit_assertions;
+#ifdef _WIN32
+void __cunit_assertion_count(void);
+#define __cunit_count_assertion() __cunit_assertion_count()
+#else
+#define __cunit_count_assertion() ((void)++__cunit_assertions)
+#endif
+
+void              cunit__handle_pass(const cunit_context_t ctx);
+__cunit_cold void cunit__handle_fail(const cunit_context_t ctx);
 
 void __cunit_value_print(const cunit_value_t *self);
 int  __cunit_value_compare(const cunit_value_t *l, const cunit_value_t *r);
@@ -58,6 +79,54 @@ bool __cunit_check_str_n(const cunit_context_t ctx, const char *l, const char *r
 bool __cunit_check_str_case(const cunit_context_t ctx, const char *l, const char *r, const char *format, ...);
 bool __cunit_check_str_hex(const cunit_context_t ctx, const uint8_t *l, const uint8_t *r, size_t size, const char *format, ...);
 
+// Compares two arrays of `count` integers of the given type, or two blocks of `size` bytes,
+// and describes the first mismatch with the elements around it.
+bool __cunit_check_array_eq(const cunit_context_t ctx, const void *l, const void *r, size_t count, enum cunit_type type, const char *format, ...);
+bool __cunit_check_mem_eq(const cunit_context_t ctx, const void *l, const void *r, size_t size, const char *format, ...);
+
+// Compares data with a golden file, or two files, mapping the files rather than reading them,
+// and describes the first difference with the bytes around it.
+bool __cunit_check_matches_golden(const cunit_context_t ctx, const void *data, size_t size, const char *path, const char *format, ...);
+bool __cunit_check_file_eq(const cunit_context_t ctx, const char *l, const char *r, const char *format, ...);
+
+/**
+ * @brief How far apart two floating-point numbers may be and still be taken as equal
+ */
+typedef enum {
+	CUNIT_TOLERANCE_ULPS = 0, /**< At most this many representable values apart */
+	CUNIT_TOLERANCE_REL,      /**< Differ by at most this fraction of the larger magnitude */
+	CUNIT_TOLERANCE_ABS,      /**< Differ by at most this much */
+} cunit_tolerance_kind_t;
+
+/**
+ * @brief A tolerance for check_float_array_near() and check_double_array_near()
+ *
+ * Two NaNs are within any tolerance, and a NaN and a number within none.
+ */
+typedef struct cunit_tolerance {
+	cunit_tolerance_kind_t kind;   /**< How value is measured */
+	double                 value;  /**< The largest distance taken as equal */
+} cunit_tolerance_t;
+
+// Tolerances of at most `ulps` representable values, a `fraction` of the larger magnitude, or a `difference`.
+static inline cunit_tolerance_t cunit_ulps(uint64_t ulps) {
+	cunit_tolerance_t tolerance = {CUNIT_TOLERANCE_ULPS, (double)ulps};
+	return tolerance;
+}
+static inline cunit_tolerance_t cunit_rel(double fraction) {
+	cunit_tolerance_t tolerance = {CUNIT_TOLERANCE_REL, fraction};
+	return tolerance;
+}
+static inline cunit_tolerance_t cunit_abs(double difference) {
+	cunit_tolerance_t tolerance = {CUNIT_TOLERANCE_ABS, difference};
+	return tolerance;
+}
+
+// Compares two arrays of `count` floating-point numbers element by element within a tolerance,
+// and describes how many differ and which differs the most.
+bool __cunit_check_float_array_near(const cunit_context_t ctx, const float *l, const float *r, size_t count, cunit_tolerance_t tolerance, const char *format, ...);
+bool __cunit_check_double_array_near(const cunit_context_t ctx, const double *l, const double *r, size_t count, cunit_tolerance_t tolerance, const char *format, ...);
+
 bool __cunit_compare_int(const cunit_context_t ctx, int l, int r, int cond, const char *format, ...);
 bool __cunit_compare_int8(const cunit_context_t ctx, int8_t l, int8_t r, int cond, const char *format, ...);
 bool __cunit_compare_int16(const cunit_context_t ctx, int16_t l, int16_t r, int cond, const char *format, ...);
@@ -69,6 +138,69 @@ bool __cunit_compare_uint16(const cunit_context_t ctx, uint16_t l, uint16_t r, i
 bool __cunit_compare_uint32(const cunit_context_t ctx, uint32_t l, uint32_t r, int cond, const char *format, ...);
 bool __cunit_compare_uint64(const cunit_context_t ctx, uint64_t l, uint64_t r, int cond, const char *format, ...);
 
+// The failure path of the inline comparisons below: keeps the operands of a failed
+// comparison on the calling thread and returns false, so that __cunit_compare_report()
+// can describe it without the operands being evaluated again.
+__cunit_cold bool __cunit_compare_failed_int(int64_t l, int64_t r, int result, enum cunit_type type);
+__cunit_cold bool __cunit_compare_failed_uint(uint64_t l, uint64_t r, int result, enum cunit_type type);
+__cunit_cold bool __cunit_compare_failed_float(double l, double r, int result, enum cunit_type type);
+__cunit_cold bool __cunit_compare_failed_ptr(const void *l, const void *r, int result);
+__cunit_cold bool __cunit_compare_report(const cunit_context_t ctx, const char *format, ...);
+
+// Compares scalars in the caller, so that a passing check costs no call.
+static inline bool __cunit_compare_bool_fast(bool l, bool r, int cond) {
+	const int result = CUNIT_NUMBER_COMPARE(l, r);
+	return __cunit_likely(CUNIT_ORDER_SATISFIES(result, cond)) || __cunit_compare_failed_int(l, r, result, CUnitType_Bool);
+}
+static inline bool __cunit_compare_char_fast(char l, char r, int cond) {
+	const int result = CUNIT_NUMBER_COMPARE(l, r);
+	return __cunit_likely(CUNIT_ORDER_SATISFIES(result, cond)) || __cunit_compare_failed_int(l, r, result, CUnitType_Char);
+}
+static inline bool __cunit_compare_int8_fast(int8_t l, int8_t r, int cond) {
+	const int result = CUNIT_NUMBER_COMPARE(l, r);
+	return __cunit_likely(CUNIT_ORDER_SATISFIES(result, cond)) || __cunit_compare_failed_int(l, r, result, CUnitType_Int8);
+}
+static inline bool __cunit_compare_int16_fast(int16_t l, int16_t r, int cond) {
+	const int result = CUNIT_NUMBER_COMPARE(l, r);
+	return __cunit_likely(CUNIT_ORDER_SATISFIES(result, cond)) || __cunit_compare_failed_int(l, r, result, CUnitType_Int16);
+}
+static inline bool __cunit_compare_int32_fast(int32_t l, int32_t r, int cond) {
+	const int result = CUNIT_NUMBER_COMPARE(l, r);
+	return __cunit_likely(CUNIT_ORDER_SATISFIES(result, cond)) || __cunit_compare_failed_int(l, r, result, CUnitType_Int32);
+}
+static inline bool __cunit_compare_int64_fast(int64_t l, int64_t r, int cond) {
+	const int result = CUNIT_NUMBER_COMPARE(l, r);
+	return __cunit_likely(CUNIT_ORDER_SATISFIES(result, cond)) || __cunit_compare_failed_int(l, r, result, CUnitType_Int64);
+}
+static inline bool __cunit_compare_uint8_fast(uint8_t l, uint8_t r, int cond) {
+	const int result = CUNIT_NUMBER_COMPARE(l, r);
+	return __cunit_likely(CUNIT_ORDER_SATISFIES(result, cond)) || __cunit_compare_failed_uint(l, r, result, CUnitType_Uint8);
+}
+static inline bool __cunit_compare_uint16_fast(uint16_t l, uint16_t r, int cond) {
+	const int result = CUNIT_NUMBER_COMPARE(l, r);
+	return __cunit_likely(CUNIT_ORDER_SATISFIES(result, cond)) || __cunit_compare_failed_uint(l, r, result, CUnitType_Uint16);
+}
+static inline bool __cunit_compare_uint32_fast(uint32_t l, uint32_t r, int cond) {
+	const int result = CUNIT_NUMBER_COMPARE(l, r);
+	return __cunit_likely(CUNIT_ORDER_SATISFIES(result, cond)) || __cunit_compare_failed_uint(l, r, result, CUnitType_Uint32);
+}
+static inline bool __cunit_compare_uint64_fast(uint64_t l, uint64_t r, int cond) {
+	const int result = CUNIT_NUMBER_COMPARE(l, r);
+	return __cunit_likely(CUNIT_ORDER_SATISFIES(result, cond)) || __cunit_compare_failed_uint(l, r, result, CUnitType_Uint64);
+}
+static inline bool __cunit_compare_float_fast(float l, float r, int cond) {
+	const int result = CUNIT_FLOAT_COMPARE(l, r, FLT_EPSILON);
+	return __cunit_likely(CUNIT_ORDER_SATISFIES(result, cond)) || __cunit_compare_failed_float(l, r, result, CUnitType_Float32);
+}
+static inline bool __cunit_compare_double_fast(double l, double r, int cond) {
+	const int result = CUNIT_FLOAT_COMPARE(l, r, DBL_EPSILON);
+	return __cunit_likely(CUNIT_ORDER_SATISFIES(result, cond)) || __cunit_compare_failed_float(l, r, result, CUnitType_Float64);
+}
+static inline bool __cunit_compare_ptr_fast(const void *l, const void *r, int cond) {
+	const int result = CUNIT_NUMBER_COMPARE(l, r);
+	return __cunit_likely(CUNIT_ORDER_SATISFIES(result, cond)) || __cunit_compare_failed_ptr(l, r, result);
+}
+
 bool __cunit_check_any_in_array(const cunit_context_t ctx, const cunit_value_t value, const void *array, size_t size, const char *format, ...);
 bool __cunit_check_any_not_in_array(const cunit_context_t ctx, const cunit_value_t value, const void *array, size_t size, const char *format, ...);
 
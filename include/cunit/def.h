@@ -101,6 +101,27 @@
 #	define __cunit_line__      0
 # endif
 
+// branch hints for the inline fast paths
+# if defined(__GNUC__) || defined(__clang__)
+#   define __cunit_cold         __attribute__((cold, noinline))
+#   define __cunit_likely(_x)   __builtin_expect(!!(_x), 1)
+# elif defined(_MSC_VER)
+#   define __cunit_cold         __declspec(noinline)
+#   define __cunit_likely(_x)   (_x)
+# else
+#   define __cunit_cold
+#   define __cunit_likely(_x)   (_x)
+# endif
+
+// thread-local storage
+# if defined(_MSC_VER)
+#   define CUNIT_THREAD_LOCAL   __declspec(thread)
+# elif defined(__GNUC__) || defined(__clang__) || defined(__TINYC__)
+#   define CUNIT_THREAD_LOCAL   __thread
+# else
+#   define CUNIT_THREAD_LOCAL   _Thread_local
+# endif
+
 // clang-format on
 
 #endif  // CUNIT_DEF_H
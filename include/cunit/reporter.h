@@ -0,0 +1,197 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 tayne3
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ * 2. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *    SOFTWARE.
+ */
+#ifndef CUNIT_REPORTER_H
+#define CUNIT_REPORTER_H
+
+#include "alloc.h"
+#include "bench.h"
+#include "ctx.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ========================================================================== */
+/*                              TYPE DEFINITIONS                              */
+/* ========================================================================== */
+
+/**
+ * @brief The outcome of a test
+ */
+typedef enum {
+	CUNIT_STATUS_PASSED = 0, /**< The test passed */
+	CUNIT_STATUS_FAILED,     /**< An assertion failed */
+	CUNIT_STATUS_CRASHED,    /**< The process running the test died (fork mode only) */
+	CUNIT_STATUS_TIMEOUT,    /**< The test ran past its timeout (see cunit_set_timeout()) */
+} cunit_status_t;
+
+/**
+ * @brief A failed check or assertion
+ */
+typedef struct {
+	cunit_context_t ctx;     /**< Where the check was made; the file is NULL for a benchmark that regressed */
+	const char     *message; /**< What was not as expected (e.g. "1 != 2"), or NULL */
+	const char     *note;    /**< The message passed to the check, or NULL */
+	bool            fatal;   /**< false for a failed check, true when the failure ends the test */
+} cunit_failure_t;
+
+/**
+ * @brief A finished test
+ */
+typedef struct {
+	const char                *suite;      /**< Name of the suite */
+	const char                *name;       /**< Name of the test */
+	cunit_status_t             status;     /**< Outcome of the test */
+	int                        signal;     /**< Signal that killed the worker, if it crashed */
+	int                        exit_code;  /**< Exit code of the worker, if it exited mid-test */
+	uint64_t                   assertions; /**< Number of checks and assertions made, setup and teardown included */
+	const cunit_timing_t      *timing;     /**< Time spent in the test */
+	const cunit_bench_stats_t *bench;      /**< Measurement of a benchmark, or NULL */
+	const cunit_alloc_stats_t *alloc;      /**< Heap use of the test, or NULL if allocations are not tracked */
+	const cunit_counters_t    *counters;   /**< Hardware counters of the test body, or NULL if not measured */
+} cunit_test_report_t;
+
+/**
+ * @brief A finished suite
+ */
+typedef struct {
+	const char           *name;       /**< Name of the suite */
+	int                   passed;     /**< Number of tests that passed */
+	int                   failed;     /**< Number of tests that failed */
+	int                   total;      /**< Number of tests that ran */
+	uint64_t              assertions; /**< Number of checks and assertions its tests made */
+	const cunit_timing_t *timing;     /**< Summed time of its tests */
+} cunit_suite_report_t;
+
+/**
+ * @brief A finished run
+ */
+typedef struct {
+	int                        passed;        /**< Number of tests that passed */
+	int                        failed;        /**< Number of tests that failed */
+	int                        total;         /**< Number of tests that ran */
+	uint64_t                   assertions;    /**< Number of checks and assertions the tests made */
+	double                     duration;      /**< Summed wall-clock time of the tests, in seconds */
+	const cunit_test_report_t *slowest;       /**< The slowest tests, slowest first (see cunit_set_slowest()) */
+	int                        slowest_count; /**< Number of entries in `slowest` */
+	int                        unisolated;    /**< Number of tests that ran in-process in fork mode, since no worker could be started */
+} cunit_run_report_t;
+
+/**
+ * @brief A set of callbacks that receive test events
+ *
+ * Every callback is optional. Events arrive on the thread that called cunit_run(), in
+ * registration order, also when tests run in parallel: test_begin, any failures and
+ * test_end are then delivered together once the test has finished. All pointers are
+ * only valid during the call.
+ */
+typedef struct cunit_reporter {
+	void *data;                                                          /**< Passed as the first argument of every callback */
+	void (*run_begin)(void *data, int total);                            /**< Before the first suite of cunit_run() */
+	void (*suite_begin)(void *data, const char *suite);                  /**< Before the first test of a suite */
+	void (*test_begin)(void *data, const char *suite, const char *test); /**< Before a test runs */
+	void (*failure)(void *data, const cunit_failure_t *failure);         /**< A check or assertion failed */
+	void (*test_end)(void *data, const cunit_test_report_t *test);       /**< After a test ran */
+	void (*suite_end)(void *data, const cunit_suite_report_t *suite);    /**< After the last test of a suite */
+	void (*run_end)(void *data, const cunit_run_report_t *run);          /**< After the last suite of cunit_run() */
+	void (*flush)(void *data);                                           /**< Buffered output must be written out now */
+} cunit_reporter_t;
+
+/* ========================================================================== */
+/*                               REPORTER API                                 */
+/* ========================================================================== */
+
+/**
+ * @brief The maximum number of reporters installed at once
+ */
+#define CUNIT_MAX_REPORTERS 8
+
+/**
+ * @brief Get the default reporter, which prints colored text to stdout
+ * @return The console reporter
+ * @note It collects output in a large buffer and writes it out before test code runs on
+ *       the main thread, so output printed by the tests themselves stays in order.
+ */
+const cunit_reporter_t *cunit_console_reporter(void);
+
+/**
+ * @brief Get a reporter that writes JUnit XML to a file
+ * @param path Path of the output file; the string must outlive the run
+ * @return The JUnit reporter, for cunit_add_reporter() or cunit_set_reporter()
+ * @note Can also be enabled with the CUNIT_JUNIT_FILE environment variable.
+ *       Each test case is written when it finishes and the closing tags are written
+ *       again after it, so the file is a complete document even if the run dies.
+ */
+const cunit_reporter_t *cunit_junit_reporter(const char *path);
+
+/**
+ * @brief Get a reporter that writes one JSON object per line to a file
+ * @param path Path of the output file; the string must outlive the run
+ * @return The JSON Lines reporter, for cunit_add_reporter() or cunit_set_reporter()
+ * @note Can also be enabled with the CUNIT_JSON_FILE environment variable.
+ *       Every event is a line of its own ("run_begin", "suite_begin", "test",
+ *       "suite_end", "run_end"); a test line carries its status, timing and failures.
+ */
+const cunit_reporter_t *cunit_json_reporter(const char *path);
+
+/**
+ * @brief Get a reporter that appends compact binary records to a file
+ * @param path Path of the output file; the string must outlive the run
+ * @return The event log reporter, for cunit_add_reporter() or cunit_set_reporter()
+ * @note Can also be enabled with the CUNIT_EVENT_LOG environment variable.
+ *       Where possible the file is memory-mapped, so an event costs a few stores
+ *       and what was logged survives a crash of the run. Names are written once.
+ *       Use cunit_log_replay() or the cunit-log tool to turn a log into text,
+ *       JUnit XML or JSON Lines. A log is only meant to be read on the machine type
+ *       that wrote it.
+ */
+const cunit_reporter_t *cunit_log_reporter(const char *path);
+
+/**
+ * @brief Replay a binary event log into a reporter
+ * @param path Path of a file written by cunit_log_reporter()
+ * @param reporter The reporter receiving the events
+ * @return false if the file cannot be read or is not a compatible log
+ * @note A log cut short by a crash is replayed up to its last complete event.
+ */
+bool cunit_log_replay(const char *path, const cunit_reporter_t *reporter);
+
+/**
+ * @brief Replace all installed reporters with one
+ * @param reporter The reporter (NULL = no output); it must outlive the run
+ */
+void cunit_set_reporter(const cunit_reporter_t *reporter);
+
+/**
+ * @brief Install an additional reporter
+ * @param reporter The reporter; it must outlive the run
+ * @note Reporters are called in the order they were installed; at most CUNIT_MAX_REPORTERS.
+ */
+void cunit_add_reporter(const cunit_reporter_t *reporter);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CUNIT_REPORTER_H */
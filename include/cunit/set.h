@@ -0,0 +1,117 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 tayne3
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ * 2. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *    SOFTWARE.
+ */
+#ifndef CUNIT_SET_H
+#define CUNIT_SET_H
+
+#include "assert.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ========================================================================== */
+/*                              TYPE DEFINITIONS                              */
+/* ========================================================================== */
+
+/**
+ * @brief A set of values built once from an array, for checking many values against it
+ */
+typedef struct cunit_set cunit_set_t;
+
+/* ========================================================================== */
+/*                                  SET API                                   */
+/* ========================================================================== */
+
+/**
+ * @brief Build a set from the elements of an array
+ * @param type The type of the elements (CUnitType_Int32, CUnitType_String, ...)
+ * @param array The elements, of the C type that matches `type`
+ * @param count The number of elements
+ * @return The set, to be released with cunit_set_free(), or NULL on allocation failure
+ *         or if `type` is CUnitType_Invalid
+ * @note Integers, characters, booleans, pointers and strings are hashed, and strings are
+ *       copied. Floating-point numbers are sorted and searched within FLT_EPSILON or
+ *       DBL_EPSILON of each other, as check_in_array() compares them.
+ */
+cunit_set_t *cunit_set_new(enum cunit_type type, const void *array, size_t count);
+
+/**
+ * @brief Release a set
+ * @param set The set (may be NULL)
+ */
+void cunit_set_free(cunit_set_t *set);
+
+/**
+ * @brief Get the number of distinct values in a set
+ */
+size_t cunit_set_size(const cunit_set_t *set);
+
+/**
+ * @brief Check whether a set holds a value
+ * @param set The set
+ * @param value The value, of the type of the set's elements. Integers of any
+ *              width or signedness, characters and booleans compare by value, so
+ *              -1 is not in a set of uint64_t holding UINT64_MAX.
+ */
+bool cunit_set_contains(const cunit_set_t *set, cunit_value_t value);
+
+bool __cunit_check_in_set(const cunit_context_t ctx, const cunit_value_t value, const cunit_set_t *set, bool in, const char *format, ...);
+bool __cunit_check_all_in_set(const cunit_context_t ctx, const void *array, size_t count, const cunit_set_t *set, const char *format, ...);
+
+/**
+ * @brief Check that a value is, or is not, in a set
+ * @note Each check costs a hash lookup or a binary search, where check_in_array() scans the array.
+ * @example
+ * @code
+ * static cunit_set_t *allowed;
+ *
+ * static void setup(void) { allowed = cunit_set_new(CUnitType_Uint32, allow_list, allow_count); }
+ * static void teardown(void) { cunit_set_free(allowed); }
+ *
+ * static void test_ids(void) {
+ *     assert_in_set(CUNIT_VALUE_UINT32(lookup_id("alice")), allowed);
+ *     assert_all_in_set(ids, id_count, allowed);  // uint32_t ids[id_count]
+ * }
+ * @endcode
+ */
+#define check_in_set(__value, __set, ...)     __cunit_check_in_set(CUNIT_CTX_CURR, (__value), (__set), true, STR_NULL __VA_ARGS__)
+#define check_not_in_set(__value, __set, ...) __cunit_check_in_set(CUNIT_CTX_CURR, (__value), (__set), false, STR_NULL __VA_ARGS__)
+
+/**
+ * @brief Check that every element of an array is in a set
+ * @note The elements have the type the set was built from. A failure counts the elements
+ *       that are not in the set and shows the first of them.
+ */
+#define check_all_in_set(__array, __count, __set, ...) \
+	__cunit_check_all_in_set(CUNIT_CTX_CURR, (const void *)(__array), (size_t)(__count), (__set), STR_NULL __VA_ARGS__)
+
+#define assert_in_set(__value, __set, ...)               ___cunit_assert_check_2(check_in_set, __value, __set, __VA_ARGS__)
+#define assert_not_in_set(__value, __set, ...)           ___cunit_assert_check_2(check_not_in_set, __value, __set, __VA_ARGS__)
+#define assert_all_in_set(__array, __count, __set, ...) ___cunit_assert_check_3(check_all_in_set, __array, __count, __set, __VA_ARGS__)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CUNIT_SET_H */
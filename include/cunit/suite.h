@@ -60,6 +60,91 @@ typedef enum {
 	CUNIT_ERROR_MODE_FAIL_FAST,   /**< Stop on first error */
 } cunit_error_mode_t;
 
+/**
+ * @brief Execution modes for running tests
+ */
+typedef enum {
+	CUNIT_EXEC_MODE_THREAD = 0, /**< Run tests in-process, on cunit_set_jobs() threads (default) */
+	CUNIT_EXEC_MODE_FORK,       /**< Run tests in cunit_set_jobs() forked worker processes */
+} cunit_exec_mode_t;
+
+/**
+ * @brief How the tests that failed in the last run are treated
+ */
+typedef enum {
+	CUNIT_RERUN_ALL = 0,      /**< Run the tests in registration order (default) */
+	CUNIT_RERUN_FAILED_FIRST, /**< Run the tests that failed last time before the others */
+	CUNIT_RERUN_LAST_FAILED,  /**< Run only the tests that failed last time */
+} cunit_rerun_mode_t;
+
+/**
+ * @brief How a test that made no checks or assertions is treated
+ */
+typedef enum {
+	CUNIT_ZERO_ASSERTIONS_IGNORE = 0, /**< Report it like any other test */
+	CUNIT_ZERO_ASSERTIONS_WARN,       /**< Report it with a warning (default) */
+	CUNIT_ZERO_ASSERTIONS_FAIL,       /**< Fail it */
+} cunit_zero_assertions_t;
+
+/**
+ * @brief Time spent in one phase of a test, in seconds
+ */
+typedef struct {
+	double wall; /**< Monotonic wall-clock time */
+	double cpu;  /**< CPU time of the thread that ran the phase */
+} cunit_time_t;
+
+/**
+ * @brief Timing breakdown of a test, or the sum over the tests of a suite
+ */
+typedef struct {
+	cunit_time_t setup;    /**< Time spent in the suite's setup function */
+	cunit_time_t body;     /**< Time spent in the test function */
+	cunit_time_t teardown; /**< Time spent in the suite's teardown function */
+	cunit_time_t total;    /**< Sum of the three phases */
+} cunit_timing_t;
+
+/**
+ * @brief The hardware counters measured around a test body
+ */
+typedef enum {
+	CUNIT_COUNTER_CYCLES        = 1 << 0, /**< CPU cycles */
+	CUNIT_COUNTER_INSTRUCTIONS  = 1 << 1, /**< Instructions retired */
+	CUNIT_COUNTER_BRANCH_MISSES = 1 << 2, /**< Mispredicted branches */
+	CUNIT_COUNTER_CACHE_MISSES  = 1 << 3, /**< Last-level cache misses */
+} cunit_counter_t;
+
+/**
+ * @brief Hardware counters of a test body, in user space on the thread that ran it
+ * @note Counters the CPU had to share with other events are scaled up to the whole body.
+ */
+typedef struct {
+	uint64_t cycles;        /**< CPU cycles */
+	uint64_t instructions;  /**< Instructions retired */
+	uint64_t branch_misses; /**< Mispredicted branches */
+	uint64_t cache_misses;  /**< Last-level cache misses */
+	unsigned available;     /**< The counters that were measured, a mask of cunit_counter_t */
+} cunit_counters_t;
+
+/**
+ * @brief A test defined with CUNIT_TEST_AUTO()
+ */
+typedef struct {
+	const char       *suite; /**< Suite name */
+	const char       *name;  /**< Test name */
+	cunit_test_func_t func;  /**< Test function */
+	const char       *file;  /**< Source file of the definition */
+	int               line;  /**< Line of the definition */
+} cunit_auto_test_t;
+
+/**
+ * @brief A link in the list of CUNIT_TEST_AUTO() tests, on platforms without linker sections
+ */
+typedef struct cunit_auto_link {
+	const cunit_auto_test_t *test; /**< The test */
+	struct cunit_auto_link  *next; /**< The next test, in definition order */
+} cunit_auto_link_t;
+
 /* ========================================================================== */
 /*                               CORE API                                     */
 /* ========================================================================== */
@@ -92,6 +177,24 @@ void cunit_suite(const char *name, cunit_setup_func_t setup, cunit_teardown_func
  */
 void cunit_test(const char *name, cunit_test_func_t test_func);
 
+/**
+ * @brief Add a test with tags to the current suite
+ * @param name Test name (must not be NULL)
+ * @param test_func Test function pointer (must not be NULL)
+ * @param tags Tags separated by commas or spaces, e.g. "slow,io" (can be NULL); the string must outlive the run
+ * @note Tags are selected with "@tag" patterns, see cunit_set_filter().
+ */
+void cunit_test_tagged(const char *name, cunit_test_func_t test_func, const char *tags);
+
+/**
+ * @brief Add a test with its own timeout to the current suite
+ * @param name Test name (must not be NULL)
+ * @param test_func Test function pointer (must not be NULL)
+ * @param seconds Longest time the test may take, overriding cunit_set_timeout() (0 = the global timeout)
+ * @note A test interrupted in-process for running past its timeout does not run the suite teardown.
+ */
+void cunit_test_timeout(const char *name, cunit_test_func_t test_func, double seconds);
+
 /**
  * @brief Run all registered test suites
  * @return Number of failed tests (0 = all tests passed)
@@ -108,9 +211,171 @@ int cunit_run_suite(const char *suite_name);
 /**
  * @brief Set error handling mode
  * @param mode Error handling mode
+ * @note In fork mode, FAIL_FAST stops the run at the first test that does not pass: the tests
+ *       that finished are reported, the others are left out, and the run returns as usual.
+ *       Otherwise the process exits at the failure, once the failed test, its suite and the
+ *       run have been reported and the output files closed.
  */
 void cunit_set_error_mode(cunit_error_mode_t mode);
 
+/**
+ * @brief Set the number of worker threads used to run tests
+ * @param jobs Number of threads (1 = serial, 0 = one per CPU)
+ * @note Can also be set with the CUNIT_JOBS environment variable ("auto" = one per CPU).
+ *       Suites with setup/teardown functions run all their tests on one thread;
+ *       results are reported in registration order once all tests have finished.
+ */
+void cunit_set_jobs(int jobs);
+
+/**
+ * @brief Set the test execution mode
+ * @param mode Execution mode
+ * @note Can also be set with the CUNIT_EXEC_MODE environment variable ("thread" or "fork").
+ *       In fork mode a test that crashes or exits is reported as failed and its worker
+ *       is replaced. If no worker can be started, the tests left run in-process without crash
+ *       isolation, as the summary notes. Fork mode is only available on POSIX systems; elsewhere
+ *       tests run in-process.
+ */
+void cunit_set_exec_mode(cunit_exec_mode_t mode);
+
+/**
+ * @brief Run only one shard of the registered tests
+ * @param index Zero-based shard index (0 <= index < count)
+ * @param count Total number of shards (<= 1 disables sharding)
+ * @note Can also be set with the CUNIT_SHARD_INDEX and CUNIT_SHARD_COUNT environment variables.
+ *       Without timing history, tests are dealt round-robin in registration order. With a
+ *       timing file (see cunit_set_timing_file()), the longest tests are spread first so that
+ *       every shard gets about the same total duration. Each shard computes its part of the
+ *       split on its own, so all shards must be given the same file, with the same contents;
+ *       for that reason a sharded run reads the timing file but does not update it.
+ */
+void cunit_set_shard(int index, int count);
+
+/**
+ * @brief Run only the tests selected by a filter
+ * @param filter Patterns separated by ':' (NULL or "" runs every test); the string must outlive the run
+ * @note Can also be set with the CUNIT_FILTER environment variable.
+ *       "Suite/Test" matches a test and "Suite" a whole suite, where '*' matches any run of
+ *       characters and '?' any one. "@tag" matches tests with a tag, and "~regex" matches
+ *       "Suite/Test" against a POSIX extended regular expression (not available on Windows).
+ *       A leading '-' excludes the matching tests. A test runs if it matches any including
+ *       pattern (or there is none) and no excluding one, e.g. "Net*:@fast:-Net/Slow?".
+ *       Sharding applies to the selected tests only.
+ */
+void cunit_set_filter(const char *filter);
+
+/**
+ * @brief Set the file that records per-test durations
+ * @param path Path of the timing file (NULL disables it); the string must outlive the run
+ * @note Can also be set with the CUNIT_TIMING_FILE environment variable.
+ *       The file is read before the run and updated afterwards with the durations of the
+ *       tests that passed; entries for tests that did not run are kept. A sharded run only
+ *       reads it (see cunit_set_shard()); record it with a run that is not sharded. Parallel and forked
+ *       runs start the historically longest tests first; a test without history counts as
+ *       the longest one on record. Results are still reported in registration order.
+ */
+void cunit_set_timing_file(const char *path);
+
+/**
+ * @brief Set how many of the slowest tests are listed after the final summary
+ * @param count Number of tests to list (0 = no list, default 5)
+ * @note Can also be set with the CUNIT_SLOWEST environment variable.
+ */
+void cunit_set_slowest(int count);
+
+/**
+ * @brief Set the file that lists the tests that failed in the last run
+ * @param path Path of the file (NULL = ".cunit-failed" when a rerun mode is set); the string must outlive the run
+ * @note Can also be set with the CUNIT_FAILED_FILE environment variable.
+ *       The file is only kept when a path or a rerun mode is set. After each run, the tests
+ *       that ran are listed if they failed and dropped if they passed; entries for tests that
+ *       did not run are kept.
+ */
+void cunit_set_failed_file(const char *path);
+
+/**
+ * @brief Set how the tests that failed in the last run are treated
+ * @param mode Rerun mode
+ * @note Can also be set with the CUNIT_RERUN environment variable ("all", "failed-first" or
+ *       "last-failed"). With CUNIT_RERUN_FAILED_FIRST those tests, and the suites holding
+ *       them, run and are reported first. With CUNIT_RERUN_LAST_FAILED only they run, or
+ *       every test if none of them is registered. The filter and sharding still apply.
+ */
+void cunit_set_rerun_mode(cunit_rerun_mode_t mode);
+
+/**
+ * @brief Set the longest time any test may take
+ * @param seconds Timeout in seconds, for setup, test and teardown together (0 = no timeout, default)
+ * @note Can also be set with the CUNIT_TIMEOUT environment variable.
+ *       In fork mode a worker that runs past the timeout is killed, its test is reported as
+ *       timed out and the run goes on. In-process, a watchdog thread interrupts the test, which
+ *       is reported as timed out; the suite teardown does not run for it, since the state it
+ *       would clean up is unknown. The tests that have not started yet are left out, and the
+ *       run ends with the report of those that ran. A test that cannot be interrupted (or any
+ *       test on Windows), or a run that cannot be reported within a second after the last
+ *       test stopped, ends the process after a message on stderr.
+ */
+void cunit_set_timeout(double seconds);
+
+/**
+ * @brief Enable or disable hardware performance counters
+ * @param enable true to measure cycles, instructions, branch misses and cache misses around
+ *               each test body and benchmark (default false)
+ * @note Can also be enabled with the CUNIT_COUNTERS=1 environment variable.
+ *       The results show IPC and misses per thousand instructions next to each test, and are
+ *       passed to reporters. Counters come from perf_event_open() and only exist on Linux; when
+ *       the kernel refuses them (e.g. in a container, or with perf_event_paranoid set to 3) the
+ *       tests run without them.
+ */
+void cunit_set_counters(bool enable);
+
+/**
+ * @brief Set how a test that made no checks or assertions is treated
+ * @param mode CUNIT_ZERO_ASSERTIONS_WARN by default
+ * @note Can also be set with the CUNIT_ZERO_ASSERTIONS environment variable (ignore, warn or
+ *       fail). Checks made in the setup and teardown count for the test. Benchmarks, and tests
+ *       that crashed or timed out, are never warned about or failed for it.
+ */
+void cunit_set_zero_assertions(cunit_zero_assertions_t mode);
+
+/**
+ * @brief Set the context that check_str_hex() shows around each difference
+ * @param rows The rows of 16 bytes shown before and after each differing row (default 2)
+ * @note Can also be set with the CUNIT_HEX_CONTEXT environment variable. A failed check shows
+ *       the differing rows of both buffers as a hexdump, with their offsets; differences whose
+ *       context would touch are shown as one range.
+ */
+void cunit_set_hex_context(int rows);
+
+/**
+ * @brief Set how many ranges of differences check_str_hex() shows
+ * @param ranges The number of ranges from the first difference on, or 0 for all (default 1)
+ * @note Can also be set with the CUNIT_HEX_RANGES environment variable. The ranges left out
+ *       are not searched for: the hexdump ends with the offset at which the next one starts.
+ */
+void cunit_set_hex_ranges(int ranges);
+
+/**
+ * @brief Make check_matches_golden() write the golden files rather than compare with them
+ * @param enable true to rewrite each golden file that is missing or differs with the data
+ * @note Can also be set with CUNIT_UPDATE_GOLDEN=1. Each file is written next to the old one
+ *       and renamed over it, so that an interrupted run never leaves a partial golden file.
+ */
+void cunit_set_update_golden(bool enable);
+
+/**
+ * @brief Apply the cunit options given on the command line
+ * @param argc Argument count, as passed to main()
+ * @param argv Argument vector, as passed to main(); the strings must outlive the run
+ * @return The number of arguments left in argv
+ * @note Recognizes --failed-first, --last-failed, --rerun=MODE, --failed-file=PATH,
+ *       --filter=PATTERN, --timeout=SECONDS, --counters, --zero-assertions=MODE,
+ *       --hex-context=ROWS, --hex-ranges=N and --update-golden, and removes them from
+ *       argv so that the program can parse the rest.
+ *       Options given here take precedence over environment variables.
+ */
+int cunit_parse_args(int argc, char **argv);
+
 /* ========================================================================== */
 /*                              QUERY API                                     */
 /* ========================================================================== */
@@ -127,12 +392,56 @@ int cunit_test_count(void);
  */
 int cunit_failure_count(void);
 
+/**
+ * @brief Get the total number of checks and assertions made
+ * @return Number of checks and assertions made by the tests of the last run
+ */
+uint64_t cunit_assertion_count(void);
+
+/**
+ * @brief Get the number of checks and assertions a test made in the last run
+ * @param suite_name Name of the suite
+ * @param test_name Name of the test
+ * @param count Receives the number, setup and teardown included (must not be NULL)
+ * @return true if the test exists and ran, false otherwise
+ */
+bool cunit_test_assertions(const char *suite_name, const char *test_name, uint64_t *count);
+
 /**
  * @brief Get total number of registered suites
  * @return Total suite count
  */
 int cunit_suite_count(void);
 
+/**
+ * @brief Get the timing of a test from the last run
+ * @param suite_name Name of the suite
+ * @param test_name Name of the test
+ * @param timing Receives the timing breakdown (must not be NULL)
+ * @return true if the test exists and ran, false otherwise
+ * @note Results are available until cunit_cleanup(), i.e. after cunit_run_suite() but not after cunit_run().
+ *       A test that crashed in fork mode, or timed out, reports all of its time as body time, with no CPU time.
+ */
+bool cunit_test_timing(const char *suite_name, const char *test_name, cunit_timing_t *timing);
+
+/**
+ * @brief Get the hardware counters of a test from the last run
+ * @param suite_name Name of the suite
+ * @param test_name Name of the test
+ * @param counters Receives the counters (must not be NULL)
+ * @return true if the test exists, ran and at least one counter was measured, false otherwise
+ * @note Results are available until cunit_cleanup(); see cunit_set_counters().
+ */
+bool cunit_test_counters(const char *suite_name, const char *test_name, cunit_counters_t *counters);
+
+/**
+ * @brief Get the summed timing of the tests of a suite from the last run
+ * @param suite_name Name of the suite
+ * @param timing Receives the timing totals (must not be NULL)
+ * @return true if the suite exists, false otherwise
+ */
+bool cunit_suite_timing(const char *suite_name, cunit_timing_t *timing);
+
 /* ========================================================================== */
 /*                            STRUCTURED API                                  */
 /* ========================================================================== */
@@ -163,6 +472,22 @@ int cunit_suite_count(void);
  */
 #define CUNIT_TEST(name, func) cunit_test(name, func);
 
+/**
+ * @brief Add a test with tags to the current suite block
+ * @param name Test name
+ * @param func Test function
+ * @param tags Tags separated by commas or spaces
+ */
+#define CUNIT_TEST_TAGGED(name, func, tags) cunit_test_tagged(name, func, tags);
+
+/**
+ * @brief Add a test with its own timeout to the current suite block
+ * @param name Test name
+ * @param func Test function
+ * @param seconds Longest time the test may take
+ */
+#define CUNIT_TEST_TIMEOUT(name, func, seconds) cunit_test_timeout(name, func, seconds);
+
 /**
  * @brief End a test suite definition block
  * @note Must be paired with CUNIT_SUITE_BEGIN()
@@ -171,6 +496,79 @@ int cunit_suite_count(void);
 	}                     \
 	while (0);
 
+/* ========================================================================== */
+/*                          AUTO-REGISTRATION API                             */
+/* ========================================================================== */
+
+// Used by CUNIT_TEST_AUTO(); not part of the API.
+void cunit__auto_section(const cunit_auto_test_t *begin, const cunit_auto_test_t *end);
+void cunit__auto_link(cunit_auto_link_t *link);
+
+#if defined(__ELF__) && (defined(__GNUC__) || defined(__clang__))
+// The tests are const data in the "cunit_auto" section, whose bounds the linker
+// provides. One constructor per executable or shared object hands them over.
+extern const cunit_auto_test_t __start_cunit_auto[] __attribute__((weak, visibility("hidden")));
+extern const cunit_auto_test_t __stop_cunit_auto[] __attribute__((weak, visibility("hidden")));
+void cunit__auto_anchor(void) __attribute__((weak, visibility("hidden"), constructor));
+void cunit__auto_anchor(void) { cunit__auto_section(__start_cunit_auto, __stop_cunit_auto); }
+
+#define __cunit_auto_entry(suite, name)                                                                  \
+	__attribute__((used, section("cunit_auto"), aligned(sizeof(void *)))) static const cunit_auto_test_t \
+		cunit_auto_##suite##_##name = {#suite, #name, cunit_auto_func_##suite##_##name, __FILE__, __LINE__};
+#else
+#if defined(__cplusplus)
+#define __cunit_auto_init(suite, name) \
+	static const int cunit_auto_init_##suite##_##name = (cunit__auto_link(&cunit_auto_link_##suite##_##name), 0);
+#elif defined(__GNUC__) || defined(__clang__)
+#define __cunit_auto_init(suite, name) \
+	__attribute__((constructor)) static void cunit_auto_init_##suite##_##name(void) { cunit__auto_link(&cunit_auto_link_##suite##_##name); }
+#elif defined(_MSC_VER)
+#pragma section(".CRT$XCU", read)
+#ifdef _WIN64
+#define __cunit_auto_symbol ""
+#else
+#define __cunit_auto_symbol "_"
+#endif
+#define __cunit_auto_init(suite, name)                                                                                  \
+	static void cunit_auto_init_##suite##_##name(void) { cunit__auto_link(&cunit_auto_link_##suite##_##name); }         \
+	__declspec(allocate(".CRT$XCU")) void (*cunit_auto_ctor_##suite##_##name)(void) = cunit_auto_init_##suite##_##name; \
+	__pragma(comment(linker, "/include:" __cunit_auto_symbol "cunit_auto_ctor_" #suite "_" #name))
+#endif
+
+#ifdef __cunit_auto_init
+// Without linker sections, each test links itself into a list before main().
+#define __cunit_auto_entry(suite, name)                                                                                                      \
+	static const cunit_auto_test_t cunit_auto_##suite##_##name      = {#suite, #name, cunit_auto_func_##suite##_##name, __FILE__, __LINE__}; \
+	static cunit_auto_link_t       cunit_auto_link_##suite##_##name = {&cunit_auto_##suite##_##name, NULL};                                  \
+	__cunit_auto_init(suite, name)
+#endif
+#endif
+
+#ifdef __cunit_auto_entry
+/**
+ * @brief Define a test that registers itself
+ * @param suite Suite name, as an identifier
+ * @param name Test name, as an identifier
+ *
+ * @note The test joins the suite of that name, which is created if needed, when the
+ *       tests run; cunit_run() needs no other registration. With GCC or Clang on ELF
+ *       platforms the test is a const descriptor in a linker section and nothing runs
+ *       before main(); elsewhere a static constructor links it into a list.
+ * @example
+ * @code
+ * CUNIT_TEST_AUTO(Strings, Length) {
+ *     assert_int_eq(strlen("abc"), 3);
+ * }
+ *
+ * int main(void) { return cunit_run(); }
+ * @endcode
+ */
+#define CUNIT_TEST_AUTO(suite, name)                    \
+	static void cunit_auto_func_##suite##_##name(void); \
+	__cunit_auto_entry(suite, name)                     \
+	static void cunit_auto_func_##suite##_##name(void)
+#endif
+
 #ifdef __cplusplus
 }
 #endif
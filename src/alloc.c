@@ -0,0 +1,135 @@
+#include "registry.h"
+
+// A block allocated by the running test.
+typedef struct {
+	void  *ptr;   // The block, NULL for an empty slot or CUNIT_ALLOC_GONE for a freed one.
+	size_t size;  // The requested size of the block.
+} cunit_alloc_slot_t;
+
+// Marks a slot whose block was freed, so that lookups probe past it.
+#define CUNIT_ALLOC_GONE ((void *)1)
+
+// The initial number of slots of the table of live blocks.
+#define CUNIT_ALLOC_SLOTS 64
+
+// The per-thread state of allocation tracking.
+typedef struct {
+	bool                active;   // Whether a test runs on the thread.
+	bool                busy;     // Whether the tracker itself allocates, so that it is not tracked.
+	int                 suspend;  // The nesting of cunit__alloc_suspend().
+	uint64_t            live;     // The bytes allocated by the test and not freed yet.
+	cunit_alloc_stats_t stats;    // The counters of the running test.
+	cunit_alloc_slot_t *slots;    // The live blocks of the test by address, or NULL.
+	size_t              nslots;   // The size of `slots`, a power of two.
+	size_t              used;     // The number of slots that are not empty, freed ones included.
+} cunit_alloc_state_t;
+
+// Whether the program is linked with the allocation wrappers.
+static bool cunit__alloc_enabled = false;
+
+static CUNIT_THREAD_LOCAL cunit_alloc_state_t cunit__alloc;
+
+void cunit__alloc_enable(void) { cunit__alloc_enabled = true; }
+
+// Returns the first slot of a block in the table.
+static inline size_t cunit__alloc_hash(const void *ptr, size_t nslots) {
+	uint64_t hash = (uint64_t)(uintptr_t)ptr;
+	hash ^= hash >> 33;
+	hash *= 0xff51afd7ed558ccdull;
+	hash ^= hash >> 33;
+	return (size_t)hash & (nslots - 1);
+}
+
+// Adds a block to a table that has room for it.
+static void cunit__alloc_put(cunit_alloc_slot_t *slots, size_t nslots, void *ptr, size_t size) {
+	size_t at = cunit__alloc_hash(ptr, nslots);
+	while (slots[at].ptr && slots[at].ptr != CUNIT_ALLOC_GONE) { at = (at + 1) & (nslots - 1); }
+	slots[at].ptr  = ptr;
+	slots[at].size = size;
+}
+
+// Makes room for one more block, dropping the freed slots. Returns false if out of memory.
+static bool cunit__alloc_reserve(cunit_alloc_state_t *state) {
+	if ((state->used + 1) * 4 < state->nslots * 3) { return true; }
+	size_t nslots = state->nslots ? state->nslots : CUNIT_ALLOC_SLOTS;
+	while ((state->stats.unfreed_count + 1) * 2 >= nslots) { nslots *= 2; }
+
+	cunit_alloc_slot_t *slots = (cunit_alloc_slot_t *)calloc(nslots, sizeof(cunit_alloc_slot_t));
+	if (!slots) { return false; }
+	for (size_t i = 0; i < state->nslots; i++) {
+		if (state->slots[i].ptr && state->slots[i].ptr != CUNIT_ALLOC_GONE) { cunit__alloc_put(slots, nslots, state->slots[i].ptr, state->slots[i].size); }
+	}
+	free(state->slots);
+	state->slots  = slots;
+	state->nslots = nslots;
+	state->used   = (size_t)state->stats.unfreed_count;
+	return true;
+}
+
+void cunit__alloc_note_malloc(void *ptr, size_t size) {
+	cunit_alloc_state_t *state = &cunit__alloc;
+	if (!state->active || state->busy || state->suspend) { return; }
+	state->busy = true;
+	state->stats.count++;
+	state->stats.bytes += size;
+	// A block the table has no room for is counted, but its free is not.
+	if (cunit__alloc_reserve(state)) {
+		cunit__alloc_put(state->slots, state->nslots, ptr, size);
+		state->used++;
+		state->stats.unfreed_count++;
+		state->live += size;
+		if (state->live > state->stats.peak) { state->stats.peak = state->live; }
+	}
+	state->busy = false;
+}
+
+void cunit__alloc_note_free(void *ptr) {
+	cunit_alloc_state_t *state = &cunit__alloc;
+	// Blocks allocated before the test or by cunit are not in the table, and are ignored.
+	if (!state->active || state->busy || !state->slots) { return; }
+	for (size_t at = cunit__alloc_hash(ptr, state->nslots); state->slots[at].ptr; at = (at + 1) & (state->nslots - 1)) {
+		if (state->slots[at].ptr == ptr) {
+			state->slots[at].ptr = CUNIT_ALLOC_GONE;
+			state->stats.frees++;
+			state->stats.unfreed_count--;
+			state->live -= state->slots[at].size;
+			return;
+		}
+	}
+}
+
+void cunit__alloc_begin(void) {
+	cunit_alloc_state_t *state = &cunit__alloc;
+	if (!cunit__alloc_enabled) { return; }
+	memset(&state->stats, 0, sizeof(cunit_alloc_stats_t));
+	state->live    = 0;
+	state->busy    = false;
+	state->suspend = 0;
+	state->active  = true;
+}
+
+void cunit__alloc_end(cunit_alloc_stats_t *stats) {
+	cunit_alloc_state_t *state = &cunit__alloc;
+	if (!state->active) { return; }
+	state->active        = false;
+	state->stats.unfreed = state->live;
+	*stats               = state->stats;
+	free(state->slots);
+	state->slots  = NULL;
+	state->nslots = 0;
+	state->used   = 0;
+}
+
+void cunit__alloc_suspend(void) { cunit__alloc.suspend++; }
+
+void cunit__alloc_resume(void) { cunit__alloc.suspend--; }
+
+bool cunit_alloc_tracking(void) { return cunit__alloc_enabled; }
+
+bool cunit_alloc_stats(cunit_alloc_stats_t *stats) {
+	const cunit_alloc_state_t *state = &cunit__alloc;
+	if (!state->active) { return false; }
+	*stats         = state->stats;
+	stats->unfreed = state->live;
+	return true;
+}
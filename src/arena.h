@@ -0,0 +1,95 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 tayne3
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ * 2. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *    SOFTWARE.
+ */
+#ifndef CUNIT_ARENA_H
+#define CUNIT_ARENA_H
+
+#include "cunit/def.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// A block of an arena, followed by its memory.
+typedef struct cunit_arena_block {
+	struct cunit_arena_block *next;  // The block allocated before this one.
+	size_t                    size;  // The usable size of the block.
+	size_t                    used;  // The number of bytes handed out.
+} cunit_arena_block_t;
+
+// A bump allocator: objects are carved out of large blocks in allocation
+// order and are only released all at once.
+typedef struct {
+	cunit_arena_block_t *blocks;  // The current block, or NULL.
+	size_t               total;   // The usable size of all blocks.
+} cunit_arena_t;
+
+#define CUNIT_ARENA_INIT {NULL, 0}
+
+// Every allocation is aligned for any of these.
+typedef union {
+	long double ld;
+	double      d;
+	uint64_t    u;
+	void       *p;
+	void (*f)(void);
+} cunit_arena_align_t;
+
+#define CUNIT_ARENA_ALIGN(size) (((size) + sizeof(cunit_arena_align_t) - 1) / sizeof(cunit_arena_align_t) * sizeof(cunit_arena_align_t))
+
+// Returns `size` zeroed bytes, or NULL if out of memory. Blocks double in
+// size up to 1 MiB, so that registering n objects takes O(log n) allocations.
+static inline void *cunit_arena_alloc(cunit_arena_t *arena, size_t size) {
+	size                       = CUNIT_ARENA_ALIGN(size ? size : 1);
+	cunit_arena_block_t *block = arena->blocks;
+	if (!block || block->size - block->used < size) {
+		size_t block_size = arena->total ? arena->total : 4096;
+		if (block_size > (size_t)1 << 20) { block_size = (size_t)1 << 20; }
+		if (block_size < size) { block_size = size; }
+		block = (cunit_arena_block_t *)calloc(1, CUNIT_ARENA_ALIGN(sizeof(cunit_arena_block_t)) + block_size);
+		if (!block) { return NULL; }
+		block->next   = arena->blocks;
+		block->size   = block_size;
+		arena->blocks = block;
+		arena->total += block_size;
+	}
+	void *p = (char *)block + CUNIT_ARENA_ALIGN(sizeof(cunit_arena_block_t)) + block->used;
+	block->used += size;
+	return p;
+}
+
+// Releases every object of the arena at once.
+static inline void cunit_arena_free(cunit_arena_t *arena) {
+	for (cunit_arena_block_t *block = arena->blocks, *next; block; block = next) {
+		next = block->next;
+		free(block);
+	}
+	arena->blocks = NULL;
+	arena->total  = 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // CUNIT_ARENA_H
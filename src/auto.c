@@ -0,0 +1,85 @@
+#include "registry.h"
+
+#define CUNIT_MAX_AUTO_SECTIONS 16
+
+// The CUNIT_TEST_AUTO() tests handed over before main(): the section of each
+// executable or shared object, or else the list built by static constructors.
+// Nothing is allocated until the tests are added to a registry.
+static struct {
+	const cunit_auto_test_t *begin[CUNIT_MAX_AUTO_SECTIONS];  // The first test of each section.
+	const cunit_auto_test_t *end[CUNIT_MAX_AUTO_SECTIONS];    // The end of each section.
+	int                      sections;                        // The number of sections.
+	cunit_auto_link_t       *head;                            // The first linked test, or NULL.
+	cunit_auto_link_t       *tail;                            // The last linked test, or NULL.
+} cunit__auto = {{NULL}, {NULL}, 0, NULL, NULL};
+
+void cunit__auto_section(const cunit_auto_test_t *begin, const cunit_auto_test_t *end) {
+	if (!begin || end <= begin) { return; }
+	for (int i = 0; i < cunit__auto.sections; i++) {
+		if (cunit__auto.begin[i] == begin) { return; }
+	}
+	if (cunit__auto.sections == CUNIT_MAX_AUTO_SECTIONS) { return; }
+	cunit__auto.begin[cunit__auto.sections] = begin;
+	cunit__auto.end[cunit__auto.sections++] = end;
+}
+
+void cunit__auto_link(cunit_auto_link_t *link) {
+	link->next = NULL;
+	if (cunit__auto.tail) {
+		cunit__auto.tail->next = link;
+	} else {
+		cunit__auto.head = link;
+	}
+	cunit__auto.tail = link;
+}
+
+// Adds one test to the suite of its name, creating the suite if needed.
+static void cunit__auto_add(const cunit_auto_test_t *test) {
+	if (!test->func || !test->suite || !test->name) { return; }
+	cunit_suite_t *suite = cunit__registry.current_suite;
+	if (!suite || strcmp(suite->name, test->suite) != 0) {
+		suite = cunit__index_find_suite(test->suite);
+		if (!suite) {
+			cunit_suite(test->suite, NULL, NULL);
+			suite = cunit__index_find_suite(test->suite);
+			if (!suite) { return; }
+		}
+		cunit__registry.current_suite = suite;
+	}
+	cunit_test(test->name, test->func);
+}
+
+static int cunit__auto_compare(const void *a, const void *b) {
+	const cunit_auto_test_t *x = *(const cunit_auto_test_t *const *)a;
+	const cunit_auto_test_t *y = *(const cunit_auto_test_t *const *)b;
+	return (x->line > y->line) - (x->line < y->line);
+}
+
+// Adds the tests of a section. The compiler may lay out the tests of a file in
+// any order, so each file's run of tests is put back in definition order.
+static void cunit__auto_add_section(const cunit_auto_test_t *begin, const cunit_auto_test_t *end) {
+	const size_t              count = (size_t)(end - begin);
+	const cunit_auto_test_t **order = (const cunit_auto_test_t **)malloc(count * sizeof(const cunit_auto_test_t *));
+	if (!order) {
+		for (const cunit_auto_test_t *test = begin; test < end; test++) { cunit__auto_add(test); }
+		return;
+	}
+	for (size_t i = 0; i < count; i++) { order[i] = &begin[i]; }
+	for (size_t first = 0, last; first < count; first = last) {
+		for (last = first + 1; last < count && strcmp(order[last]->file, order[first]->file) == 0; last++) {}
+		qsort(order + first, last - first, sizeof(const cunit_auto_test_t *), cunit__auto_compare);
+	}
+	for (size_t i = 0; i < count; i++) { cunit__auto_add(order[i]); }
+	free(order);
+}
+
+void cunit__auto_register(void) {
+	if (cunit__registry.auto_registered) { return; }
+	cunit__registry.auto_registered = true;
+
+	// Tests registered by hand after this still go to the suite they expect.
+	cunit_suite_t *current = cunit__registry.current_suite;
+	for (int i = 0; i < cunit__auto.sections; i++) { cunit__auto_add_section(cunit__auto.begin[i], cunit__auto.end[i]); }
+	for (const cunit_auto_link_t *link = cunit__auto.head; link; link = link->next) { cunit__auto_add(link->test); }
+	cunit__registry.current_suite = current;
+}
@@ -0,0 +1,151 @@
+#include "clock.h"
+#include "cunit.h"
+#include "registry.h"
+
+// Backs cunit_do_not_optimize() where no inline assembly is available. Being
+// defined out of line is what matters; the pointer itself is not used.
+void __cunit_bench_escape(const void *p) { (void)p; }
+
+// Runs `iterations` calls of `func` and returns the elapsed nanoseconds.
+static uint64_t cunit__bench_time(cunit_bench_func_t func, uint64_t iterations) {
+	const uint64_t started = cunit_clock_now();
+	for (uint64_t i = 0; i < iterations; i++) { func(); }
+	return cunit_clock_now() - started;
+}
+
+// Finds the number of iterations that takes at least `target` nanoseconds.
+static uint64_t cunit__bench_calibrate(cunit_bench_func_t func, uint64_t target) {
+	uint64_t iterations = 1;
+	for (;;) {
+		const uint64_t elapsed = cunit__bench_time(func, iterations);
+		if (elapsed >= target || iterations >= UINT64_MAX / 100) { return iterations; }
+
+		// Aim a little past the target, but grow at most 100x per step in case
+		// the first runs were too short to be timed accurately.
+		double scale = elapsed ? (double)target * 1.2 / (double)elapsed : 100.0;
+		if (scale < 2.0) { scale = 2.0; }
+		if (scale > 100.0) { scale = 100.0; }
+		iterations = (uint64_t)((double)iterations * scale);
+	}
+}
+
+static int cunit__bench_compare(const void *a, const void *b) {
+	const double x = *(const double *)a, y = *(const double *)b;
+	return (x > y) - (x < y);
+}
+
+// Returns the median of a sorted array.
+static double cunit__bench_median(const double *sorted, int count) {
+	return count % 2 ? sorted[count / 2] : (sorted[count / 2 - 1] + sorted[count / 2]) / 2.0;
+}
+
+void cunit__bench_measure(cunit_bench_func_t func, cunit_bench_stats_t *stats) {
+	// Samples live on the stack, since an assertion may longjmp out of here.
+	double samples[CUNIT_BENCH_MAX_REPETITIONS], deviations[CUNIT_BENCH_MAX_REPETITIONS];
+	const int      repetitions = cunit__registry.bench_repetitions;
+	const uint64_t target      = (uint64_t)(cunit__registry.bench_time * 1e9);
+	const uint64_t iterations  = cunit__bench_calibrate(func, target > 0 ? target : 1);
+
+	double sum = 0.0;
+	for (int i = 0; i < repetitions; i++) {
+		samples[i] = (double)cunit__bench_time(func, iterations) / (double)iterations;
+		sum += samples[i];
+	}
+	qsort(samples, (size_t)repetitions, sizeof(double), cunit__bench_compare);
+
+	const double mean     = sum / repetitions;
+	const double median   = cunit__bench_median(samples, repetitions);
+	double       variance = 0.0;
+	for (int i = 0; i < repetitions; i++) {
+		variance += (samples[i] - mean) * (samples[i] - mean);
+		deviations[i] = fabs(samples[i] - median);
+	}
+	qsort(deviations, (size_t)repetitions, sizeof(double), cunit__bench_compare);
+
+	stats->iterations  = iterations;
+	stats->repetitions = repetitions;
+	stats->min         = samples[0];
+	stats->median      = median;
+	stats->mean        = mean;
+	stats->stddev      = repetitions > 1 ? sqrt(variance / (repetitions - 1)) : 0.0;
+	stats->mad         = cunit__bench_median(deviations, repetitions);
+}
+
+// Sets the time each benchmark repetition should take.
+void cunit_set_bench_time(double seconds) { cunit__registry.bench_time = seconds > 0.0 ? seconds : 0.0; }
+
+// Sets the number of timed repetitions of each benchmark.
+void cunit_set_bench_repetitions(int repetitions) {
+	if (repetitions < 1) { repetitions = 1; }
+	if (repetitions > CUNIT_BENCH_MAX_REPETITIONS) { repetitions = CUNIT_BENCH_MAX_REPETITIONS; }
+	cunit__registry.bench_repetitions = repetitions;
+}
+
+// Sets the file that holds the benchmark baseline.
+void cunit_set_bench_baseline(const char *path) { cunit__registry.bench_baseline = path; }
+
+// Enables or disables baseline update mode.
+void cunit_set_bench_update(bool update) { cunit__registry.bench_update = update; }
+
+// Sets when a benchmark counts as regressed against its baseline.
+void cunit_set_bench_threshold(double percent, double sigmas) {
+	cunit__registry.bench_threshold = percent > 0.0 ? percent : 0.0;
+	cunit__registry.bench_sigmas    = sigmas > 0.0 ? sigmas : 0.0;
+}
+
+void cunit__baseline_load(void) {
+	if (STR_ISEMPTY(cunit__registry.bench_baseline) || cunit__registry.baseline.count) { return; }
+	cunit__db_load(&cunit__registry.baseline, cunit__registry.bench_baseline);
+}
+
+void cunit__baseline_save(void) {
+	if (STR_ISEMPTY(cunit__registry.bench_baseline)) { return; }
+
+	bool changed = false;
+	for (cunit_suite_t *suite = cunit__registry.suites; suite; suite = suite->next) {
+		for (cunit_test_t *test = suite->tests; test; test = test->next) {
+			const cunit_bench_stats_t *stats = &test->result.bench;
+			if (!test->bench || !test->selected || test->result.status != CUNIT_STATUS_PASSED || !stats->repetitions) { continue; }
+			if (!cunit__registry.bench_update && cunit__db_find(&cunit__registry.baseline, suite->name, test->name)) { continue; }
+
+			cunit_db_entry_t *entry = cunit__db_put(&cunit__registry.baseline, suite->name, test->name);
+			if (!entry) { continue; }
+			entry->values[0] = stats->median;
+			entry->values[1] = stats->mad;
+			entry->values[2] = stats->mean;
+			entry->values[3] = stats->stddev;
+			changed          = true;
+		}
+	}
+	if (changed && !cunit__db_save(&cunit__registry.baseline, cunit__registry.bench_baseline)) {
+		fprintf(stderr, "cunit: cannot write benchmark baseline '%s'\n", cunit__registry.bench_baseline);
+	}
+}
+
+void cunit__baseline_check(const cunit_suite_t *suite, const cunit_test_t *test, const cunit_bench_stats_t *stats) {
+	if (cunit__registry.bench_update) { return; }
+	const cunit_db_entry_t *entry = cunit__db_find(&cunit__registry.baseline, suite->name, test->name);
+	if (!entry || entry->values[0] <= 0.0) { return; }
+
+	// The slowdown must exceed both the relative threshold and the noise of
+	// the two runs, estimated from their MADs (1.4826 x MAD ~ one sigma).
+	const double baseline = entry->values[0];
+	const double slowdown = stats->median - baseline;
+	const double noise    = cunit__registry.bench_sigmas * 1.4826 * sqrt(stats->mad * stats->mad + entry->values[1] * entry->values[1]);
+	if (slowdown <= baseline * cunit__registry.bench_threshold / 100.0 || slowdown <= noise) { return; }
+
+	cunit_buffer_t message = CUNIT_BUFFER_INIT;
+	cunit_buffer_printf(&message, "%s / %s regressed: median %.2f ns, baseline %.2f ns (+%.1f%%, limit +%.1f%%, noise %.2f ns)", suite->name,
+						test->name, stats->median, baseline, slowdown * 100.0 / baseline, cunit__registry.bench_threshold, noise);
+	// The regression is the benchmark's, not of a line of code: the failure has no place.
+	cunit_context_t ctx;
+	memset(&ctx, 0, sizeof(ctx));
+	cunit_failure_t failure;
+	failure.ctx     = ctx;
+	failure.message = cunit_buffer_str(&message);
+	failure.note    = NULL;
+	failure.fatal   = false;
+	cunit__report_failure(&failure);
+	cunit_buffer_free(&message);
+	cunit__handle_fail(ctx);
+}
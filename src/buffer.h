@@ -0,0 +1,113 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 tayne3
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ * 2. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *    SOFTWARE.
+ */
+#ifndef CUNIT_BUFFER_H
+#define CUNIT_BUFFER_H
+
+#include <stdarg.h>
+
+#include "cunit/def.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// A growable byte buffer. Allocation failures are sticky: once set, further
+// writes are dropped, so callers can format first and check once.
+typedef struct {
+	char  *data;      // The bytes written so far, NUL-terminated when non-empty.
+	size_t size;      // The number of bytes written, excluding the terminator.
+	size_t capacity;  // The allocated size of `data`.
+	bool   failed;    // Whether an allocation failed.
+} cunit_buffer_t;
+
+#define CUNIT_BUFFER_INIT {NULL, 0, 0, false}
+
+// Makes room for `extra` more bytes plus a terminator.
+static inline bool cunit_buffer_reserve(cunit_buffer_t *buffer, size_t extra) {
+	if (buffer->failed) { return false; }
+	if (buffer->size + extra + 1 <= buffer->capacity) { return true; }
+
+	size_t capacity = buffer->capacity ? buffer->capacity : 128;
+	while (capacity < buffer->size + extra + 1) { capacity *= 2; }
+	char *data = (char *)realloc(buffer->data, capacity);
+	if (!data) {
+		buffer->failed = true;
+		return false;
+	}
+	buffer->data     = data;
+	buffer->capacity = capacity;
+	return true;
+}
+
+static inline void cunit_buffer_append(cunit_buffer_t *buffer, const void *data, size_t size) {
+	if (!cunit_buffer_reserve(buffer, size)) { return; }
+	memcpy(buffer->data + buffer->size, data, size);
+	buffer->size += size;
+	buffer->data[buffer->size] = '\0';
+}
+
+static inline void cunit_buffer_puts(cunit_buffer_t *buffer, const char *s) { cunit_buffer_append(buffer, s, strlen(s)); }
+
+static inline void cunit_buffer_putc(cunit_buffer_t *buffer, char c) { cunit_buffer_append(buffer, &c, 1); }
+
+static inline void cunit_buffer_vprintf(cunit_buffer_t *buffer, const char *format, va_list args) {
+	va_list copy;
+	va_copy(copy, args);
+	const int length = vsnprintf(NULL, 0, format, copy);
+	va_end(copy);
+	if (length < 0 || !cunit_buffer_reserve(buffer, (size_t)length)) { return; }
+	vsnprintf(buffer->data + buffer->size, (size_t)length + 1, format, args);
+	buffer->size += (size_t)length;
+}
+
+static inline void cunit_buffer_printf(cunit_buffer_t *buffer, const char *format, ...) {
+	va_list args;
+	va_start(args, format);
+	cunit_buffer_vprintf(buffer, format, args);
+	va_end(args);
+}
+
+// Returns the contents as a string; never NULL.
+static inline const char *cunit_buffer_str(const cunit_buffer_t *buffer) { return buffer->data && buffer->size ? buffer->data : ""; }
+
+// Empties the buffer but keeps its memory.
+static inline void cunit_buffer_clear(cunit_buffer_t *buffer) {
+	buffer->size   = 0;
+	buffer->failed = false;
+	if (buffer->data) { buffer->data[0] = '\0'; }
+}
+
+static inline void cunit_buffer_free(cunit_buffer_t *buffer) {
+	free(buffer->data);
+	buffer->data     = NULL;
+	buffer->size     = 0;
+	buffer->capacity = 0;
+	buffer->failed   = false;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // CUNIT_BUFFER_H
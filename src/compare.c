@@ -3,27 +3,37 @@
 #include <stdarg.h>
 
 #include "cunit/assert.h"
+#include "diff.h"
+#include "file.h"
+#include "registry.h"
+#include "simd.h"
 
 #ifdef _MSC_VER
 #define strcasecmp  _stricmp
 #define strncasecmp _strnicmp
 #endif
 
+// The checks and assertions the calling thread has made since its test started.
+CUNIT_THREAD_LOCAL uint64_t __cunit_assertions = 0;
+
+#ifdef _WIN32
+void __cunit_assertion_count(void) { __cunit_assertions++; }
+#endif
+
 #define CUNIT_STRCMP(l, r)        (l == r ? 0 : !l ? -1 : !r ? 1 : strcmp(l, r))
 #define CUNIT_STRCASECMP(l, r)    (l == r ? 0 : !l ? -1 : !r ? 1 : strcasecmp(l, r))
 #define CUNIT_STRNCMP(l, r, size) (l == r ? 0 : !l ? -1 : !r ? 1 : strncmp(l, r, size))
 
-#define CUNIT_NUMBER_COMPARE(l, r)  ((l > r) - (l < r))
-#define CUNIT_FLOAT32_COMPARE(l, r) (isnan(l) ? isnan(r) ? 0 : -1 : isnan(r) ? 1 : (fabsf(l - r) <= FLT_EPSILON) ? 0 : (l > r) - (l < r))
-#define CUNIT_FLOAT64_COMPARE(l, r) (isnan(l) ? isnan(r) ? 0 : -1 : isnan(r) ? 1 : (fabs(l - r) <= DBL_EPSILON) ? 0 : (l > r) - (l < r))
+#define CUNIT_FLOAT32_COMPARE(l, r) CUNIT_FLOAT_COMPARE(l, r, FLT_EPSILON)
+#define CUNIT_FLOAT64_COMPARE(l, r) CUNIT_FLOAT_COMPARE(l, r, DBL_EPSILON)
 
-static inline void __cunit_print_bool(bool b) { fputs(b ? "true" : "false", stdout); }
-static inline void __cunit_print_char(char c) { putchar(c); }
-static inline void __cunit_print_f32(float f) { printf("%f", f); }
-static inline void __cunit_print_f64(double f) { printf("%f", f); }
-static inline void __cunit_print_str(const char *str) { fputs(str ? str : "(null)", stdout); }
+static inline void __cunit_print_bool(cunit_buffer_t *out, bool b) { cunit_buffer_puts(out, b ? "true" : "false"); }
+static inline void __cunit_print_char(cunit_buffer_t *out, char c) { cunit_buffer_putc(out, c); }
+static inline void __cunit_print_f32(cunit_buffer_t *out, float f) { cunit_buffer_printf(out, "%f", f); }
+static inline void __cunit_print_f64(cunit_buffer_t *out, double f) { cunit_buffer_printf(out, "%f", f); }
+static inline void __cunit_print_str(cunit_buffer_t *out, const char *str) { cunit_buffer_puts(out, str ? str : "(null)"); }
 
-static inline void __cunit_print_u64(uint64_t n) {
+static inline void __cunit_print_u64(cunit_buffer_t *out, uint64_t n) {
 	// Buffer large enough for 20 digits of uint64_t + null terminator
 	char buf[21];
 	int  i = sizeof(buf) - 1;
@@ -37,29 +47,29 @@ static inline void __cunit_print_u64(uint64_t n) {
 			n /= 10;
 		}
 	}
-	fputs(&buf[i], stdout);
+	cunit_buffer_puts(out, &buf[i]);
 }
 
-static inline void __cunit_print_i64(int64_t n) {
+static inline void __cunit_print_i64(cunit_buffer_t *out, int64_t n) {
 	if (n >= 0) {
-		__cunit_print_u64((uint64_t)n);
+		__cunit_print_u64(out, (uint64_t)n);
 	} else {
-		putchar('-');
-		__cunit_print_u64((uint64_t)-n);
+		cunit_buffer_putc(out, '-');
+		__cunit_print_u64(out, (uint64_t)-n);
 	}
 }
 
-static inline void __cunit_print_u32(uint32_t n) { __cunit_print_u64(n); }
-static inline void __cunit_print_i32(int32_t n) { __cunit_print_i64(n); }
-static inline void __cunit_print_u16(uint16_t n) { __cunit_print_u64(n); }
-static inline void __cunit_print_i16(int16_t n) { __cunit_print_i64(n); }
-static inline void __cunit_print_u8(uint8_t n) { __cunit_print_u64(n); }
-static inline void __cunit_print_i8(int8_t n) { __cunit_print_i64(n); }
+static inline void __cunit_print_u32(cunit_buffer_t *out, uint32_t n) { __cunit_print_u64(out, n); }
+static inline void __cunit_print_i32(cunit_buffer_t *out, int32_t n) { __cunit_print_i64(out, n); }
+static inline void __cunit_print_u16(cunit_buffer_t *out, uint16_t n) { __cunit_print_u64(out, n); }
+static inline void __cunit_print_i16(cunit_buffer_t *out, int16_t n) { __cunit_print_i64(out, n); }
+static inline void __cunit_print_u8(cunit_buffer_t *out, uint8_t n) { __cunit_print_u64(out, n); }
+static inline void __cunit_print_i8(cunit_buffer_t *out, int8_t n) { __cunit_print_i64(out, n); }
 
-static inline void __cunit_print_ptr(const void *p) {
+static inline void __cunit_print_ptr(cunit_buffer_t *out, const void *p) {
 	if (p == NULL) {
 		// Consistent with typical %p output for NULL
-		fputs("(nil)", stdout);
+		cunit_buffer_puts(out, "(nil)");
 		return;
 	}
 	// uintptr_t is an integer type wide enough to hold a pointer
@@ -82,32 +92,39 @@ static inline void __cunit_print_ptr(const void *p) {
 	}
 	*--ptr = 'x';  // Add "0x" prefix
 	*--ptr = '0';
-	fputs(ptr, stdout);  // Print the resulting hex string
+	cunit_buffer_puts(out, ptr);  // Print the resulting hex string
 }
 
-void __cunit_value_print(const cunit_value_t *self) {
+static void __cunit_value_format(cunit_buffer_t *out, const cunit_value_t *self) {
 	switch (self->type) {
-		case CUnitType_Bool: __cunit_print_bool(self->d.b); break;
-		case CUnitType_Char: __cunit_print_char(self->d.c); break;
-		case CUnitType_Float32: __cunit_print_f32(self->d.f32); break;
-		case CUnitType_Float64: __cunit_print_f64(self->d.f64); break;
-		case CUnitType_String: __cunit_print_str(self->d.str); break;
-		case CUnitType_Pointer: __cunit_print_ptr(self->d.ptr); break;
-		case CUnitType_Int: __cunit_print_i32(self->d.i); break;
-		case CUnitType_Int8: __cunit_print_i8(self->d.i8); break;
-		case CUnitType_Int16: __cunit_print_i16(self->d.i16); break;
-		case CUnitType_Int32: __cunit_print_i32(self->d.i32); break;
-		case CUnitType_Int64: __cunit_print_i64(self->d.i64); break;
-		case CUnitType_Uint: __cunit_print_u32(self->d.u); break;
-		case CUnitType_Uint8: __cunit_print_u8(self->d.u8); break;
-		case CUnitType_Uint16: __cunit_print_u16(self->d.u16); break;
-		case CUnitType_Uint32: __cunit_print_u32(self->d.u32); break;
-		case CUnitType_Uint64: __cunit_print_u64(self->d.u64); break;
+		case CUnitType_Bool: __cunit_print_bool(out, self->d.b); break;
+		case CUnitType_Char: __cunit_print_char(out, self->d.c); break;
+		case CUnitType_Float32: __cunit_print_f32(out, self->d.f32); break;
+		case CUnitType_Float64: __cunit_print_f64(out, self->d.f64); break;
+		case CUnitType_String: __cunit_print_str(out, self->d.str); break;
+		case CUnitType_Pointer: __cunit_print_ptr(out, self->d.ptr); break;
+		case CUnitType_Int: __cunit_print_i32(out, self->d.i); break;
+		case CUnitType_Int8: __cunit_print_i8(out, self->d.i8); break;
+		case CUnitType_Int16: __cunit_print_i16(out, self->d.i16); break;
+		case CUnitType_Int32: __cunit_print_i32(out, self->d.i32); break;
+		case CUnitType_Int64: __cunit_print_i64(out, self->d.i64); break;
+		case CUnitType_Uint: __cunit_print_u32(out, self->d.u); break;
+		case CUnitType_Uint8: __cunit_print_u8(out, self->d.u8); break;
+		case CUnitType_Uint16: __cunit_print_u16(out, self->d.u16); break;
+		case CUnitType_Uint32: __cunit_print_u32(out, self->d.u32); break;
+		case CUnitType_Uint64: __cunit_print_u64(out, self->d.u64); break;
 		case CUnitType_Invalid:
-		default: fputs("(invalid)", stdout); break;
+		default: cunit_buffer_puts(out, "(invalid)"); break;
 	}
 }
 
+void __cunit_value_print(const cunit_value_t *self) {
+	cunit_buffer_t out = CUNIT_BUFFER_INIT;
+	__cunit_value_format(&out, self);
+	fputs(cunit_buffer_str(&out), stdout);
+	cunit_buffer_free(&out);
+}
+
 int __cunit_value_compare(const cunit_value_t *l, const cunit_value_t *r) {
 	if (l->type != r->type) { return -2; }
 	switch (l->type) {
@@ -142,83 +159,67 @@ enum cunit_compare_result {
 
 #define CUNIT_COMPARE_RESULT_TO_STR(x) ((x) == CUnitCompare_Less ? "<" : (x) == CUnitCompare_Equal ? "=" : (x) == CUnitCompare_Greater ? ">" : "?")
 
-#define __cunit_print_not_expected(ctx) \
-	do { printf("\033[33;2m%s:%d\033[0m not expected: ", __cunit_relative(ctx.file), ctx.line); } while (0)
-
-#define __cunit_print_info(ctx, format, ...)                                         \
-	do {                                                                             \
-		if (!STR_ISEMPTY(format)) {                                                  \
-			printf("\033[37;2m%s:%d\033[0m ", __cunit_relative(ctx.file), ctx.line); \
-			va_list args;                                                            \
-			va_start(args, format);                                                  \
-			vprintf(format, args);                                                   \
-			va_end(args);                                                            \
-			fputs(STR_NEWLINE, stdout);                                              \
-		}                                                                            \
+// Reports a failed check: `message` says what was not as expected and the
+// caller's format, if any, becomes the note. Frees `message`.
+static void __cunit_report(const cunit_context_t ctx, cunit_buffer_t *message, const char *format, va_list args) {
+	cunit_buffer_t note = CUNIT_BUFFER_INIT;
+	if (!STR_ISEMPTY(format)) { cunit_buffer_vprintf(&note, format, args); }
+
+	cunit_failure_t failure;
+	failure.ctx     = ctx;
+	failure.message = cunit_buffer_str(message);
+	failure.note    = note.size ? note.data : NULL;
+	failure.fatal   = false;
+	cunit__report_failure(&failure);
+
+	cunit_buffer_free(&note);
+	cunit_buffer_free(message);
+	cunit__alloc_resume();
+}
+
+// Declares the buffer a failed check formats its message into. What it
+// allocates is not counted against the test.
+#define __cunit_begin_message()            \
+	cunit_buffer_t out = CUNIT_BUFFER_INIT; \
+	cunit__alloc_suspend()
+
+// Reports the message formatted into `out`, and counts allocations again; must be used in the variadic check function itself.
+#define __cunit_end_message(ctx, format)         \
+	do {                                         \
+		va_list args;                            \
+		va_start(args, format);                  \
+		__cunit_report(ctx, &out, format, args); \
+		va_end(args);                            \
 	} while (0)
 
-static inline bool __cunit_check_any_is_in_array(const cunit_value_t value, const void *array, size_t size) {
-	switch (value.type) {
-		case CUnitType_Bool:
-			for (size_t i = 0; i < size; i++) {
-				if (((const bool *)array)[i] == value.d.b) { return true; }
-			}
-			return false;
-		case CUnitType_Char:
-			for (size_t i = 0; i < size; i++) {
-				if (((const char *)array)[i] == value.d.c) { return true; }
-			}
-			return false;
-		case CUnitType_Int:
-			for (size_t i = 0; i < size; i++) {
-				if (((const int *)array)[i] == value.d.i) { return true; }
-			}
-			return false;
+// Returns the size of the elements of an array of values of a type that compares
+// its elements bit for bit, or 0 for one that does not (floating-point numbers and strings).
+static size_t __cunit_exact_size(enum cunit_type type) {
+	switch (type) {
+		case CUnitType_Bool: return sizeof(bool);
+		case CUnitType_Char: return sizeof(char);
+		case CUnitType_Int: return sizeof(int);
+		case CUnitType_Uint: return sizeof(unsigned);
+		case CUnitType_Pointer: return sizeof(void *);
 		case CUnitType_Int8:
-			for (size_t i = 0; i < size; i++) {
-				if (((const int8_t *)array)[i] == value.d.i8) { return true; }
-			}
-			return false;
+		case CUnitType_Uint8: return 1;
 		case CUnitType_Int16:
-			for (size_t i = 0; i < size; i++) {
-				if (((const int16_t *)array)[i] == value.d.i16) { return true; }
-			}
-			return false;
+		case CUnitType_Uint16: return 2;
 		case CUnitType_Int32:
-			for (size_t i = 0; i < size; i++) {
-				if (((const int32_t *)array)[i] == value.d.i32) { return true; }
-			}
-			return false;
+		case CUnitType_Uint32: return 4;
 		case CUnitType_Int64:
-			for (size_t i = 0; i < size; i++) {
-				if (((const int64_t *)array)[i] == value.d.i64) { return true; }
-			}
-			return false;
-		case CUnitType_Uint:
-			for (size_t i = 0; i < size; i++) {
-				if (((const unsigned int *)array)[i] == value.d.u) { return true; }
-			}
-			return false;
-		case CUnitType_Uint8:
-			for (size_t i = 0; i < size; i++) {
-				if (((const uint8_t *)array)[i] == value.d.u8) { return true; }
-			}
-			return false;
-		case CUnitType_Uint16:
-			for (size_t i = 0; i < size; i++) {
-				if (((const uint16_t *)array)[i] == value.d.u16) { return true; }
-			}
-			return false;
-		case CUnitType_Uint32:
-			for (size_t i = 0; i < size; i++) {
-				if (((const uint32_t *)array)[i] == value.d.u32) { return true; }
-			}
-			return false;
-		case CUnitType_Uint64:
-			for (size_t i = 0; i < size; i++) {
-				if (((const uint64_t *)array)[i] == value.d.u64) { return true; }
-			}
-			return false;
+		case CUnitType_Uint64: return 8;
+		default: return 0;
+	}
+}
+
+static inline bool __cunit_check_any_is_in_array(const cunit_value_t value, const void *array, size_t size) {
+	// Integers, characters, booleans and pointers are scanned with SIMD: each member of the
+	// union is stored at its start, so it compares bit for bit with an element of its type.
+	const size_t width = __cunit_exact_size(value.type);
+	if (width) { return cunit__find(array, size, width, &value.d) < size; }
+
+	switch (value.type) {
 		case CUnitType_Float32:
 			for (size_t i = 0; i < size; i++) {
 				const float it = ((const float *)array)[i];
@@ -226,7 +227,7 @@ static inline bool __cunit_check_any_is_in_array(const cunit_value_t value, cons
 					if (isnan(value.d.f32)) { return true; }
 					continue;
 				}
-				if (fabsf(it - value.d.f32) <= FLT_EPSILON) { return true; }
+				if (it == value.d.f32 || fabsf(it - value.d.f32) <= FLT_EPSILON) { return true; }
 			}
 			return false;
 		case CUnitType_Float64:
@@ -236,7 +237,7 @@ static inline bool __cunit_check_any_is_in_array(const cunit_value_t value, cons
 					if (isnan(value.d.f64)) { return true; }
 					continue;
 				}
-				if (fabs(it - value.d.f64) <= DBL_EPSILON) { return true; }
+				if (it == value.d.f64 || fabs(it - value.d.f64) <= DBL_EPSILON) { return true; }
 			}
 			return false;
 		case CUnitType_String:
@@ -244,31 +245,10 @@ static inline bool __cunit_check_any_is_in_array(const cunit_value_t value, cons
 				if (((const char *const *)array)[i] == value.d.str || CUNIT_STRCMP(((const char *const *)array)[i], value.d.str) == 0) { return true; }
 			}
 			return false;
-		case CUnitType_Pointer:
-			for (size_t i = 0; i < size; i++) {
-				if (((const void *const *)array)[i] == value.d.ptr) { return true; }
-			}
-			return false;
 		default: return true;
 	}
 }
 
-static inline void __cunit_print_hex(const uint8_t *array, size_t length) {
-	if (!array) {
-		fputs("(null)", stdout);
-		return;
-	}
-
-	for (;;) {
-		if (--length > 0) {
-			printf("%02X ", *array++);
-			continue;
-		}
-		if (length == 0) { printf("%02X", *array++); }
-		break;
-	}
-}
-
 #define __cunit_process_compare_result(result, cond, print_l, print_r, format) \
 	do {                                                                       \
 		switch (result) {                                                      \
@@ -283,177 +263,770 @@ static inline void __cunit_print_hex(const uint8_t *array, size_t length) {
 				break;                                                         \
 			default: break;                                                    \
 		}                                                                      \
-		__cunit_print_not_expected(ctx);                                       \
+		__cunit_begin_message();                                               \
 		print_l;                                                               \
-		fputs(" ", stdout);                                                    \
-		fputs(CUNIT_COMPARE_RESULT_TO_STR(result), stdout);                    \
-		fputs(" ", stdout);                                                    \
+		cunit_buffer_putc(&out, ' ');                                          \
+		cunit_buffer_puts(&out, CUNIT_COMPARE_RESULT_TO_STR(result));          \
+		cunit_buffer_putc(&out, ' ');                                          \
 		print_r;                                                               \
-		fputs(STR_NEWLINE, stdout);                                            \
-		__cunit_print_info(ctx, format);                                       \
+		__cunit_end_message(ctx, format);                                      \
 		return false;                                                          \
 	} while (0)
 
 bool __cunit_compare_bool(const cunit_context_t ctx, bool l, bool r, int cond, const char *format, ...) {
+	__cunit_count_assertion();
 	const enum cunit_compare_result result = (l > r) - (l < r);
-	__cunit_process_compare_result(result, cond, __cunit_print_bool(l), __cunit_print_bool(r), format);
+	__cunit_process_compare_result(result, cond, __cunit_print_bool(&out, l), __cunit_print_bool(&out, r), format);
 }
 
 bool __cunit_compare_char(const cunit_context_t ctx, char l, char r, int cond, const char *format, ...) {
+	__cunit_count_assertion();
 	const enum cunit_compare_result result = (l > r) - (l < r);
-	__cunit_process_compare_result(result, cond, __cunit_print_char(l), __cunit_print_char(r), format);
+	__cunit_process_compare_result(result, cond, __cunit_print_char(&out, l), __cunit_print_char(&out, r), format);
 }
 
 bool __cunit_compare_float(const cunit_context_t ctx, float l, float r, int cond, const char *format, ...) {
+	__cunit_count_assertion();
 	const enum cunit_compare_result result = CUNIT_FLOAT32_COMPARE(l, r);
-	__cunit_process_compare_result(result, cond, __cunit_print_f32(l), __cunit_print_f32(r), format);
+	__cunit_process_compare_result(result, cond, __cunit_print_f32(&out, l), __cunit_print_f32(&out, r), format);
 }
 
 bool __cunit_compare_double(const cunit_context_t ctx, double l, double r, int cond, const char *format, ...) {
+	__cunit_count_assertion();
 	const enum cunit_compare_result result = CUNIT_FLOAT64_COMPARE(l, r);
-	__cunit_process_compare_result(result, cond, __cunit_print_f64(l), __cunit_print_f64(r), format);
+	__cunit_process_compare_result(result, cond, __cunit_print_f64(&out, l), __cunit_print_f64(&out, r), format);
 }
 
 bool __cunit_compare_ptr(const cunit_context_t ctx, const void *l, const void *r, int cond, const char *format, ...) {
+	__cunit_count_assertion();
 	const enum cunit_compare_result result = (l > r) - (l < r);
-	__cunit_process_compare_result(result, cond, __cunit_print_ptr(l), __cunit_print_ptr(r), format);
+	__cunit_process_compare_result(result, cond, __cunit_print_ptr(&out, l), __cunit_print_ptr(&out, r), format);
 }
 
 bool __cunit_check_null(const cunit_context_t ctx, const void *p, const char *format, ...) {
+	__cunit_count_assertion();
 	if (!p) { return true; }
 
-	__cunit_print_not_expected(ctx);
-	printf("%p is not null" STR_NEWLINE, p);
-	__cunit_print_info(ctx, format);
+	__cunit_begin_message();
+	cunit_buffer_printf(&out, "%p is not null", p);
+	__cunit_end_message(ctx, format);
 	return false;
 }
 
 bool __cunit_check_not_null(const cunit_context_t ctx, const void *p, const char *format, ...) {
+	__cunit_count_assertion();
 	if (p) { return true; }
 
-	__cunit_print_not_expected(ctx);
-	fputs("(null) is null" STR_NEWLINE, stdout);
-	__cunit_print_info(ctx, format);
+	__cunit_begin_message();
+	cunit_buffer_puts(&out, "(null) is null");
+	__cunit_end_message(ctx, format);
 	return false;
 }
 
+// Strings longer than this, or with a newline, are shown as a line diff rather than whole.
+#define CUNIT_STR_INLINE 64
+
+static inline bool __cunit_str_inline(const char *s, size_t size) { return size <= CUNIT_STR_INLINE && !memchr(s, '\n', size); }
+
+// Prints a string whole, or its size if it is too large to show.
+static void __cunit_print_text(cunit_buffer_t *out, const char *s, size_t size) {
+	if (!s) {
+		cunit_buffer_puts(out, "(null)");
+	} else if (__cunit_str_inline(s, size)) {
+		cunit_buffer_append(out, s, size);
+	} else {
+		cunit_buffer_printf(out, "string of %llu bytes", (unsigned long long)size);
+	}
+}
+
+// Prints why two strings are not equal: both whole if they are short, a line diff otherwise.
+static void __cunit_print_str_diff(cunit_buffer_t *out, const char *l, size_t l_size, const char *r, size_t r_size) {
+	if (l && r && !(__cunit_str_inline(l, l_size) && __cunit_str_inline(r, r_size))) {
+		cunit__diff(out, l, l_size, r, r_size);
+		return;
+	}
+	__cunit_print_text(out, l, l_size);
+	cunit_buffer_puts(out, " != ");
+	__cunit_print_text(out, r, r_size);
+}
+
+// Returns the length of a string, up to `size`.
+static inline size_t __cunit_str_size(const char *s, size_t size) {
+	size_t n = 0;
+	if (s) {
+		while (n < size && s[n]) { n++; }
+	}
+	return n;
+}
+
 bool __cunit_check_str(const cunit_context_t ctx, const char *l, const char *r, bool equal, const char *format, ...) {
+	__cunit_count_assertion();
 	const bool is_str_equal = (l == r) || (l && r && !CUNIT_STRCMP(l, r));
 	if (is_str_equal == equal) { return true; }
 
-	__cunit_print_not_expected(ctx);
-	printf("%s %s %s" STR_NEWLINE, l, equal ? "!=" : "==", r);
-	__cunit_print_info(ctx, format);
+	__cunit_begin_message();
+	const size_t l_size = l ? strlen(l) : 0, r_size = r ? strlen(r) : 0;
+	if (equal) {
+		__cunit_print_str_diff(&out, l, l_size, r, r_size);
+	} else {
+		__cunit_print_text(&out, l, l_size);
+		cunit_buffer_puts(&out, " == ");
+		__cunit_print_text(&out, r, r_size);
+	}
+	__cunit_end_message(ctx, format);
 	return false;
 }
 
 bool __cunit_check_str_n(const cunit_context_t ctx, const char *l, const char *r, size_t size, const char *format, ...) {
+	__cunit_count_assertion();
 	if (l == r) { return true; }
 	if (l && r && !CUNIT_STRNCMP(l, r, size)) { return true; }
 
-	__cunit_print_not_expected(ctx);
-	printf("%s != %s" STR_NEWLINE, l, r);
-	__cunit_print_info(ctx, format);
+	__cunit_begin_message();
+	__cunit_print_str_diff(&out, l, __cunit_str_size(l, size), r, __cunit_str_size(r, size));
+	__cunit_end_message(ctx, format);
 	return false;
 }
 
 bool __cunit_check_str_case(const cunit_context_t ctx, const char *l, const char *r, const char *format, ...) {
+	__cunit_count_assertion();
 	if (l == r) { return true; }
 	if (l && r && !CUNIT_STRCASECMP(l, r)) { return true; }
 
-	__cunit_print_not_expected(ctx);
-	printf("%s != %s" STR_NEWLINE, l, r);
-	__cunit_print_info(ctx, format);
+	__cunit_begin_message();
+	cunit_buffer_printf(&out, "%s != %s", l ? l : "(null)", r ? r : "(null)");
+	__cunit_end_message(ctx, format);
 	return false;
 }
 
-static inline int __cunit_bytearray_compare(const uint8_t *l, const uint8_t *r, size_t size) {
-	for (size_t i = 0; i < size; i++) {
-		if (l[i] != r[i]) { return (l[i] > r[i]) - (l[i] < r[i]); }
+// The bytes per row of a hex diff, and the most differing rows one range of it shows.
+#define CUNIT_HEX_ROW    16
+#define CUNIT_HEX_ROWS   64
+#define CUNIT_HEX_DIGITS "0123456789ABCDEF"
+
+// Appends a row of a hex diff: a marker, the offset, up to 16 bytes in hex and as text.
+// The row is built whole and appended at once.
+static void __cunit_hex_row(cunit_buffer_t *out, char marker, size_t offset, int width, const uint8_t *p, size_t n) {
+	char  row[96];
+	char *c = row;
+	*c++    = '\n';
+	*c++    = marker;
+	*c++    = ' ';
+	for (int shift = (width - 1) * 4; shift >= 0; shift -= 4) { *c++ = CUNIT_HEX_DIGITS[(offset >> shift) & 15]; }
+	*c++ = ' ';
+	for (size_t i = 0; i < CUNIT_HEX_ROW; i++) {
+		*c++ = ' ';
+		if (i == CUNIT_HEX_ROW / 2) { *c++ = ' '; }
+		*c++ = i < n ? CUNIT_HEX_DIGITS[p[i] >> 4] : ' ';
+		*c++ = i < n ? CUNIT_HEX_DIGITS[p[i] & 15] : ' ';
+	}
+	*c++ = ' ';
+	*c++ = ' ';
+	*c++ = '|';
+	for (size_t i = 0; i < n; i++) { *c++ = p[i] >= 0x20 && p[i] < 0x7F ? (char)p[i] : '.'; }
+	*c++ = '|';
+	cunit_buffer_append(out, row, (size_t)(c - row));
+}
+
+// Appends the carets under the bytes that differ in a row of a hex diff.
+static void __cunit_hex_carets(cunit_buffer_t *out, int width, const uint8_t *l, const uint8_t *r, size_t n) {
+	char  row[96];
+	char *c = row;
+	*c++    = '\n';
+	for (int i = 0; i < width + 3; i++) { *c++ = ' '; }
+	char *last = c;
+	for (size_t i = 0; i < n; i++) {
+		*c++ = ' ';
+		if (i == CUNIT_HEX_ROW / 2) { *c++ = ' '; }
+		*c++ = l[i] != r[i] ? '^' : ' ';
+		*c++ = l[i] != r[i] ? '^' : ' ';
+		if (l[i] != r[i]) { last = c; }
+	}
+	cunit_buffer_append(out, row, (size_t)(last - row));
+}
+
+// Appends the rows of a hex diff from row `from` to row `to`: rows that are equal once, rows
+// that differ as a `-` row of `l`, a `+` row of `r` and the carets under the differences.
+static void __cunit_hex_rows(cunit_buffer_t *out, const uint8_t *l, const uint8_t *r, size_t size, size_t from, size_t to, int width) {
+	for (size_t row = from; row <= to; row++) {
+		const size_t offset = row * CUNIT_HEX_ROW;
+		const size_t n      = size - offset < CUNIT_HEX_ROW ? size - offset : CUNIT_HEX_ROW;
+		if (memcmp(l + offset, r + offset, n) == 0) {
+			__cunit_hex_row(out, ' ', offset, width, l + offset, n);
+			continue;
+		}
+		__cunit_hex_row(out, '-', offset, width, l + offset, n);
+		__cunit_hex_row(out, '+', offset, width, r + offset, n);
+		__cunit_hex_carets(out, width, l + offset, r + offset, n);
+	}
+}
+
+// Appends a hexdump diff of two buffers that first differ at `at`. Each range shows the rows
+// around a difference, with `context` rows before and after, and takes in later differences
+// whose context would touch it; after `ranges` ranges (0 for all) the rest is not searched.
+static void __cunit_hex_diff(cunit_buffer_t *out, const uint8_t *l, const uint8_t *r, size_t size, size_t at, size_t context, size_t ranges) {
+	const size_t rows  = (size + CUNIT_HEX_ROW - 1) / CUNIT_HEX_ROW;
+	int          width = 8;
+	while (width < 16 && ((size - 1) >> (width * 4)) != 0) { width++; }
+
+	size_t shown = 0, next = 0;  // The ranges shown, and the first row not shown yet.
+	while (at < size) {
+		if (ranges && shown == ranges) {
+			cunit_buffer_printf(out, "\n  ... more differences from offset %llu", (unsigned long long)at);
+			return;
+		}
+		size_t first = at / CUNIT_HEX_ROW, last = first;
+		at           = size;
+		while ((last + 1) * CUNIT_HEX_ROW < size) {
+			const size_t offset = (last + 1) * CUNIT_HEX_ROW;
+			const size_t found  = offset + cunit__mismatch(l + offset, r + offset, size - offset);
+			if (found == size) { break; }
+			if (found / CUNIT_HEX_ROW - last > 2 * context + 1 || found / CUNIT_HEX_ROW - first >= CUNIT_HEX_ROWS) {
+				at = found;
+				break;
+			}
+			last = found / CUNIT_HEX_ROW;
+		}
+
+		size_t from = first > context ? first - context : 0;
+		if (from < next) { from = next; }
+		if (shown && from > next) { cunit_buffer_puts(out, "\n  ..."); }
+		size_t to = last + context < rows - 1 ? last + context : rows - 1;
+		if (at < size && to >= at / CUNIT_HEX_ROW) { to = at / CUNIT_HEX_ROW - 1; }
+		__cunit_hex_rows(out, l, r, size, from, to, width);
+		next = to + 1;
+		shown++;
 	}
-	return 0;
 }
 
 bool __cunit_check_str_hex(const cunit_context_t ctx, const uint8_t *l, const uint8_t *r, size_t size, const char *format, ...) {
+	__cunit_count_assertion();
 	if (l == r) { return true; }
-	if (l && r && !__cunit_bytearray_compare(l, r, size)) { return true; }
-
-	__cunit_print_not_expected(ctx);
-	fputs("`", stdout);
-	__cunit_print_hex(l, size);
-	fputs("` != `", stdout);
-	__cunit_print_hex(r, size);
-	fputs("` " STR_NEWLINE, stdout);
-	__cunit_print_info(ctx, format);
+	size_t at = 0;
+	if (l && r) {
+		at = cunit__mismatch(l, r, size);
+		if (at == size) { return true; }
+	}
+
+	__cunit_begin_message();
+	if (!l || !r) {
+		cunit_buffer_puts(&out, l ? "memory != (null)" : "(null) != memory");
+	} else {
+		cunit_buffer_printf(&out, "memory differs at offset %llu of %llu:", (unsigned long long)at, (unsigned long long)size);
+		__cunit_hex_diff(&out, l, r, size, at, (size_t)cunit__registry.hex_context, (size_t)cunit__registry.hex_ranges);
+	}
+	__cunit_end_message(ctx, format);
+	return false;
+}
+
+// The number of elements shown on either side of the first mismatch of two arrays,
+// and of bytes for two blocks of memory.
+#define CUNIT_ARRAY_WINDOW 4
+#define CUNIT_MEM_WINDOW   8
+
+// Returns the size of an element of an integer array.
+static size_t __cunit_element_size(enum cunit_type type) {
+	switch (type) {
+		case CUnitType_Int16:
+		case CUnitType_Uint16: return 2;
+		case CUnitType_Int32:
+		case CUnitType_Uint32: return 4;
+		case CUnitType_Int64:
+		case CUnitType_Uint64: return 8;
+		default: return 1;
+	}
+}
+
+// Prints an element of an integer array, or a byte in hex for CUnitType_Invalid.
+static void __cunit_print_element(cunit_buffer_t *out, const void *array, size_t index, enum cunit_type type) {
+	const unsigned char *p = (const unsigned char *)array + index * __cunit_element_size(type);
+	switch (type) {
+		case CUnitType_Int8: __cunit_print_i8(out, (int8_t)*p); break;
+		case CUnitType_Int16: {
+			int16_t n;
+			memcpy(&n, p, sizeof(n));
+			__cunit_print_i16(out, n);
+		} break;
+		case CUnitType_Int32: {
+			int32_t n;
+			memcpy(&n, p, sizeof(n));
+			__cunit_print_i32(out, n);
+		} break;
+		case CUnitType_Int64: {
+			int64_t n;
+			memcpy(&n, p, sizeof(n));
+			__cunit_print_i64(out, n);
+		} break;
+		case CUnitType_Uint8: __cunit_print_u8(out, *p); break;
+		case CUnitType_Uint16: {
+			uint16_t n;
+			memcpy(&n, p, sizeof(n));
+			__cunit_print_u16(out, n);
+		} break;
+		case CUnitType_Uint32: {
+			uint32_t n;
+			memcpy(&n, p, sizeof(n));
+			__cunit_print_u32(out, n);
+		} break;
+		case CUnitType_Uint64: {
+			uint64_t n;
+			memcpy(&n, p, sizeof(n));
+			__cunit_print_u64(out, n);
+		} break;
+		default: cunit_buffer_printf(out, "%02X", *p); break;
+	}
+}
+
+// Prints the elements of an array within `window` of index `at`, marking the one at `at`.
+static void __cunit_print_window(cunit_buffer_t *out, const void *array, size_t count, size_t at, size_t window, enum cunit_type type) {
+	const size_t from = at > window ? at - window : 0;
+	const size_t to   = count - at > window ? at + window + 1 : count;
+	const char  *sep  = type == CUnitType_Invalid ? " " : ", ";
+	if (from > 0) { cunit_buffer_printf(out, "...%s", sep); }
+	for (size_t i = from; i < to; i++) {
+		if (i > from) { cunit_buffer_puts(out, sep); }
+		if (i == at) { cunit_buffer_putc(out, '['); }
+		__cunit_print_element(out, array, i, type);
+		if (i == at) { cunit_buffer_putc(out, ']'); }
+	}
+	if (to < count) { cunit_buffer_printf(out, "%s...", sep); }
+}
+
+bool __cunit_check_array_eq(const cunit_context_t ctx, const void *l, const void *r, size_t count, enum cunit_type type, const char *format, ...) {
+	__cunit_count_assertion();
+	if (l == r) { return true; }
+	const size_t size = __cunit_element_size(type);
+	size_t       at   = 0;
+	if (l && r) {
+		at = cunit__mismatch(l, r, count * size) / size;
+		if (at == count) { return true; }
+	}
+
+	__cunit_begin_message();
+	if (!l || !r) {
+		cunit_buffer_puts(&out, l ? "array != (null)" : "(null) != array");
+	} else {
+		cunit_buffer_printf(&out, "arrays differ at index %llu of %llu: {", (unsigned long long)at, (unsigned long long)count);
+		__cunit_print_window(&out, l, count, at, CUNIT_ARRAY_WINDOW, type);
+		cunit_buffer_puts(&out, "} != {");
+		__cunit_print_window(&out, r, count, at, CUNIT_ARRAY_WINDOW, type);
+		cunit_buffer_putc(&out, '}');
+	}
+	__cunit_end_message(ctx, format);
+	return false;
+}
+
+bool __cunit_check_mem_eq(const cunit_context_t ctx, const void *l, const void *r, size_t size, const char *format, ...) {
+	__cunit_count_assertion();
+	if (l == r) { return true; }
+	size_t at = 0;
+	if (l && r) {
+		at = cunit__mismatch(l, r, size);
+		if (at == size) { return true; }
+	}
+
+	__cunit_begin_message();
+	if (!l || !r) {
+		cunit_buffer_puts(&out, l ? "memory != (null)" : "(null) != memory");
+	} else {
+		cunit_buffer_printf(&out, "memory differs at offset %llu of %llu: `", (unsigned long long)at, (unsigned long long)size);
+		__cunit_print_window(&out, l, size, at, CUNIT_MEM_WINDOW, CUnitType_Invalid);
+		cunit_buffer_puts(&out, "` != `");
+		__cunit_print_window(&out, r, size, at, CUNIT_MEM_WINDOW, CUnitType_Invalid);
+		cunit_buffer_putc(&out, '`');
+	}
+	__cunit_end_message(ctx, format);
+	return false;
+}
+
+// How far past the first difference between two files a failure looks, so that the rest of a
+// large file is not read.
+#define CUNIT_FILE_WINDOW ((size_t)64 << 10)
+
+// Prints where two files first differ, and a hex diff of the bytes around it.
+static void __cunit_print_file_diff(cunit_buffer_t *out, const cunit_file_t *l, const cunit_file_t *r, size_t at) {
+	const size_t common = l->size < r->size ? l->size : r->size;
+	if (l->size == r->size) {
+		cunit_buffer_printf(out, " at offset %llu of %llu", (unsigned long long)at, (unsigned long long)l->size);
+	} else {
+		cunit_buffer_printf(out, " at offset %llu (%llu != %llu bytes)", (unsigned long long)at, (unsigned long long)l->size, (unsigned long long)r->size);
+	}
+	if (at == common) { return; }
+	const size_t size = common - at > CUNIT_FILE_WINDOW ? at + CUNIT_FILE_WINDOW : common;
+	cunit_buffer_putc(out, ':');
+	__cunit_hex_diff(out, l->data, r->data, size, at, (size_t)cunit__registry.hex_context, (size_t)cunit__registry.hex_ranges);
+}
+
+bool __cunit_check_matches_golden(const cunit_context_t ctx, const void *data, size_t size, const char *path, const char *format, ...) {
+	__cunit_count_assertion();
+	const cunit_file_t actual = {(const uint8_t *)data, size, false, false};
+	cunit_file_t       golden;
+	const bool         valid = path && (data || !size);
+	const bool         found = valid && cunit__file_open(path, &golden);
+	size_t             at    = 0;
+	if (found) {
+		at = cunit__file_mismatch(&golden, &actual, golden.size < size ? golden.size : size);
+		if (at == size && at == golden.size) {
+			cunit__file_close(&golden);
+			return true;
+		}
+	}
+
+	// In update mode, the golden file is rewritten rather than compared.
+	if (valid && cunit__registry.update_golden) {
+		if (found) { cunit__file_close(&golden); }
+		if (cunit__file_write(path, data, size)) { return true; }
+	}
+
+	__cunit_begin_message();
+	if (!valid) {
+		cunit_buffer_puts(&out, path ? "data is (null)" : "golden file is (null)");
+	} else if (cunit__registry.update_golden) {
+		cunit_buffer_printf(&out, "cannot write golden file `%s`", path);
+	} else if (!found) {
+		cunit_buffer_printf(&out, "cannot read golden file `%s`; set CUNIT_UPDATE_GOLDEN=1 to create it", path);
+	} else {
+		cunit_buffer_printf(&out, "golden file `%s` and data differ", path);
+		__cunit_print_file_diff(&out, &golden, &actual, at);
+		cunit__file_close(&golden);
+	}
+	__cunit_end_message(ctx, format);
+	return false;
+}
+
+bool __cunit_check_file_eq(const cunit_context_t ctx, const char *l_path, const char *r_path, const char *format, ...) {
+	__cunit_count_assertion();
+	cunit_file_t l, r;
+	const bool   l_found = l_path && cunit__file_open(l_path, &l);
+	const bool   r_found = r_path && cunit__file_open(r_path, &r);
+	size_t       at      = 0;
+	if (l_found && r_found) {
+		at = cunit__file_mismatch(&l, &r, l.size < r.size ? l.size : r.size);
+		if (at == l.size && at == r.size) {
+			cunit__file_close(&l);
+			cunit__file_close(&r);
+			return true;
+		}
+	}
+
+	__cunit_begin_message();
+	if (!l_found || !r_found) {
+		const char *path = !l_found ? l_path : r_path;
+		cunit_buffer_printf(&out, "cannot read file `%s`", path ? path : "(null)");
+	} else {
+		cunit_buffer_printf(&out, "files `%s` and `%s` differ", l_path, r_path);
+		__cunit_print_file_diff(&out, &l, &r, at);
+	}
+	if (l_found) { cunit__file_close(&l); }
+	if (r_found) { cunit__file_close(&r); }
+	__cunit_end_message(ctx, format);
+	return false;
+}
+
+// How far apart two numbers are, in the unit of a tolerance; infinite if only one is NaN.
+static double __cunit_float_distance(double l, double r, cunit_tolerance_kind_t kind) {
+	if (l != l || r != r) { return INFINITY; }
+	const double diff = fabs(l - r);
+	return kind == CUNIT_TOLERANCE_REL ? diff / fmax(fabs(l), fabs(r)) : diff;
+}
+static double __cunit_float_error(float l, float r, cunit_tolerance_kind_t kind) {
+	if (kind == CUNIT_TOLERANCE_ULPS && l == l && r == r) { return (double)cunit__float_ulps(l, r); }
+	return __cunit_float_distance(l, r, kind);
+}
+static double __cunit_double_error(double l, double r, cunit_tolerance_kind_t kind) {
+	if (kind == CUNIT_TOLERANCE_ULPS && l == l && r == r) { return (double)cunit__double_ulps(l, r); }
+	return __cunit_float_distance(l, r, kind);
+}
+
+// Prints a distance in the unit of a tolerance.
+static void __cunit_print_distance(cunit_buffer_t *out, double distance, cunit_tolerance_kind_t kind) {
+	switch (kind) {
+		case CUNIT_TOLERANCE_ULPS: cunit_buffer_printf(out, "%.0f ulps", distance); break;
+		case CUNIT_TOLERANCE_REL: cunit_buffer_printf(out, "%g relative", distance); break;
+		default: cunit_buffer_printf(out, "%g", distance); break;
+	}
+}
+
+// Describes the pairs of elements of two arrays that are not within a tolerance: how many
+// there are, the first, and the worst with its distance. Values are printed with `digits`
+// significant digits, enough to tell apart any two of their type.
+static void __cunit_print_near(cunit_buffer_t *out, size_t mismatches, size_t count, size_t first, size_t worst, double l, double r, int digits,
+							   double distance, cunit_tolerance_t tolerance) {
+	cunit_buffer_printf(out, "%llu of %llu elements differ by more than ", (unsigned long long)mismatches, (unsigned long long)count);
+	__cunit_print_distance(out, tolerance.value, tolerance.kind);
+	cunit_buffer_printf(out, "; first at index %llu, worst at index %llu: %.*g != %.*g (", (unsigned long long)first, (unsigned long long)worst, digits, l, digits, r);
+	__cunit_print_distance(out, distance, tolerance.kind);
+	cunit_buffer_putc(out, ')');
+}
+
+bool __cunit_check_float_array_near(const cunit_context_t ctx, const float *l, const float *r, size_t count, cunit_tolerance_t tolerance, const char *format, ...) {
+	__cunit_count_assertion();
+	if (l == r) { return true; }
+	size_t first = 0;
+	if (l && r) {
+		first = cunit__float_far(l, r, 0, count, tolerance);
+		if (first == count) { return true; }
+	}
+
+	__cunit_begin_message();
+	if (!l || !r) {
+		cunit_buffer_puts(&out, l ? "array != (null)" : "(null) != array");
+	} else {
+		size_t mismatches = 0, worst = first;
+		double largest    = -1;
+		for (size_t at = first; at < count; at = cunit__float_far(l, r, at + 1, count, tolerance), mismatches++) {
+			const double distance = __cunit_float_error(l[at], r[at], tolerance.kind);
+			if (distance > largest) {
+				largest = distance;
+				worst   = at;
+			}
+		}
+		__cunit_print_near(&out, mismatches, count, first, worst, l[worst], r[worst], 9, largest, tolerance);
+	}
+	__cunit_end_message(ctx, format);
+	return false;
+}
+
+bool __cunit_check_double_array_near(const cunit_context_t ctx, const double *l, const double *r, size_t count, cunit_tolerance_t tolerance, const char *format, ...) {
+	__cunit_count_assertion();
+	if (l == r) { return true; }
+	size_t first = 0;
+	if (l && r) {
+		first = cunit__double_far(l, r, 0, count, tolerance);
+		if (first == count) { return true; }
+	}
+
+	__cunit_begin_message();
+	if (!l || !r) {
+		cunit_buffer_puts(&out, l ? "array != (null)" : "(null) != array");
+	} else {
+		size_t mismatches = 0, worst = first;
+		double largest    = -1;
+		for (size_t at = first; at < count; at = cunit__double_far(l, r, at + 1, count, tolerance), mismatches++) {
+			const double distance = __cunit_double_error(l[at], r[at], tolerance.kind);
+			if (distance > largest) {
+				largest = distance;
+				worst   = at;
+			}
+		}
+		__cunit_print_near(&out, mismatches, count, first, worst, l[worst], r[worst], 17, largest, tolerance);
+	}
+	__cunit_end_message(ctx, format);
 	return false;
 }
 
 bool __cunit_compare_int(const cunit_context_t ctx, int l, int r, int cond, const char *format, ...) {
+	__cunit_count_assertion();
 	const enum cunit_compare_result result = (l > r) - (l < r);
-	__cunit_process_compare_result(result, cond, __cunit_print_i64(l), __cunit_print_i64(r), format);
+	__cunit_process_compare_result(result, cond, __cunit_print_i64(&out, l), __cunit_print_i64(&out, r), format);
 }
 
 bool __cunit_compare_int8(const cunit_context_t ctx, int8_t l, int8_t r, int cond, const char *format, ...) {
+	__cunit_count_assertion();
 	const enum cunit_compare_result result = (l > r) - (l < r);
-	__cunit_process_compare_result(result, cond, __cunit_print_i64(l), __cunit_print_i64(r), format);
+	__cunit_process_compare_result(result, cond, __cunit_print_i64(&out, l), __cunit_print_i64(&out, r), format);
 }
 
 bool __cunit_compare_int16(const cunit_context_t ctx, int16_t l, int16_t r, int cond, const char *format, ...) {
+	__cunit_count_assertion();
 	const enum cunit_compare_result result = (l > r) - (l < r);
-	__cunit_process_compare_result(result, cond, __cunit_print_i64(l), __cunit_print_i64(r), format);
+	__cunit_process_compare_result(result, cond, __cunit_print_i64(&out, l), __cunit_print_i64(&out, r), format);
 }
 
 bool __cunit_compare_int32(const cunit_context_t ctx, int32_t l, int32_t r, int cond, const char *format, ...) {
+	__cunit_count_assertion();
 	const enum cunit_compare_result result = (l > r) - (l < r);
-	__cunit_process_compare_result(result, cond, __cunit_print_i64(l), __cunit_print_i64(r), format);
+	__cunit_process_compare_result(result, cond, __cunit_print_i64(&out, l), __cunit_print_i64(&out, r), format);
 }
 
 bool __cunit_compare_int64(const cunit_context_t ctx, int64_t l, int64_t r, int cond, const char *format, ...) {
+	__cunit_count_assertion();
 	const enum cunit_compare_result result = (l > r) - (l < r);
-	__cunit_process_compare_result(result, cond, __cunit_print_i64(l), __cunit_print_i64(r), format);
+	__cunit_process_compare_result(result, cond, __cunit_print_i64(&out, l), __cunit_print_i64(&out, r), format);
 }
 
 bool __cunit_compare_uint(const cunit_context_t ctx, unsigned l, unsigned r, int cond, const char *format, ...) {
+	__cunit_count_assertion();
 	const enum cunit_compare_result result = (l > r) - (l < r);
-	__cunit_process_compare_result(result, cond, __cunit_print_u64(l), __cunit_print_u64(r), format);
+	__cunit_process_compare_result(result, cond, __cunit_print_u64(&out, l), __cunit_print_u64(&out, r), format);
 }
 
 bool __cunit_compare_uint8(const cunit_context_t ctx, uint8_t l, uint8_t r, int cond, const char *format, ...) {
+	__cunit_count_assertion();
 	const enum cunit_compare_result result = (l > r) - (l < r);
-	__cunit_process_compare_result(result, cond, __cunit_print_u64(l), __cunit_print_u64(r), format);
+	__cunit_process_compare_result(result, cond, __cunit_print_u64(&out, l), __cunit_print_u64(&out, r), format);
 }
 
 bool __cunit_compare_uint16(const cunit_context_t ctx, uint16_t l, uint16_t r, int cond, const char *format, ...) {
+	__cunit_count_assertion();
 	const enum cunit_compare_result result = (l > r) - (l < r);
-	__cunit_process_compare_result(result, cond, __cunit_print_u64(l), __cunit_print_u64(r), format);
+	__cunit_process_compare_result(result, cond, __cunit_print_u64(&out, l), __cunit_print_u64(&out, r), format);
 }
 
 bool __cunit_compare_uint32(const cunit_context_t ctx, uint32_t l, uint32_t r, int cond, const char *format, ...) {
+	__cunit_count_assertion();
 	const enum cunit_compare_result result = (l > r) - (l < r);
-	__cunit_process_compare_result(result, cond, __cunit_print_u64(l), __cunit_print_u64(r), format);
+	__cunit_process_compare_result(result, cond, __cunit_print_u64(&out, l), __cunit_print_u64(&out, r), format);
 }
 
 bool __cunit_compare_uint64(const cunit_context_t ctx, uint64_t l, uint64_t r, int cond, const char *format, ...) {
+	__cunit_count_assertion();
 	const enum cunit_compare_result result = (l > r) - (l < r);
-	__cunit_process_compare_result(result, cond, __cunit_print_u64(l), __cunit_print_u64(r), format);
+	__cunit_process_compare_result(result, cond, __cunit_print_u64(&out, l), __cunit_print_u64(&out, r), format);
 }
 
 bool __cunit_check_any_in_array(const cunit_context_t ctx, const cunit_value_t value, const void *array, size_t size, const char *format, ...) {
+	__cunit_count_assertion();
 	if (__cunit_check_any_is_in_array(value, array, size)) { return true; }
 
-	__cunit_print_not_expected(ctx);
-	__cunit_value_print(&value);
-	fputs(" is not in array" STR_NEWLINE, stdout);
-	__cunit_print_info(ctx, format);
+	__cunit_begin_message();
+	__cunit_value_format(&out, &value);
+	cunit_buffer_puts(&out, " is not in array");
+	__cunit_end_message(ctx, format);
 	return false;
 }
 
 bool __cunit_check_any_not_in_array(const cunit_context_t ctx, const cunit_value_t value, const void *array, size_t size, const char *format, ...) {
+	__cunit_count_assertion();
 	if (!__cunit_check_any_is_in_array(value, array, size)) { return true; }
 
-	__cunit_print_not_expected(ctx);
-	__cunit_value_print(&value);
-	fputs(" is in array" STR_NEWLINE, stdout);
-	__cunit_print_info(ctx, format);
+	__cunit_begin_message();
+	__cunit_value_format(&out, &value);
+	cunit_buffer_puts(&out, " is in array");
+	__cunit_end_message(ctx, format);
+	return false;
+}
+
+bool __cunit_check_in_set(const cunit_context_t ctx, const cunit_value_t value, const cunit_set_t *set, bool in, const char *format, ...) {
+	__cunit_count_assertion();
+	if (set && cunit_set_contains(set, value) == in) { return true; }
+
+	__cunit_begin_message();
+	if (!set) {
+		cunit_buffer_puts(&out, "set is (null)");
+	} else {
+		__cunit_value_format(&out, &value);
+		cunit_buffer_puts(&out, in ? " is not in set" : " is in set");
+	}
+	__cunit_end_message(ctx, format);
+	return false;
+}
+
+bool __cunit_check_all_in_set(const cunit_context_t ctx, const void *array, size_t count, const cunit_set_t *set, const char *format, ...) {
+	__cunit_count_assertion();
+	size_t first   = 0;
+	size_t missing = 0;
+	if (set && (array || !count)) {
+		missing = cunit__set_missing(set, array, count, &first);
+		if (!missing) { return true; }
+	}
+
+	__cunit_begin_message();
+	if (!set || !array) {
+		cunit_buffer_puts(&out, set ? "array is (null)" : "set is (null)");
+	} else {
+		const cunit_value_t value = cunit__set_value(set, array, first);
+		cunit_buffer_printf(&out, "%llu of %llu elements are not in set; first at index %llu: ", (unsigned long long)missing, (unsigned long long)count,
+							(unsigned long long)first);
+		__cunit_value_format(&out, &value);
+	}
+	__cunit_end_message(ctx, format);
+	return false;
+}
+
+bool __cunit_check_alloc(const cunit_context_t ctx, cunit_alloc_counter_t counter, uint64_t limit, const char *format, ...) {
+	__cunit_count_assertion();
+	static const char *const names[] = {"allocations", "bytes allocated", "peak bytes", "bytes not freed"};
+
+	cunit_alloc_stats_t stats;
+	if (!cunit_alloc_stats(&stats)) {
+		__cunit_begin_message();
+		cunit_buffer_puts(&out, "allocations are not tracked (link the test program with cunit::alloc)");
+		__cunit_end_message(ctx, format);
+		return false;
+	}
+	const uint64_t values[] = {stats.count, stats.bytes, stats.peak, stats.unfreed};
+	if (values[counter] <= limit) { return true; }
+
+	__cunit_begin_message();
+	cunit_buffer_printf(&out, "%llu %s > %llu", (unsigned long long)values[counter], names[counter], (unsigned long long)limit);
+	__cunit_end_message(ctx, format);
+	return false;
+}
+
+// The operands of the last comparison that failed on the calling thread.
+static CUNIT_THREAD_LOCAL struct {
+	cunit_value_t l;       // The left operand.
+	cunit_value_t r;       // The right operand.
+	int           result;  // Their order, see CUNIT_NUMBER_COMPARE().
+} __cunit_failed;
+
+// Stores an integer of the given type in a value.
+static void __cunit_value_set_int(cunit_value_t *value, int64_t n, enum cunit_type type) {
+	value->type = type;
+	switch (type) {
+		case CUnitType_Bool: value->d.b = n != 0; break;
+		case CUnitType_Char: value->d.c = (char)n; break;
+		case CUnitType_Int8: value->d.i8 = (int8_t)n; break;
+		case CUnitType_Int16: value->d.i16 = (int16_t)n; break;
+		case CUnitType_Int32: value->d.i32 = (int32_t)n; break;
+		default: value->d.i64 = n; break;
+	}
+}
+
+// Stores an unsigned integer of the given type in a value.
+static void __cunit_value_set_uint(cunit_value_t *value, uint64_t n, enum cunit_type type) {
+	value->type = type;
+	switch (type) {
+		case CUnitType_Uint8: value->d.u8 = (uint8_t)n; break;
+		case CUnitType_Uint16: value->d.u16 = (uint16_t)n; break;
+		case CUnitType_Uint32: value->d.u32 = (uint32_t)n; break;
+		default: value->d.u64 = n; break;
+	}
+}
+
+bool __cunit_compare_failed_int(int64_t l, int64_t r, int result, enum cunit_type type) {
+	__cunit_value_set_int(&__cunit_failed.l, l, type);
+	__cunit_value_set_int(&__cunit_failed.r, r, type);
+	__cunit_failed.result = result;
+	return false;
+}
+
+bool __cunit_compare_failed_uint(uint64_t l, uint64_t r, int result, enum cunit_type type) {
+	__cunit_value_set_uint(&__cunit_failed.l, l, type);
+	__cunit_value_set_uint(&__cunit_failed.r, r, type);
+	__cunit_failed.result = result;
+	return false;
+}
+
+bool __cunit_compare_failed_float(double l, double r, int result, enum cunit_type type) {
+	__cunit_failed.l.type = __cunit_failed.r.type = type;
+	if (type == CUnitType_Float32) {
+		__cunit_failed.l.d.f32 = (float)l;
+		__cunit_failed.r.d.f32 = (float)r;
+	} else {
+		__cunit_failed.l.d.f64 = l;
+		__cunit_failed.r.d.f64 = r;
+	}
+	__cunit_failed.result = result;
+	return false;
+}
+
+bool __cunit_compare_failed_ptr(const void *l, const void *r, int result) {
+	__cunit_failed.l.type  = __cunit_failed.r.type = CUnitType_Pointer;
+	__cunit_failed.l.d.ptr = (void *)l;
+	__cunit_failed.r.d.ptr = (void *)r;
+	__cunit_failed.result  = result;
+	return false;
+}
+
+bool __cunit_compare_report(const cunit_context_t ctx, const char *format, ...) {
+	__cunit_begin_message();
+	__cunit_value_format(&out, &__cunit_failed.l);
+	cunit_buffer_putc(&out, ' ');
+	cunit_buffer_puts(&out, CUNIT_COMPARE_RESULT_TO_STR(__cunit_failed.result));
+	cunit_buffer_putc(&out, ' ');
+	__cunit_value_format(&out, &__cunit_failed.r);
+	__cunit_end_message(ctx, format);
 	return false;
 }
@@ -0,0 +1,217 @@
+#include "registry.h"
+
+#ifdef _WIN32
+#include <io.h>
+#define isatty _isatty
+#define fileno _fileno
+#else
+#include <unistd.h>
+#endif
+
+// Each report is formatted here, then handed to stdout, whose buffer it shares
+// with the output of the tests so that both keep their order.
+static cunit_buffer_t cunit__console;
+
+// The size of the stdout buffer, so that output is written in large chunks.
+#define CUNIT_CONSOLE_BUFFER_SIZE (64 * 1024)
+
+void cunit__console_init(void) {
+	// A terminal stays line-buffered, for whoever is watching the run.
+	if (!isatty(fileno(stdout))) { setvbuf(stdout, NULL, _IOFBF, CUNIT_CONSOLE_BUFFER_SIZE); }
+}
+
+// Hands the formatted report to stdout.
+static inline void cunit__console_write(void) {
+	if (cunit__console.size) { fwrite(cunit__console.data, 1, cunit__console.size, stdout); }
+	cunit_buffer_clear(&cunit__console);
+}
+
+// Formats a duration in seconds with a unit that keeps it readable.
+static const char *cunit__format_seconds(char *buf, size_t size, double seconds) {
+	if (seconds >= 1.0) {
+		snprintf(buf, size, "%.2f s", seconds);
+	} else if (seconds >= 1e-3) {
+		snprintf(buf, size, "%.2f ms", seconds * 1e3);
+	} else if (seconds >= 1e-6) {
+		snprintf(buf, size, "%.2f us", seconds * 1e6);
+	} else {
+		snprintf(buf, size, "%.2f ns", seconds * 1e9);
+	}
+	return buf;
+}
+
+// Formats the number of checks and assertions made in `seconds`, with their rate if it is known.
+static const char *cunit__format_assertions(char *buf, size_t size, uint64_t assertions, double seconds) {
+	const int length = snprintf(buf, size, "%llu assertion%s", (unsigned long long)assertions, assertions == 1 ? "" : "s");
+	if (!assertions || seconds <= 0 || length < 0 || (size_t)length >= size) { return buf; }
+	const double rate = (double)assertions / seconds;
+	if (rate >= 1e9) {
+		snprintf(buf + length, size - (size_t)length, " at %.2f G/s", rate / 1e9);
+	} else if (rate >= 1e6) {
+		snprintf(buf + length, size - (size_t)length, " at %.2f M/s", rate / 1e6);
+	} else if (rate >= 1e3) {
+		snprintf(buf + length, size - (size_t)length, " at %.2f K/s", rate / 1e3);
+	} else {
+		snprintf(buf + length, size - (size_t)length, " at %.2f/s", rate);
+	}
+	return buf;
+}
+
+static void cunit__console_suite_begin(void *data, const char *suite) {
+	(void)data;
+	cunit_buffer_printf(&cunit__console, "\n\033[33mRunning test suite: %s\033[0m\n", suite);
+	cunit__console_write();
+}
+
+// Prints where a failure happened in the given color, unless it is not in the test's code.
+static void cunit__console_where(const cunit_failure_t *failure, const char *color) {
+	if (!failure->ctx.file) { return; }
+	cunit_buffer_printf(&cunit__console, "\033[%sm%s:%d\033[0m ", color, __cunit_relative(failure->ctx.file), failure->ctx.line);
+}
+
+static void cunit__console_failure(void *data, const cunit_failure_t *failure) {
+	(void)data;
+	if (failure->fatal) {
+		cunit__console_where(failure, "31;2");
+		cunit_buffer_puts(&cunit__console, "test failed!" STR_NEWLINE);
+		if (cunit__registry.test_running && cunit__registry.error_mode == CUNIT_ERROR_MODE_FAIL_FAST) {
+			cunit_buffer_puts(&cunit__console, "[ \033[31mFAILED\033[0m ] Stopping on first failure\n");
+		}
+	} else {
+		cunit__console_where(failure, "33;2");
+		cunit_buffer_printf(&cunit__console, "not expected: %s" STR_NEWLINE, failure->message ? failure->message : "");
+	}
+	if (failure->note) {
+		cunit__console_where(failure, "37;2");
+		cunit_buffer_printf(&cunit__console, "%s" STR_NEWLINE, failure->note);
+	}
+	cunit__console_write();
+}
+
+// Prints the measurement of a benchmark below its result line.
+static void cunit__console_bench(const cunit_bench_stats_t *stats) {
+	char median[32], min[32], mean[32], stddev[32], mad[32];
+	cunit_buffer_printf(&cunit__console, "             median %s, min %s, mean %s +- %s, MAD %s per iteration (%llu iterations x %d)\n",
+						cunit__format_seconds(median, sizeof(median), stats->median * 1e-9), cunit__format_seconds(min, sizeof(min), stats->min * 1e-9),
+						cunit__format_seconds(mean, sizeof(mean), stats->mean * 1e-9), cunit__format_seconds(stddev, sizeof(stddev), stats->stddev * 1e-9),
+						cunit__format_seconds(mad, sizeof(mad), stats->mad * 1e-9), (unsigned long long)stats->iterations, stats->repetitions);
+}
+
+// Prints the IPC and the misses per thousand instructions (MPKI) of a test
+// body below its result line, or the raw counts without instructions.
+static void cunit__console_counters(const cunit_counters_t *counters) {
+	static const char *const names[] = {"cycles", "instructions", "branch misses", "cache misses"};
+	const uint64_t           values[] = {counters->cycles, counters->instructions, counters->branch_misses, counters->cache_misses};
+	const unsigned           available = counters->available;
+	const char              *separator = "";
+
+	cunit_buffer_puts(&cunit__console, "            ");
+	if (!(available & CUNIT_COUNTER_INSTRUCTIONS) || !counters->instructions) {
+		for (int i = 0; i < 4; i++) {
+			if (!(available & (1u << i))) { continue; }
+			cunit_buffer_printf(&cunit__console, "%s %llu %s", separator, (unsigned long long)values[i], names[i]);
+			separator = ",";
+		}
+		cunit_buffer_puts(&cunit__console, "\n");
+		return;
+	}
+	if ((available & CUNIT_COUNTER_CYCLES) && counters->cycles) {
+		cunit_buffer_printf(&cunit__console, " IPC %.2f", (double)counters->instructions / (double)counters->cycles);
+		separator = ",";
+	}
+	const double thousands = (double)counters->instructions / 1000.0;
+	if (available & CUNIT_COUNTER_BRANCH_MISSES) {
+		cunit_buffer_printf(&cunit__console, "%s branch MPKI %.2f", separator, (double)counters->branch_misses / thousands);
+		separator = ",";
+	}
+	if (available & CUNIT_COUNTER_CACHE_MISSES) { cunit_buffer_printf(&cunit__console, "%s cache MPKI %.2f", separator, (double)counters->cache_misses / thousands); }
+	cunit_buffer_printf(&cunit__console, " (%llu instructions)\n", (unsigned long long)counters->instructions);
+}
+
+// Prints the heap use of a test below its result line, if it allocated.
+static void cunit__console_alloc(const cunit_alloc_stats_t *stats) {
+	if (!stats->count) { return; }
+	cunit_buffer_printf(&cunit__console, "             %llu allocation%s, %llu bytes, peak %llu bytes", (unsigned long long)stats->count,
+						stats->count == 1 ? "" : "s", (unsigned long long)stats->bytes, (unsigned long long)stats->peak);
+	if (stats->unfreed_count) {
+		cunit_buffer_printf(&cunit__console, ", \033[33m%llu bytes in %llu block%s not freed\033[0m", (unsigned long long)stats->unfreed,
+							(unsigned long long)stats->unfreed_count, stats->unfreed_count == 1 ? "" : "s");
+	}
+	cunit_buffer_puts(&cunit__console, "\n");
+}
+
+static void cunit__console_test_end(void *data, const cunit_test_report_t *test) {
+	(void)data;
+	if (test->status == CUNIT_STATUS_CRASHED) {
+		if (test->signal) {
+			cunit_buffer_printf(&cunit__console, "[ \033[31mFAILED\033[0m ] %s (crashed with signal %d)\n", test->name, test->signal);
+		} else {
+			cunit_buffer_printf(&cunit__console, "[ \033[31mFAILED\033[0m ] %s (exited with code %d)\n", test->name, test->exit_code);
+		}
+	} else if (test->status == CUNIT_STATUS_TIMEOUT) {
+		char elapsed[32];
+		cunit_buffer_printf(&cunit__console, "[ \033[31mFAILED\033[0m ] %s (timed out after %s)\n", test->name,
+							cunit__format_seconds(elapsed, sizeof(elapsed), test->timing->total.wall));
+	} else if (test->status == CUNIT_STATUS_FAILED) {
+		cunit_buffer_printf(&cunit__console, "[ \033[31mFAILED\033[0m ] %s%s\n", test->name, cunit__zero_assertions(test) ? " (made no assertions)" : "");
+	} else {
+		cunit_buffer_printf(&cunit__console, "[ \033[32mPASSED\033[0m ] %s\n", test->name);
+		if (cunit__zero_assertions(test)) { cunit_buffer_puts(&cunit__console, "             \033[33mwarning: made no assertions\033[0m\n"); }
+	}
+	if (test->bench) { cunit__console_bench(test->bench); }
+	if (test->counters) { cunit__console_counters(test->counters); }
+	if (test->alloc) { cunit__console_alloc(test->alloc); }
+	cunit__console_write();
+}
+
+static void cunit__console_suite_end(void *data, const cunit_suite_report_t *suite) {
+	(void)data;
+	char wall[32], cpu[32], assertions[64];
+	cunit_buffer_printf(&cunit__console, "\033[33mSuite Summary: %d passed, %d failed, %d total (%s wall, %s cpu, %s)\033[0m\n", suite->passed,
+						suite->failed, suite->total, cunit__format_seconds(wall, sizeof(wall), suite->timing->total.wall),
+						cunit__format_seconds(cpu, sizeof(cpu), suite->timing->total.cpu),
+						cunit__format_assertions(assertions, sizeof(assertions), suite->assertions, suite->timing->total.wall));
+	cunit__console_write();
+}
+
+static void cunit__console_run_end(void *data, const cunit_run_report_t *run) {
+	(void)data;
+	char assertions[64];
+	cunit_buffer_printf(&cunit__console, "\n\033[33mFinal Summary: %d passed, %d failed, %d total, %s\033[0m\n", run->passed, run->failed, run->total,
+						cunit__format_assertions(assertions, sizeof(assertions), run->assertions, run->duration));
+	if (run->unisolated > 0) {
+		cunit_buffer_printf(&cunit__console, "\033[33m%d test%s ran in-process without crash isolation, since no worker could be started\033[0m\n",
+							run->unisolated, run->unisolated == 1 ? "" : "s");
+	}
+	if (run->slowest_count > 0) {
+		cunit_buffer_printf(&cunit__console, "\033[33mSlowest %d test%s:\033[0m\n", run->slowest_count, run->slowest_count == 1 ? "" : "s");
+	}
+	for (int i = 0; i < run->slowest_count; i++) {
+		const cunit_test_report_t *test = &run->slowest[i];
+		char                       wall[32], cpu[32], setup[32], body[32], teardown[32];
+		cunit_buffer_printf(&cunit__console, "  %10s wall %10s cpu  %s / %s (setup %s, body %s, teardown %s)\n",
+							cunit__format_seconds(wall, sizeof(wall), test->timing->total.wall),
+							cunit__format_seconds(cpu, sizeof(cpu), test->timing->total.cpu), test->suite, test->name,
+							cunit__format_seconds(setup, sizeof(setup), test->timing->setup.wall),
+							cunit__format_seconds(body, sizeof(body), test->timing->body.wall),
+							cunit__format_seconds(teardown, sizeof(teardown), test->timing->teardown.wall));
+	}
+	cunit__console_write();
+}
+
+static void cunit__console_flush(void *data) {
+	(void)data;
+	fflush(stdout);
+}
+
+const cunit_reporter_t cunit__console_reporter = {
+	NULL,                        // data
+	NULL,                        // run_begin
+	cunit__console_suite_begin,  // suite_begin
+	NULL,                        // test_begin
+	cunit__console_failure,      // failure
+	cunit__console_test_end,     // test_end
+	cunit__console_suite_end,    // suite_end
+	cunit__console_run_end,      // run_end
+	cunit__console_flush,        // flush
+};
@@ -0,0 +1,117 @@
+#include "registry.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+// The event of each counter, in the order of cunit_counter_t.
+static const uint64_t cunit__counter_events[CUNIT_COUNTERS] = {
+	PERF_COUNT_HW_CPU_CYCLES,
+	PERF_COUNT_HW_INSTRUCTIONS,
+	PERF_COUNT_HW_BRANCH_MISSES,
+	PERF_COUNT_HW_CACHE_MISSES,
+};
+
+// Opens a counter of the calling thread in user space only: disabled on its own,
+// or in the group of `leader`, which enables and disables it.
+static int cunit__counter_open(uint64_t event, int leader) {
+	struct perf_event_attr attr;
+	memset(&attr, 0, sizeof(attr));
+	attr.type           = PERF_TYPE_HARDWARE;
+	attr.size           = sizeof(attr);
+	attr.config         = event;
+	attr.disabled       = leader < 0;
+	attr.exclude_kernel = 1;
+	attr.exclude_hv     = 1;
+	attr.read_format    = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING | PERF_FORMAT_GROUP;
+	return (int)syscall(SYS_perf_event_open, &attr, 0, -1, leader, 0);
+}
+
+// Returns the ioctl flag that makes an operation on counter `i` apply to its whole group.
+static inline int cunit__counter_flag(const cunit_perf_t *perf, int i) { return i == 0 && perf->grouped ? PERF_IOC_FLAG_GROUP : 0; }
+
+// Returns whether counter `i` is enabled and read through the group leader instead of its own descriptor.
+static inline bool cunit__counter_member(const cunit_perf_t *perf, int i) { return i > 0 && (perf->grouped >> i & 1); }
+
+// Opens the counters of the calling thread, keeping those the kernel grants.
+static void cunit__counters_open(cunit_perf_t *perf) {
+	if (perf->opened && perf->pid != (int)getpid()) {
+		// Inherited from the parent: they count the parent's thread, not this one.
+		for (int i = 0; i < CUNIT_COUNTERS; i++) {
+			if (perf->fds[i] >= 0) { close(perf->fds[i]); }
+		}
+		perf->opened = false;
+	}
+	if (perf->opened) { return; }
+	perf->opened  = true;
+	perf->pid     = (int)getpid();
+	perf->grouped = 0;
+	// The cycles lead a group, so that the counts of a test are taken over the same
+	// time even when the kernel multiplexes them. A counter the group refuses counts on its own.
+	perf->fds[0] = cunit__counter_open(cunit__counter_events[0], -1);
+	for (int i = 1; i < CUNIT_COUNTERS; i++) {
+		perf->fds[i] = perf->fds[0] >= 0 ? cunit__counter_open(cunit__counter_events[i], perf->fds[0]) : -1;
+		if (perf->fds[i] >= 0) {
+			perf->grouped |= 1 << 0 | 1 << i;
+		} else {
+			perf->fds[i] = cunit__counter_open(cunit__counter_events[i], -1);
+		}
+	}
+}
+#endif
+
+void cunit__counters_start(cunit_perf_t *perf) {
+	if (!cunit__registry.counters) { return; }
+#ifdef __linux__
+	cunit__counters_open(perf);
+	for (int i = 0; i < CUNIT_COUNTERS; i++) {
+		if (perf->fds[i] < 0 || cunit__counter_member(perf, i)) { continue; }
+		ioctl(perf->fds[i], PERF_EVENT_IOC_RESET, cunit__counter_flag(perf, i));
+		ioctl(perf->fds[i], PERF_EVENT_IOC_ENABLE, cunit__counter_flag(perf, i));
+	}
+#else
+	(void)perf;
+#endif
+}
+
+void cunit__counters_stop(cunit_perf_t *perf, cunit_counters_t *counters) {
+	memset(counters, 0, sizeof(cunit_counters_t));
+	if (!cunit__registry.counters || !perf->opened) { return; }
+#ifdef __linux__
+	uint64_t *const values[CUNIT_COUNTERS] = {&counters->cycles, &counters->instructions, &counters->branch_misses, &counters->cache_misses};
+	for (int i = 0; i < CUNIT_COUNTERS; i++) {
+		if (perf->fds[i] >= 0 && !cunit__counter_member(perf, i)) { ioctl(perf->fds[i], PERF_EVENT_IOC_DISABLE, cunit__counter_flag(perf, i)); }
+	}
+	for (int i = 0; i < CUNIT_COUNTERS; i++) {
+		if (perf->fds[i] < 0 || cunit__counter_member(perf, i)) { continue; }
+		// The number of counters, the time they were enabled and the time they were on
+		// the CPU, then the count of each: the leader's, then its members' in order.
+		uint64_t      data[3 + CUNIT_COUNTERS];
+		const ssize_t size = read(perf->fds[i], data, sizeof(data));
+		if (size < (ssize_t)(3 * sizeof(uint64_t)) || (size_t)size != (3 + data[0]) * sizeof(uint64_t) || !data[2]) { continue; }
+		const int members = cunit__counter_flag(perf, i) ? perf->grouped : 1 << i;
+		for (int k = i, n = 0; k < CUNIT_COUNTERS && n < (int)data[0]; k++) {
+			if (!(members >> k & 1)) { continue; }
+			const uint64_t count = data[3 + n++];
+			*values[k]           = data[2] < data[1] ? (uint64_t)((double)count * (double)data[1] / (double)data[2]) : count;
+			counters->available |= 1u << k;
+		}
+	}
+#else
+	(void)perf;
+#endif
+}
+
+void cunit__counters_close(cunit_perf_t *perf) {
+#ifdef __linux__
+	if (!perf->opened || perf->pid != (int)getpid()) { return; }
+	for (int i = 0; i < CUNIT_COUNTERS; i++) {
+		if (perf->fds[i] >= 0) { close(perf->fds[i]); }
+	}
+#endif
+	perf->opened = false;
+}
@@ -0,0 +1,190 @@
+#include "db.h"
+
+// Hashes a suite/test pair (FNV-1a).
+static size_t cunit__db_hash(const char *suite, const char *test) {
+	uint64_t hash = 14695981039346656037ull;
+	for (const char *p = suite; *p; p++) { hash = (hash ^ (uint8_t)*p) * 1099511628211ull; }
+	hash = (hash ^ 0x1f) * 1099511628211ull;
+	for (const char *p = test; *p; p++) { hash = (hash ^ (uint8_t)*p) * 1099511628211ull; }
+	return (size_t)hash;
+}
+
+// Returns the slot holding suite/test, or the empty slot where it belongs.
+static size_t cunit__db_slot(const cunit_db_t *db, const char *suite, const char *test) {
+	const size_t mask = db->nslots - 1;
+	for (size_t slot = cunit__db_hash(suite, test) & mask;; slot = (slot + 1) & mask) {
+		const size_t index = db->slots[slot];
+		if (index == 0) { return slot; }
+		const cunit_db_entry_t *entry = &db->entries[index - 1];
+		if (strcmp(entry->suite, suite) == 0 && strcmp(entry->test, test) == 0) { return slot; }
+	}
+}
+
+// Doubles the hash index and reinserts every entry.
+static bool cunit__db_rehash(cunit_db_t *db) {
+	const size_t nslots = db->nslots ? db->nslots * 2 : 64;
+	size_t      *slots  = (size_t *)calloc(nslots, sizeof(size_t));
+	if (!slots) { return false; }
+	free(db->slots);
+	db->slots  = slots;
+	db->nslots = nslots;
+	for (size_t i = 0; i < db->count; i++) { db->slots[cunit__db_slot(db, db->entries[i].suite, db->entries[i].test)] = i + 1; }
+	return true;
+}
+
+static char *cunit__db_strdup(const char *s) {
+	const size_t size = strlen(s) + 1;
+	char        *copy = (char *)malloc(size);
+	if (copy) { memcpy(copy, s, size); }
+	return copy;
+}
+
+void cunit__db_free(cunit_db_t *db) {
+	for (size_t i = 0; i < db->count; i++) {
+		free(db->entries[i].suite);
+		free(db->entries[i].test);
+	}
+	free(db->entries);
+	free(db->slots);
+	memset(db, 0, sizeof(cunit_db_t));
+}
+
+cunit_db_entry_t *cunit__db_find(const cunit_db_t *db, const char *suite, const char *test) {
+	if (!db->nslots) { return NULL; }
+	const size_t index = db->slots[cunit__db_slot(db, suite, test)];
+	return index ? &db->entries[index - 1] : NULL;
+}
+
+cunit_db_entry_t *cunit__db_put(cunit_db_t *db, const char *suite, const char *test) {
+	cunit_db_entry_t *found = cunit__db_find(db, suite, test);
+	if (found) { return found; }
+
+	// Keep the load factor at or below one half.
+	if ((db->count + 1) * 2 > db->nslots && !cunit__db_rehash(db)) { return NULL; }
+	if (db->count == db->capacity) {
+		const size_t      capacity = db->capacity ? db->capacity * 2 : 32;
+		cunit_db_entry_t *entries  = (cunit_db_entry_t *)realloc(db->entries, capacity * sizeof(cunit_db_entry_t));
+		if (!entries) { return NULL; }
+		db->entries  = entries;
+		db->capacity = capacity;
+	}
+
+	cunit_db_entry_t *entry = &db->entries[db->count];
+	memset(entry, 0, sizeof(cunit_db_entry_t));
+	entry->suite = cunit__db_strdup(suite);
+	entry->test  = cunit__db_strdup(test);
+	if (!entry->suite || !entry->test) {
+		free(entry->suite);
+		free(entry->test);
+		return NULL;
+	}
+	db->slots[cunit__db_slot(db, suite, test)] = ++db->count;
+	return entry;
+}
+
+// Writes a name, escaping the characters that delimit fields and records.
+static void cunit__db_write_name(FILE *file, const char *name) {
+	for (const char *p = name; *p; p++) {
+		switch (*p) {
+			case '\t': fputs("\\t", file); break;
+			case '\n': fputs("\\n", file); break;
+			case '\\': fputs("\\\\", file); break;
+			default: fputc(*p, file); break;
+		}
+	}
+}
+
+// Unescapes a name in place, stopping at the next tab or end of line.
+// Returns a pointer to the character after the field, or NULL at end of line.
+static char *cunit__db_read_name(char *field) {
+	char *out = field;
+	char *p   = field;
+	for (; *p && *p != '\t' && *p != '\n' && *p != '\r'; p++) {
+		if (*p == '\\' && p[1]) {
+			p++;
+			*out++ = *p == 't' ? '\t' : *p == 'n' ? '\n' : *p;
+		} else {
+			*out++ = *p;
+		}
+	}
+	const bool more = *p == '\t';
+	*out            = '\0';
+	return more ? p + 1 : NULL;
+}
+
+// Reads one line of any length into a growing buffer. Returns false at EOF.
+static bool cunit__db_read_line(FILE *file, char **buf, size_t *size) {
+	size_t length = 0;
+	for (;;) {
+		if (*size - length < 2) {
+			const size_t grown = *size ? *size * 2 : 256;
+			char        *next  = (char *)realloc(*buf, grown);
+			if (!next) { return false; }
+			*buf  = next;
+			*size = grown;
+		}
+		if (!fgets(*buf + length, (int)(*size - length), file)) { return length > 0; }
+		length += strlen(*buf + length);
+		if (length > 0 && (*buf)[length - 1] == '\n') { return true; }
+	}
+}
+
+bool cunit__db_load(cunit_db_t *db, const char *path) {
+	FILE *file = fopen(path, "r");
+	if (!file) { return false; }
+
+	char  *line = NULL;
+	size_t size = 0;
+	while (cunit__db_read_line(file, &line, &size)) {
+		if (line[0] == '#' || line[0] == '\n') { continue; }
+		char *suite = line;
+		char *test  = cunit__db_read_name(suite);
+		if (!test) { continue; }
+		char *values = cunit__db_read_name(test);
+
+		cunit_db_entry_t *entry = cunit__db_put(db, suite, test);
+		if (!entry) { break; }
+		for (int i = 0; values && i < CUNIT_DB_VALUES; i++) {
+			char *end;
+			entry->values[i] = strtod(values, &end);
+			values           = *end == '\t' ? end + 1 : NULL;
+		}
+	}
+	free(line);
+	fclose(file);
+	return true;
+}
+
+bool cunit__db_save(const cunit_db_t *db, const char *path) {
+	const size_t length = strlen(path);
+	char        *temp   = (char *)malloc(length + 5);
+	if (!temp) { return false; }
+	memcpy(temp, path, length);
+	memcpy(temp + length, ".tmp", 5);
+
+	FILE *file = fopen(temp, "w");
+	if (!file) {
+		free(temp);
+		return false;
+	}
+	fputs("# cunit\n", file);
+	for (size_t i = 0; i < db->count; i++) {
+		const cunit_db_entry_t *entry = &db->entries[i];
+		cunit__db_write_name(file, entry->suite);
+		fputc('\t', file);
+		cunit__db_write_name(file, entry->test);
+		for (int v = 0; v < CUNIT_DB_VALUES; v++) { fprintf(file, "\t%.9g", entry->values[v]); }
+		fputc('\n', file);
+	}
+
+	bool ok = fflush(file) == 0 && !ferror(file);
+	ok      = fclose(file) == 0 && ok;
+#ifdef _WIN32
+	ok = ok && MoveFileExA(temp, path, MOVEFILE_REPLACE_EXISTING);
+#else
+	ok = ok && rename(temp, path) == 0;
+#endif
+	if (!ok) { remove(temp); }
+	free(temp);
+	return ok;
+}
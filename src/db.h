@@ -0,0 +1,72 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 tayne3
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ * 2. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *    SOFTWARE.
+ */
+#ifndef CUNIT_DB_H
+#define CUNIT_DB_H
+
+#include "cunit/def.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// The number of values stored per entry.
+#define CUNIT_DB_VALUES 4
+
+// One record, keyed by suite and test name.
+typedef struct {
+	char  *suite;                    // The suite name (owned).
+	char  *test;                     // The test name (owned).
+	double values[CUNIT_DB_VALUES];  // The stored values; unused slots are 0.
+} cunit_db_entry_t;
+
+// A small persistent table of per-test values, stored as one tab-separated
+// line per entry ("suite<TAB>test<TAB>value..."). Used for timing history.
+typedef struct {
+	cunit_db_entry_t *entries;   // The entries, in insertion order.
+	size_t            count;     // The number of entries.
+	size_t            capacity;  // The allocated number of entries.
+	size_t           *slots;     // Open-addressing hash index (entry index + 1, 0 = empty).
+	size_t            nslots;    // The number of hash slots (a power of two).
+} cunit_db_t;
+
+// Releases all memory held by the table and empties it.
+void cunit__db_free(cunit_db_t *db);
+
+// Finds the entry for suite/test, or returns NULL.
+cunit_db_entry_t *cunit__db_find(const cunit_db_t *db, const char *suite, const char *test);
+
+// Finds or creates the entry for suite/test. Returns NULL on allocation failure.
+cunit_db_entry_t *cunit__db_put(cunit_db_t *db, const char *suite, const char *test);
+
+// Merges the entries of a file into the table. Returns false if it cannot be read.
+bool cunit__db_load(cunit_db_t *db, const char *path);
+
+// Writes the table to a file, replacing it atomically. Returns false on error.
+bool cunit__db_save(const cunit_db_t *db, const char *path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // CUNIT_DB_H
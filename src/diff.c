@@ -0,0 +1,235 @@
+#include "diff.h"
+
+#include "simd.h"
+
+// The most lines of each string that are diffed, and the most edits searched for between them:
+// the search takes O((lines) * edits) time and O(edits^2) memory.
+#define CUNIT_DIFF_LINES 10000
+#define CUNIT_DIFF_EDITS 500
+
+// The lines of context around each change, the most lines output, and the most bytes of a line shown.
+#define CUNIT_DIFF_CONTEXT 3
+#define CUNIT_DIFF_OUTPUT  100
+#define CUNIT_DIFF_WIDTH   120
+
+// A line of a string, with its newline if it has one.
+typedef struct {
+	const char *data;  // The first byte of the line.
+	size_t      size;  // The bytes of the line, including its newline.
+	uint64_t    hash;  // A hash of the bytes of the line.
+} cunit_diff_line_t;
+
+// A step of an edit script: a line kept (' '), removed from `l` ('-') or added from `r` ('+').
+typedef struct {
+	char   op;  // ' ', '-' or '+'.
+	size_t l;   // The line of `l` kept or removed, or the line of `l` that follows the one added.
+	size_t r;   // The line of `r` kept or added, or the line of `r` that follows the one removed.
+} cunit_diff_edit_t;
+
+// Splits `size` bytes into at most `max` lines, and returns how many lines there are.
+static size_t cunit__diff_split(const char *s, size_t size, cunit_diff_line_t *lines, size_t max) {
+	const char *end = s + size;
+	size_t      n   = 0;
+	for (; s < end && n < max; n++) {
+		const char *newline = (const char *)memchr(s, '\n', (size_t)(end - s));
+		const char *next    = newline ? newline + 1 : end;
+		uint64_t    hash    = 14695981039346656037ull;
+		for (const char *p = s; p < next; p++) { hash = (hash ^ (uint8_t)*p) * 1099511628211ull; }
+		lines[n].data = s;
+		lines[n].size = (size_t)(next - s);
+		lines[n].hash = hash;
+		s             = next;
+	}
+	return n;
+}
+
+// Counts the lines of `size` bytes, up to `max`.
+static size_t cunit__diff_count(const char *s, size_t size, size_t max) {
+	const char *end = s + size;
+	size_t      n   = 0;
+	for (; s < end && n < max; n++) {
+		const char *newline = (const char *)memchr(s, '\n', (size_t)(end - s));
+		s                   = newline ? newline + 1 : end;
+	}
+	return n;
+}
+
+static inline bool cunit__diff_equal(const cunit_diff_line_t *a, const cunit_diff_line_t *b) {
+	return a->hash == b->hash && a->size == b->size && memcmp(a->data, b->data, a->size) == 0;
+}
+
+// Finds the shortest edit script between two lists of lines (Myers' O(ND) algorithm), and
+// returns its length, or SIZE_MAX if it takes more than CUNIT_DIFF_EDITS edits.
+static size_t cunit__diff_myers(const cunit_diff_line_t *a, size_t n, const cunit_diff_line_t *b, size_t m, cunit_diff_edit_t *edits) {
+	const int max = (int)(n + m < CUNIT_DIFF_EDITS ? n + m : CUNIT_DIFF_EDITS);
+	int      *v   = (int *)malloc((size_t)(2 * max + 3) * sizeof(int));
+	// The furthest x reached on each diagonal -d..d after each round d, one round after another.
+	int *trace = (int *)malloc((size_t)(max + 1) * (size_t)(max + 1) * sizeof(int));
+	if (!v || !trace) {
+		free(v);
+		free(trace);
+		return SIZE_MAX;
+	}
+
+#define V(k) v[(k) + max + 1]
+	int found = -1;
+	V(1)      = 0;
+	for (int d = 0; d <= max && found < 0; d++) {
+		for (int k = -d; k <= d; k += 2) {
+			int x = (k == -d || (k != d && V(k - 1) < V(k + 1))) ? V(k + 1) : V(k - 1) + 1;
+			int y = x - k;
+			while (x < (int)n && y < (int)m && cunit__diff_equal(&a[x], &b[y])) { x++, y++; }
+			V(k) = x;
+			if (x >= (int)n && y >= (int)m) { found = d; }
+		}
+		for (int k = -d; k <= d; k++) { trace[d * d + k + d] = V(k); }
+	}
+#undef V
+	free(v);
+	if (found < 0) {
+		free(trace);
+		return SIZE_MAX;
+	}
+
+	// Walk back from the end, then put the edits in order.
+	size_t count = 0;
+	int    x = (int)n, y = (int)m;
+	for (int d = found; d > 0; d--) {
+		const int *prev = trace + (d - 1) * (d - 1) + (d - 1);
+		const int  k    = x - y;
+		const int  pk   = (k == -d || (k != d && prev[k - 1] < prev[k + 1])) ? k + 1 : k - 1;
+		const int  px = prev[pk], py = px - pk;
+		for (; x > px && y > py; x--, y--) { edits[count++] = (cunit_diff_edit_t){' ', (size_t)x - 1, (size_t)y - 1}; }
+		if (x == px) {
+			edits[count++] = (cunit_diff_edit_t){'+', (size_t)x, (size_t)y - 1};
+		} else {
+			edits[count++] = (cunit_diff_edit_t){'-', (size_t)x - 1, (size_t)y};
+		}
+		x = px;
+		y = py;
+	}
+	for (; x > 0 && y > 0; x--, y--) { edits[count++] = (cunit_diff_edit_t){' ', (size_t)x - 1, (size_t)y - 1}; }
+	free(trace);
+
+	for (size_t i = 0; i < count / 2; i++) {
+		const cunit_diff_edit_t edit = edits[i];
+		edits[i]                     = edits[count - 1 - i];
+		edits[count - 1 - i]         = edit;
+	}
+	return count;
+}
+
+// The edit script when the lines differ too much to search: the lines equal at both ends are
+// kept, and those in between are removed and then added.
+static size_t cunit__diff_replace(const cunit_diff_line_t *a, size_t n, const cunit_diff_line_t *b, size_t m, cunit_diff_edit_t *edits) {
+	size_t head = 0, tail = 0, count = 0;
+	while (head < n && head < m && cunit__diff_equal(&a[head], &b[head])) { head++; }
+	while (tail < n - head && tail < m - head && cunit__diff_equal(&a[n - 1 - tail], &b[m - 1 - tail])) { tail++; }
+	for (size_t i = 0; i < head; i++) { edits[count++] = (cunit_diff_edit_t){' ', i, i}; }
+	for (size_t i = head; i < n - tail; i++) { edits[count++] = (cunit_diff_edit_t){'-', i, head}; }
+	for (size_t i = head; i < m - tail; i++) { edits[count++] = (cunit_diff_edit_t){'+', n - tail, i}; }
+	for (size_t i = 0; i < tail; i++) { edits[count++] = (cunit_diff_edit_t){' ', n - tail + i, m - tail + i}; }
+	return count;
+}
+
+// Appends a line of a diff, without its newline. A line too long to show whole is cut to a
+// window around `focus`, the byte of the line that first differs if it holds it.
+static void cunit__diff_line(cunit_buffer_t *out, char op, const cunit_diff_line_t *line, const char *focus, bool newline_differs) {
+	const bool   has_newline = line->size && line->data[line->size - 1] == '\n';
+	const size_t size        = line->size - has_newline;
+	cunit_buffer_putc(out, '\n');
+	cunit_buffer_putc(out, op);
+	if (size <= CUNIT_DIFF_WIDTH) {
+		cunit_buffer_append(out, line->data, size);
+	} else {
+		const size_t at   = focus >= line->data && focus < line->data + line->size ? (size_t)(focus - line->data) : 0;
+		size_t       from = at > CUNIT_DIFF_WIDTH / 2 ? at - CUNIT_DIFF_WIDTH / 2 : 0;
+		if (from > size - CUNIT_DIFF_WIDTH) { from = size - CUNIT_DIFF_WIDTH; }
+		if (from) { cunit_buffer_puts(out, "..."); }
+		cunit_buffer_append(out, line->data + from, CUNIT_DIFF_WIDTH);
+		if (from + CUNIT_DIFF_WIDTH < size) { cunit_buffer_puts(out, "..."); }
+	}
+	if (op != ' ' && !has_newline && newline_differs) { cunit_buffer_puts(out, "\n\\ No newline at end"); }
+}
+
+void cunit__diff(cunit_buffer_t *out, const char *l, size_t l_size, const char *r, size_t r_size) {
+	const size_t common = l_size < r_size ? l_size : r_size;
+	const size_t at     = cunit__mismatch(l, r, common);
+
+	// The line of the first difference, and its number.
+	size_t start = at, line = 1;
+	while (start > 0 && l[start - 1] != '\n') { start--; }
+	for (const char *p = l; (p = (const char *)memchr(p, '\n', start - (size_t)(p - l))) != NULL; p++) { line++; }
+	cunit_buffer_printf(out, "strings differ at line %llu, column %llu:", (unsigned long long)line, (unsigned long long)(at - start + 1));
+
+	// The lines equal at the end are left out, but for the context after the last change, and so
+	// are those before the context of the first.
+	size_t suffix = 0;
+	while (suffix < common - at && l[l_size - 1 - suffix] == r[r_size - 1 - suffix]) { suffix++; }
+	while (suffix > 0 && !(l[l_size - 1 - suffix] == '\n' && r[r_size - 1 - suffix] == '\n')) { suffix--; }
+	for (int i = 0; i < CUNIT_DIFF_CONTEXT && suffix > 0; i++) {
+		const char *from    = l + l_size - suffix;
+		const char *newline = (const char *)memchr(from, '\n', suffix);
+		suffix -= newline ? (size_t)(newline - from) + 1 : suffix;
+	}
+	for (int i = 0; i < CUNIT_DIFF_CONTEXT && start > 0; i++, line--) {
+		start--;
+		while (start > 0 && l[start - 1] != '\n') { start--; }
+	}
+
+	const char        *l_from = l + start, *r_from = r + start;
+	const size_t       l_rest = l_size - suffix - start, r_rest = r_size - suffix - start;
+	const size_t       n = cunit__diff_count(l_from, l_rest, CUNIT_DIFF_LINES), m = cunit__diff_count(r_from, r_rest, CUNIT_DIFF_LINES);
+	cunit_diff_line_t *a     = (cunit_diff_line_t *)malloc((n + m + 1) * sizeof(cunit_diff_line_t));
+	cunit_diff_edit_t *edits = (cunit_diff_edit_t *)malloc((n + m + 1) * sizeof(cunit_diff_edit_t));
+	if (!a || !edits) {
+		free(a);
+		free(edits);
+		return;
+	}
+	cunit_diff_line_t *b = a + n;
+	cunit__diff_split(l_from, l_rest, a, n);
+	cunit__diff_split(r_from, r_rest, b, m);
+	const bool cut = (n && a[n - 1].data + a[n - 1].size < l_from + l_rest) || (m && b[m - 1].data + b[m - 1].size < r_from + r_rest);
+
+	size_t count = cunit__diff_myers(a, n, b, m, edits);
+	if (count == SIZE_MAX) { count = cunit__diff_replace(a, n, b, m, edits); }
+
+	// Each hunk takes in the changes less than twice the context apart.
+	const bool newline_differs = (l_size && l[l_size - 1] == '\n') != (r_size && r[r_size - 1] == '\n');
+	size_t     shown           = 0;
+	for (size_t i = 0; i < count && shown < CUNIT_DIFF_OUTPUT;) {
+		while (i < count && edits[i].op == ' ') { i++; }
+		if (i == count) { break; }
+		size_t last = i;
+		for (size_t j = i + 1; j < count && j - last <= 2 * CUNIT_DIFF_CONTEXT + 1; j++) {
+			if (edits[j].op != ' ') { last = j; }
+		}
+		const size_t first = i > CUNIT_DIFF_CONTEXT ? i - CUNIT_DIFF_CONTEXT : 0;
+		const size_t end   = last + CUNIT_DIFF_CONTEXT + 1 < count ? last + CUNIT_DIFF_CONTEXT + 1 : count;
+		size_t       l_lines = 0, r_lines = 0;
+		for (size_t j = first; j < end; j++) {
+			l_lines += edits[j].op != '+';
+			r_lines += edits[j].op != '-';
+		}
+		// A side with no lines in the hunk is numbered by the line before it, as diff does.
+		cunit_buffer_printf(out, "\n@@ -%llu,%llu +%llu,%llu @@", (unsigned long long)(line + edits[first].l - !l_lines), (unsigned long long)l_lines,
+							(unsigned long long)(line + edits[first].r - !r_lines), (unsigned long long)r_lines);
+		for (size_t j = first; j < end; j++, shown++) {
+			if (shown == CUNIT_DIFF_OUTPUT) {
+				cunit_buffer_puts(out, "\n...");
+				break;
+			}
+			const cunit_diff_edit_t *edit = &edits[j];
+			if (edit->op == '+') {
+				cunit__diff_line(out, '+', &b[edit->r], r + at, newline_differs);
+			} else {
+				cunit__diff_line(out, edit->op, &a[edit->l], l + at, newline_differs);
+			}
+		}
+		i = end;
+	}
+	if (cut) { cunit_buffer_printf(out, "\n... not diffed past %d lines", CUNIT_DIFF_LINES); }
+	free(a);
+	free(edits);
+}
@@ -0,0 +1,120 @@
+#include "file.h"
+
+#include "buffer.h"
+#include "simd.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// The bytes compared at a time, a multiple of the page size.
+#define CUNIT_FILE_CHUNK ((size_t)16 << 20)
+
+// The bytes read at a time where a file cannot be mapped.
+#define CUNIT_FILE_READ (64 * 1024)
+
+// Reads a whole file into memory.
+static bool cunit__file_read(const char *path, cunit_file_t *file) {
+	FILE *stream = fopen(path, "rb");
+	if (!stream) { return false; }
+	cunit_buffer_t buffer = CUNIT_BUFFER_INIT;
+	while (cunit_buffer_reserve(&buffer, CUNIT_FILE_READ)) {
+		const size_t n = fread(buffer.data + buffer.size, 1, CUNIT_FILE_READ, stream);
+		buffer.size += n;
+		if (n < CUNIT_FILE_READ) { break; }
+	}
+	const bool ok = !buffer.failed && !ferror(stream);
+	fclose(stream);
+	if (!ok) {
+		free(buffer.data);
+		return false;
+	}
+	file->data  = (const uint8_t *)buffer.data;
+	file->size  = buffer.size;
+	file->owned = true;
+	return true;
+}
+
+bool cunit__file_open(const char *path, cunit_file_t *file) {
+	memset(file, 0, sizeof(*file));
+#ifndef _WIN32
+	const int fd = open(path, O_RDONLY);
+	if (fd < 0) { return false; }
+	struct stat st;
+	if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && (uint64_t)st.st_size <= SIZE_MAX) {
+		if (st.st_size == 0) {
+			close(fd);
+			return true;
+		}
+		void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (map != MAP_FAILED) {
+			close(fd);
+#ifdef MADV_SEQUENTIAL
+			madvise(map, (size_t)st.st_size, MADV_SEQUENTIAL);
+#endif
+			file->data   = (const uint8_t *)map;
+			file->size   = (size_t)st.st_size;
+			file->mapped = true;
+			return true;
+		}
+	}
+	close(fd);
+#endif
+	return cunit__file_read(path, file);
+}
+
+void cunit__file_close(cunit_file_t *file) {
+#ifndef _WIN32
+	if (file->mapped) { munmap((void *)file->data, file->size); }
+#endif
+	if (file->owned) { free((void *)file->data); }
+	memset(file, 0, sizeof(*file));
+}
+
+// Lets go of the pages of part of a mapped file; they are read from the file again if needed.
+static void cunit__file_release(const cunit_file_t *file, size_t at, size_t size) {
+#if !defined(_WIN32) && defined(MADV_DONTNEED)
+	if (file->mapped) { madvise((void *)(file->data + at), size, MADV_DONTNEED); }
+#else
+	(void)file, (void)at, (void)size;
+#endif
+}
+
+size_t cunit__file_mismatch(const cunit_file_t *l, const cunit_file_t *r, size_t size) {
+	for (size_t at = 0; at < size; at += CUNIT_FILE_CHUNK) {
+		const size_t chunk = size - at < CUNIT_FILE_CHUNK ? size - at : CUNIT_FILE_CHUNK;
+		const size_t found = cunit__mismatch(l->data + at, r->data + at, chunk);
+		if (found < chunk) { return at + found; }
+		cunit__file_release(l, at, chunk);
+		cunit__file_release(r, at, chunk);
+	}
+	return size;
+}
+
+bool cunit__file_write(const char *path, const void *data, size_t size) {
+	const size_t length = strlen(path);
+	char        *temp   = (char *)malloc(length + 5);
+	if (!temp) { return false; }
+	memcpy(temp, path, length);
+	memcpy(temp + length, ".tmp", 5);
+
+	FILE *file = fopen(temp, "wb");
+	if (!file) {
+		free(temp);
+		return false;
+	}
+	bool ok = fwrite(data, 1, size, file) == size;
+	ok      = fflush(file) == 0 && !ferror(file) && ok;
+	ok      = fclose(file) == 0 && ok;
+#ifdef _WIN32
+	ok = ok && MoveFileExA(temp, path, MOVEFILE_REPLACE_EXISTING);
+#else
+	ok = ok && rename(temp, path) == 0;
+#endif
+	if (!ok) { remove(temp); }
+	free(temp);
+	return ok;
+}
@@ -0,0 +1,61 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 tayne3
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ * 2. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *    SOFTWARE.
+ */
+#ifndef CUNIT_FILE_H
+#define CUNIT_FILE_H
+
+#include "cunit/def.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// A file opened for comparison: mapped read-only where the platform can, read
+// into memory elsewhere. Data in memory can be wrapped as one, unmapped.
+typedef struct {
+	const uint8_t *data;    // The contents, or NULL if the file is empty.
+	size_t         size;    // The size of the contents.
+	bool           mapped;  // Whether `data` maps the file.
+	bool           owned;   // Whether `data` was read into memory and is to be freed.
+} cunit_file_t;
+
+// Opens a file for comparison. Returns false if it cannot be read.
+bool cunit__file_open(const char *path, cunit_file_t *file);
+
+// Releases a file opened for comparison.
+void cunit__file_close(cunit_file_t *file);
+
+// Returns the offset of the first of `size` bytes at which two files differ, or
+// `size` if they are equal. Compares a chunk at a time and lets go of the pages
+// of a mapped file once they are compared, so that comparing large files does
+// not hold them in memory.
+size_t cunit__file_mismatch(const cunit_file_t *l, const cunit_file_t *r, size_t size);
+
+// Writes a file, replacing it atomically. Returns false on error.
+bool cunit__file_write(const char *path, const void *data, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // CUNIT_FILE_H
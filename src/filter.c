@@ -0,0 +1,230 @@
+#include "registry.h"
+
+#ifndef _WIN32
+#include <regex.h>
+#endif
+
+// One pattern of a filter.
+typedef struct {
+	char  kind;      // 'g' for a suite/test glob, 'r' for a regular expression, 't' for a tag glob.
+	bool  negative;  // Whether matching tests are excluded.
+	char *suite;     // The glob for the suite name, or the regex or tag glob.
+	char *test;      // The glob for the test name, or NULL for any test.
+#ifndef _WIN32
+	regex_t regex;     // The compiled regular expression.
+	bool    compiled;  // Whether `regex` is valid.
+#endif
+} cunit_pattern_t;
+
+// Matches a name against a glob, where '*' matches any run of characters and '?' any one.
+static bool cunit__glob(const char *glob, const char *name) {
+	const char *star = NULL, *resume = NULL;
+	while (*name) {
+		if (*glob == '*') {
+			star   = ++glob;
+			resume = name;
+		} else if (*glob == '?' || *glob == *name) {
+			glob++;
+			name++;
+		} else if (star) {
+			glob = star;
+			name = ++resume;
+		} else {
+			return false;
+		}
+	}
+	while (*glob == '*') { glob++; }
+	return *glob == '\0';
+}
+
+// Returns whether a comma- or space-separated tag list holds a tag matching `glob`.
+static bool cunit__tags_match(const char *tags, const char *glob) {
+	char tag[128];
+	for (const char *p = tags; p && *p;) {
+		while (*p == ',' || *p == ' ') { p++; }
+		size_t length = 0;
+		while (p[length] && p[length] != ',' && p[length] != ' ') { length++; }
+		if (length && length < sizeof(tag)) {
+			memcpy(tag, p, length);
+			tag[length] = '\0';
+			if (cunit__glob(glob, tag)) { return true; }
+		}
+		p += length;
+	}
+	return false;
+}
+
+// Splits a filter into patterns. Returns the number of patterns, or -1 if out of memory.
+static int cunit__filter_parse(const char *filter, cunit_pattern_t **patterns) {
+	int count = 1;
+	for (const char *p = filter; *p; p++) { count += *p == ':'; }
+	*patterns = (cunit_pattern_t *)calloc((size_t)count, sizeof(cunit_pattern_t));
+	if (!*patterns) { return -1; }
+
+	int n = 0;
+	for (const char *p = filter; *p;) {
+		size_t      length = strcspn(p, ":");
+		const char *token  = p;
+		p += length + (p[length] == ':');
+
+		cunit_pattern_t *pattern = &(*patterns)[n];
+		pattern->negative        = length && token[0] == '-';
+		if (pattern->negative) {
+			token++;
+			length--;
+		}
+		if (!length) { continue; }
+
+		pattern->kind = token[0] == '~' ? 'r' : token[0] == '@' ? 't' : 'g';
+		if (pattern->kind != 'g') {
+			token++;
+			length--;
+		}
+		pattern->suite = (char *)malloc(length + 1);
+		if (!pattern->suite) { return n; }
+		memcpy(pattern->suite, token, length);
+		pattern->suite[length] = '\0';
+		n++;
+
+		if (pattern->kind == 'g') {
+			// "Suite/Test" selects tests; a pattern without a slash selects whole suites.
+			char *slash = strchr(pattern->suite, '/');
+			if (slash) {
+				*slash        = '\0';
+				pattern->test = slash + 1;
+			}
+		}
+#ifndef _WIN32
+		if (pattern->kind == 'r') { pattern->compiled = regcomp(&pattern->regex, pattern->suite, REG_EXTENDED | REG_NOSUB) == 0; }
+#endif
+	}
+	return n;
+}
+
+static void cunit__filter_free(cunit_pattern_t *patterns, int count) {
+	for (int i = 0; i < count; i++) {
+#ifndef _WIN32
+		if (patterns[i].compiled) { regfree(&patterns[i].regex); }
+#endif
+		free(patterns[i].suite);
+	}
+	free(patterns);
+}
+
+// Returns whether a test matches a pattern whose suite part, if any, already matched.
+static bool cunit__pattern_match(const cunit_pattern_t *pattern, const cunit_suite_t *suite, const cunit_test_t *test, cunit_buffer_t *full_name) {
+	switch (pattern->kind) {
+		case 'g': return !pattern->test || cunit__glob(pattern->test, test->name);
+		case 't': return test->tags && cunit__tags_match(test->tags, pattern->suite);
+		default: break;
+	}
+#ifndef _WIN32
+	if (!pattern->compiled) { return false; }
+	if (!full_name->size) { cunit_buffer_printf(full_name, "%s/%s", suite->name, test->name); }
+	return regexec(&pattern->regex, cunit_buffer_str(full_name), 0, NULL, 0) == 0;
+#else
+	// There is no regex.h on Windows; regular expressions match nothing.
+	(void)suite;
+	(void)full_name;
+	return false;
+#endif
+}
+
+// Returns whether a pattern names a suite, or a test of one, without wildcards.
+static inline bool cunit__pattern_exact(const cunit_pattern_t *pattern) {
+	return pattern->kind == 'g' && !strpbrk(pattern->suite, "*?") && (!pattern->test || !strpbrk(pattern->test, "*?"));
+}
+
+// The patterns of a filter, and which of them the suite being selected from matches.
+typedef struct {
+	const cunit_pattern_t *patterns;   // The patterns.
+	int                    count;      // The number of patterns.
+	bool                   positive;   // Whether any pattern includes tests.
+	bool                  *suite_ok;   // Whether the suite part of each pattern matches the suite.
+	cunit_buffer_t         full_name;  // The "Suite/Test" name of the test, built on demand.
+} cunit_filter_t;
+
+// Checks the suite globs against a suite, once per suite. Returns false if no pattern can include a test of it.
+static bool cunit__filter_suite(cunit_filter_t *filter, const cunit_suite_t *suite) {
+	bool candidate = !filter->positive;
+	for (int i = 0; i < filter->count; i++) {
+		const cunit_pattern_t *pattern = &filter->patterns[i];
+		filter->suite_ok[i]            = pattern->kind != 'g' || cunit__glob(pattern->suite, suite->name);
+		candidate                      = candidate || (filter->suite_ok[i] && !pattern->negative);
+	}
+	return candidate;
+}
+
+// Returns whether a test of the suite last checked passes the filter.
+static bool cunit__filter_test(cunit_filter_t *filter, const cunit_suite_t *suite, const cunit_test_t *test) {
+	bool included = !filter->positive, excluded = false;
+	cunit_buffer_clear(&filter->full_name);
+	for (int i = 0; i < filter->count && !excluded; i++) {
+		const cunit_pattern_t *pattern = &filter->patterns[i];
+		if (!filter->suite_ok[i] || (!pattern->negative && included)) { continue; }
+		if (!cunit__pattern_match(pattern, suite, test, &filter->full_name)) { continue; }
+		if (pattern->negative) {
+			excluded = true;
+		} else {
+			included = true;
+		}
+	}
+	return included && !excluded;
+}
+
+// Selects through the name index, when every pattern that includes tests names them
+// exactly: only the tests they name are checked against the filter.
+static bool cunit__filter_lookup(cunit_filter_t *filter) {
+	if (!filter->positive || cunit__registry.index.partial) { return false; }
+	for (int i = 0; i < filter->count; i++) {
+		if (!filter->patterns[i].negative && !cunit__pattern_exact(&filter->patterns[i])) { return false; }
+	}
+
+	for (cunit_suite_t *suite = cunit__registry.suites; suite; suite = suite->next) {
+		for (cunit_test_t *test = suite->tests; test; test = test->next) { test->matched = false; }
+	}
+	for (int i = 0; i < filter->count; i++) {
+		const cunit_pattern_t *pattern = &filter->patterns[i];
+		if (pattern->negative) { continue; }
+		for (cunit_suite_t *suite = cunit__index_find_suite(pattern->suite); suite; suite = suite->twin) {
+			cunit__filter_suite(filter, suite);
+			cunit_test_t *test = pattern->test ? cunit__index_find_test(suite, pattern->test) : suite->tests;
+			for (; test; test = pattern->test ? test->twin : test->next) {
+				if (!test->matched) { test->matched = cunit__filter_test(filter, suite, test); }
+			}
+		}
+	}
+	return true;
+}
+
+void cunit__filter_select(void) {
+	const char      *text     = cunit__registry.filter;
+	cunit_pattern_t *patterns = NULL;
+	const int        count    = STR_ISEMPTY(text) ? 0 : cunit__filter_parse(text, &patterns);
+	bool            *suite_ok = count > 0 ? (bool *)malloc((size_t)count * sizeof(bool)) : NULL;
+	if (!suite_ok) {
+		// Without a usable pattern every test runs.
+		if (patterns) { cunit__filter_free(patterns, count > 0 ? count : 0); }
+		for (cunit_suite_t *suite = cunit__registry.suites; suite; suite = suite->next) {
+			for (cunit_test_t *test = suite->tests; test; test = test->next) { test->matched = true; }
+		}
+		return;
+	}
+
+	cunit_filter_t filter = {patterns, count, false, suite_ok, CUNIT_BUFFER_INIT};
+	for (int i = 0; i < count; i++) { filter.positive = filter.positive || !patterns[i].negative; }
+
+	// Globs, regular expressions and tags are checked against every test; a suite no pattern can include is skipped whole.
+	if (!cunit__filter_lookup(&filter)) {
+		for (cunit_suite_t *suite = cunit__registry.suites; suite; suite = suite->next) {
+			const bool candidate = cunit__filter_suite(&filter, suite);
+			for (cunit_test_t *test = suite->tests; test; test = test->next) { test->matched = candidate && cunit__filter_test(&filter, suite, test); }
+		}
+	}
+	cunit_buffer_free(&filter.full_name);
+	free(suite_ok);
+	cunit__filter_free(patterns, count);
+}
+
+// Sets the patterns that select the tests to run.
+void cunit_set_filter(const char *filter) { cunit__registry.filter = filter; }
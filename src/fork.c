@@ -0,0 +1,345 @@
+#include "clock.h"
+#include "registry.h"
+
+#ifdef _WIN32
+// There is no fork() on Windows; the caller falls back to in-process execution.
+bool cunit__run_forked(cunit_work_t *works, size_t count) {
+	(void)works;
+	(void)count;
+	return false;
+}
+#else
+#include <errno.h>
+#include <limits.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// A forked worker process and the work item it is running.
+typedef struct {
+	pid_t    pid;       // The worker process, or 0 if it is not running.
+	int      to_fd;     // The write end of the request pipe.
+	int      from_fd;   // The read end of the result pipe.
+	size_t   item;      // The work item in flight.
+	uint64_t started;   // When the work item was dispatched.
+	uint64_t deadline;  // When the work item times out, or 0 if it has no timeout.
+	bool     busy;      // Whether a work item is in flight.
+} cunit_process_t;
+
+// The message a worker sends back after each test, followed by `events`
+// bytes of failures recorded while it ran.
+typedef struct {
+	uint32_t       item;    // The work item that ran.
+	uint32_t       events;  // The size of the recorded failures.
+	cunit_result_t result;  // Its result.
+} cunit_message_t;
+
+// Reads exactly `size` bytes, returning false on EOF or error.
+static bool cunit__read_full(int fd, void *buf, size_t size) {
+	char *p = (char *)buf;
+	while (size > 0) {
+		const ssize_t n = read(fd, p, size);
+		if (n < 0 && errno == EINTR) { continue; }
+		if (n <= 0) { return false; }
+		p += n;
+		size -= (size_t)n;
+	}
+	return true;
+}
+
+// Writes exactly `size` bytes, returning false on error.
+static bool cunit__write_full(int fd, const void *buf, size_t size) {
+	const char *p = (const char *)buf;
+	while (size > 0) {
+		const ssize_t n = write(fd, p, size);
+		if (n < 0 && errno == EINTR) { continue; }
+		if (n <= 0) { return false; }
+		p += n;
+		size -= (size_t)n;
+	}
+	return true;
+}
+
+// Reads the failures a worker recorded for `test`, returning false on EOF or error.
+static bool cunit__read_events(int fd, cunit_test_t *test, uint32_t size) {
+	free(test->events);
+	test->events      = NULL;
+	test->events_size = 0;
+	if (!size) { return true; }
+
+	char *events = (char *)malloc(size);
+	if (!events) {
+		// Out of memory: drop the failures but keep the pipe in step.
+		char discard[256];
+		for (uint32_t left = size, chunk; left > 0; left -= chunk) {
+			chunk = left < sizeof(discard) ? left : (uint32_t)sizeof(discard);
+			if (!cunit__read_full(fd, discard, chunk)) { return false; }
+		}
+		return true;
+	}
+	if (!cunit__read_full(fd, events, size)) {
+		free(events);
+		return false;
+	}
+	test->events      = events;
+	test->events_size = size;
+	return true;
+}
+
+// The body of a worker process: runs requested items until the request pipe closes.
+static void cunit__process_main(const cunit_work_t *works, int in_fd, int out_fd) {
+	// The parent reports every test, so failures are sent to it instead. A failure
+	// ends only its test here; in FAIL_FAST mode the parent stops the run on its result.
+	cunit__record_failures(true);
+	cunit__registry.error_mode = CUNIT_ERROR_MODE_COLLECT;
+
+	uint32_t item;
+	while (cunit__read_full(in_fd, &item, sizeof(item))) {
+		cunit_test_t *test = works[item].test;
+		cunit__run_test(works[item].suite, test);
+		fflush(stdout);
+
+		cunit_message_t message;
+		memset(&message, 0, sizeof(message));
+		message.item   = item;
+		message.events = (uint32_t)test->events_size;
+		message.result = test->result;
+		if (!cunit__write_full(out_fd, &message, sizeof(message))) { break; }
+		if (message.events && !cunit__write_full(out_fd, test->events, message.events)) { break; }
+	}
+	fflush(stdout);
+	_exit(EXIT_SUCCESS);
+}
+
+// Closes the parent's ends of a worker's pipes.
+static void cunit__process_close(cunit_process_t *process) {
+	if (process->to_fd >= 0) { close(process->to_fd); }
+	if (process->from_fd >= 0) { close(process->from_fd); }
+	process->to_fd   = -1;
+	process->from_fd = -1;
+}
+
+// Forks worker `index`. The child closes every pipe belonging to its siblings
+// so that each worker sees EOF as soon as the parent closes its request pipe.
+static bool cunit__process_spawn(cunit_process_t *processes, int count, int index, const cunit_work_t *works) {
+	int request[2], response[2];
+	if (pipe(request) != 0) { return false; }
+	if (pipe(response) != 0) {
+		close(request[0]);
+		close(request[1]);
+		return false;
+	}
+
+	// Anything still buffered would otherwise be written twice.
+	cunit__report_flush();
+	fflush(stdout);
+	fflush(stderr);
+
+	const pid_t pid = fork();
+	if (pid < 0) {
+		close(request[0]);
+		close(request[1]);
+		close(response[0]);
+		close(response[1]);
+		return false;
+	}
+	if (pid == 0) {
+		close(request[1]);
+		close(response[0]);
+		for (int i = 0; i < count; i++) {
+			if (i != index) { cunit__process_close(&processes[i]); }
+		}
+		cunit__process_main(works, request[0], response[1]);
+	}
+
+	close(request[0]);
+	close(response[1]);
+	processes[index].pid     = pid;
+	processes[index].to_fd   = request[1];
+	processes[index].from_fd = response[0];
+	processes[index].busy    = false;
+	return true;
+}
+
+// Sends work item `item` to a worker.
+static void cunit__process_dispatch(cunit_process_t *process, size_t item, const cunit_work_t *works) {
+	const uint32_t request = (uint32_t)item;
+	const double   timeout = cunit__timeout_of(works[item].test);
+	process->item          = item;
+	process->started       = cunit_clock_now();
+	process->deadline      = timeout > 0 ? process->started + (uint64_t)(timeout * 1e9) : 0;
+	process->busy          = true;
+	// A failed write means the worker is gone; its result pipe reports EOF next.
+	cunit__write_full(process->to_fd, &request, sizeof(request));
+}
+
+// Reaps a worker whose result pipe reached EOF and records a crash for its item.
+static void cunit__process_reap(cunit_process_t *process, const cunit_work_t *works) {
+	int status = 0;
+	while (waitpid(process->pid, &status, 0) < 0 && errno == EINTR) {}
+	cunit__process_close(process);
+	process->pid = 0;
+	if (!process->busy) { return; }
+
+	cunit_result_t *result = &works[process->item].test->result;
+	memset(result, 0, sizeof(cunit_result_t));
+	result->status    = CUNIT_STATUS_CRASHED;
+	result->signal    = WIFSIGNALED(status) ? WTERMSIG(status) : 0;
+	result->exit_code = WIFEXITED(status) ? WEXITSTATUS(status) : 0;
+	process->busy     = false;
+
+	// Where the worker died is unknown, so all of the time counts as body time.
+	result->timing.body.wall  = (double)(cunit_clock_now() - process->started) / 1e9;
+	result->timing.total.wall = result->timing.body.wall;
+}
+
+// Kills a worker whose item ran past its deadline and records the timeout.
+static void cunit__process_timeout(cunit_process_t *process, const cunit_work_t *works) {
+	const size_t item = process->item;
+	kill(process->pid, SIGKILL);
+	cunit__process_reap(process, works);
+
+	cunit_result_t *result = &works[item].test->result;
+	result->status         = CUNIT_STATUS_TIMEOUT;
+	result->signal         = 0;
+}
+
+// Returns the milliseconds until the nearest deadline of a busy worker, or -1 if none has one.
+static int cunit__process_wait(const cunit_process_t *processes, int count) {
+	const uint64_t now  = cunit_clock_now();
+	int            wait = -1;
+	for (int i = 0; i < count; i++) {
+		if (!processes[i].busy || !processes[i].deadline) { continue; }
+		const uint64_t left = processes[i].deadline > now ? processes[i].deadline - now : 0;
+		// Rounded up, so that the deadline has passed when poll() returns.
+		const uint64_t ms = left / 1000000 + (left % 1000000 != 0);
+		if (wait < 0 || ms < (uint64_t)wait) { wait = ms < INT_MAX ? (int)ms : INT_MAX; }
+	}
+	return wait;
+}
+
+// Leaves a test that did not finish out of a run that FAIL_FAST stopped.
+static void cunit__process_skip(const cunit_work_t *work) {
+	work->test->selected = false;
+	work->suite->selected_count--;
+	cunit__registry.total_selected--;
+}
+
+// Stops every worker; kills them first if the run is being aborted.
+static void cunit__process_shutdown(cunit_process_t *processes, int count, bool kill_all) {
+	for (int i = 0; i < count; i++) {
+		if (!processes[i].pid) { continue; }
+		if (kill_all) { kill(processes[i].pid, SIGKILL); }
+		cunit__process_close(&processes[i]);
+		while (waitpid(processes[i].pid, NULL, 0) < 0 && errno == EINTR) {}
+		processes[i].pid = 0;
+	}
+}
+
+bool cunit__run_forked(cunit_work_t *works, size_t count) {
+	if (count == 0) { return true; }
+
+	int workers = cunit__registry.jobs > 1 ? cunit__registry.jobs : 1;
+	if ((size_t)workers > count) { workers = (int)count; }
+
+	cunit_process_t *processes = (cunit_process_t *)calloc((size_t)workers, sizeof(cunit_process_t));
+	struct pollfd   *fds       = (struct pollfd *)calloc((size_t)workers, sizeof(struct pollfd));
+	int             *owners    = (int *)calloc((size_t)workers, sizeof(int));
+	if (!processes || !fds || !owners) {
+		free(owners);
+		free(fds);
+		free(processes);
+		return false;
+	}
+	for (int i = 0; i < workers; i++) {
+		processes[i].to_fd   = -1;
+		processes[i].from_fd = -1;
+	}
+
+	// Writing to a worker that just died must not kill the parent.
+	struct sigaction ignore, previous;
+	memset(&ignore, 0, sizeof(ignore));
+	ignore.sa_handler = SIG_IGN;
+	sigemptyset(&ignore.sa_mask);
+	sigaction(SIGPIPE, &ignore, &previous);
+
+	size_t next = 0, done = 0;
+	int    spawned = 0;
+	for (int i = 0; i < workers; i++) {
+		if (!cunit__process_spawn(processes, workers, i, works)) { continue; }
+		cunit__process_dispatch(&processes[i], next++, works);
+		spawned++;
+	}
+	if (spawned == 0) {
+		sigaction(SIGPIPE, &previous, NULL);
+		free(owners);
+		free(fds);
+		free(processes);
+		return false;
+	}
+
+	bool aborted = false;
+	while (done < count && !aborted) {
+		nfds_t nfds = 0;
+		for (int i = 0; i < workers; i++) {
+			if (!processes[i].busy) { continue; }
+			fds[nfds].fd      = processes[i].from_fd;
+			fds[nfds].events  = POLLIN;
+			fds[nfds].revents = 0;
+			owners[nfds++]    = i;
+		}
+		if (nfds == 0) { break; }  // Every worker died and none could be respawned.
+		if (poll(fds, nfds, cunit__process_wait(processes, workers)) < 0) {
+			if (errno == EINTR) { continue; }
+			break;
+		}
+
+		const uint64_t now = cunit_clock_now();
+		for (nfds_t k = 0; k < nfds; k++) {
+			cunit_process_t *process = &processes[owners[k]];
+			if (fds[k].revents) {
+				cunit_message_t message;
+				if (cunit__read_full(process->from_fd, &message, sizeof(message)) && message.item == process->item &&
+					cunit__read_events(process->from_fd, works[message.item].test, message.events)) {
+					works[message.item].test->result = message.result;
+					process->busy                    = false;
+					if (message.result.status != CUNIT_STATUS_PASSED && cunit__registry.error_mode == CUNIT_ERROR_MODE_FAIL_FAST) { aborted = true; }
+				} else {
+					cunit__process_reap(process, works);
+					if (cunit__registry.error_mode == CUNIT_ERROR_MODE_FAIL_FAST) { aborted = true; }
+				}
+			} else if (process->deadline && now >= process->deadline) {
+				// A hung worker is killed and replaced; the run goes on.
+				cunit__process_timeout(process, works);
+				if (cunit__registry.error_mode == CUNIT_ERROR_MODE_FAIL_FAST) { aborted = true; }
+			} else {
+				continue;
+			}
+			done++;
+
+			if (aborted || next >= count) { continue; }
+			if (!process->pid && !cunit__process_spawn(processes, workers, owners[k], works)) { continue; }
+			cunit__process_dispatch(process, next++, works);
+		}
+	}
+
+	// FAIL_FAST: the items in flight and those not yet sent are left out, and the
+	// caller reports what finished.
+	for (int i = 0; aborted && i < workers; i++) {
+		if (processes[i].busy) { cunit__process_skip(&works[processes[i].item]); }
+	}
+	for (size_t i = next; aborted && i < count; i++) { cunit__process_skip(&works[i]); }
+	cunit__registry.stopped = cunit__registry.stopped || aborted;
+	cunit__process_shutdown(processes, workers, aborted);
+	sigaction(SIGPIPE, &previous, NULL);
+
+	// If no worker could be respawned, finish the remaining items in-process.
+	if (!aborted && next < count) { cunit__run_unisolated(works + next, count - next); }
+	free(owners);
+	free(fds);
+	free(processes);
+	return true;
+}
+#endif
@@ -0,0 +1,89 @@
+#include "registry.h"
+
+// Hashes a name (FNV-1a) together with the suite it belongs to, never returning 0.
+static uint64_t cunit__index_hash(const cunit_suite_t *owner, const char *name) {
+	uint64_t hash = 14695981039346656037ull ^ (uint64_t)(uintptr_t)owner;
+	for (const char *p = name; *p; p++) { hash = (hash ^ (uint8_t)*p) * 1099511628211ull; }
+	return hash ? hash : 1;
+}
+
+// Returns the name of an indexed suite or test.
+static inline const char *cunit__index_name(const cunit_index_slot_t *slot) {
+	return slot->owner ? ((const cunit_test_t *)slot->entry)->name : ((const cunit_suite_t *)slot->entry)->name;
+}
+
+// Returns the slot holding owner/name, or the empty slot where it belongs.
+static size_t cunit__index_slot(const cunit_index_t *index, const cunit_suite_t *owner, const char *name, uint64_t hash) {
+	const size_t mask = index->nslots - 1;
+	for (size_t slot = (size_t)hash & mask;; slot = (slot + 1) & mask) {
+		const cunit_index_slot_t *entry = &index->slots[slot];
+		if (!entry->hash) { return slot; }
+		if (entry->hash == hash && entry->owner == owner && strcmp(cunit__index_name(entry), name) == 0) { return slot; }
+	}
+}
+
+// Doubles the index and reinserts every entry.
+static bool cunit__index_rehash(cunit_index_t *index) {
+	const size_t        nslots = index->nslots ? index->nslots * 2 : 64;
+	cunit_index_slot_t *slots  = (cunit_index_slot_t *)calloc(nslots, sizeof(cunit_index_slot_t));
+	if (!slots) { return false; }
+	for (size_t i = 0; i < index->nslots; i++) {
+		const cunit_index_slot_t *entry = &index->slots[i];
+		if (!entry->hash) { continue; }
+		size_t slot = (size_t)entry->hash & (nslots - 1);
+		while (slots[slot].hash) { slot = (slot + 1) & (nslots - 1); }
+		slots[slot] = *entry;
+	}
+	free(index->slots);
+	index->slots  = slots;
+	index->nslots = nslots;
+	return true;
+}
+
+// Adds an entry. One with the same owner and name as an earlier one is chained
+// after it, so that lookups find the first one registered.
+static void cunit__index_add(cunit_index_t *index, const cunit_suite_t *owner, const char *name, void *entry) {
+	// Keep the load factor at or below one half.
+	if ((index->count + 1) * 2 > index->nslots && !cunit__index_rehash(index)) {
+		index->partial = true;
+		return;
+	}
+	const uint64_t      hash = cunit__index_hash(owner, name);
+	cunit_index_slot_t *slot = &index->slots[cunit__index_slot(index, owner, name, hash)];
+	if (slot->hash) {
+		if (owner) {
+			((cunit_test_t *)slot->last)->twin = (cunit_test_t *)entry;
+		} else {
+			((cunit_suite_t *)slot->last)->twin = (cunit_suite_t *)entry;
+		}
+		slot->last = entry;
+		return;
+	}
+	slot->hash  = hash;
+	slot->owner = owner;
+	slot->entry = entry;
+	slot->last  = entry;
+	index->count++;
+}
+
+// Finds an entry by owner and name.
+static void *cunit__index_find(const cunit_index_t *index, const cunit_suite_t *owner, const char *name) {
+	if (!index->nslots || !name) { return NULL; }
+	const cunit_index_slot_t *slot = &index->slots[cunit__index_slot(index, owner, name, cunit__index_hash(owner, name))];
+	return slot->hash ? slot->entry : NULL;
+}
+
+void cunit__index_add_suite(cunit_suite_t *suite) { cunit__index_add(&cunit__registry.index, NULL, suite->name, suite); }
+
+void cunit__index_add_test(cunit_suite_t *suite, cunit_test_t *test) { cunit__index_add(&cunit__registry.index, suite, test->name, test); }
+
+cunit_suite_t *cunit__index_find_suite(const char *name) { return (cunit_suite_t *)cunit__index_find(&cunit__registry.index, NULL, name); }
+
+cunit_test_t *cunit__index_find_test(const cunit_suite_t *suite, const char *name) {
+	return suite ? (cunit_test_t *)cunit__index_find(&cunit__registry.index, suite, name) : NULL;
+}
+
+void cunit__index_free(cunit_index_t *index) {
+	free(index->slots);
+	memset(index, 0, sizeof(cunit_index_t));
+}
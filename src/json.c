@@ -0,0 +1,180 @@
+#include "registry.h"
+
+// The state of the JSON Lines writer. Only the current test is held in memory.
+static struct {
+	const char    *path;      // The output file, or NULL.
+	FILE          *file;      // The open output file, or NULL.
+	cunit_buffer_t out;       // The line being written.
+	cunit_buffer_t failures;  // The failures of the current test, as comma-separated objects.
+} cunit__json = {NULL, NULL, CUNIT_BUFFER_INIT, CUNIT_BUFFER_INIT};
+
+// Appends `s` as a JSON string, or null.
+static void cunit__json_string(cunit_buffer_t *out, const char *s) {
+	if (!s) {
+		cunit_buffer_puts(out, "null");
+		return;
+	}
+	cunit_buffer_putc(out, '"');
+	for (const unsigned char *p = (const unsigned char *)s; *p; p++) {
+		switch (*p) {
+			case '"': cunit_buffer_puts(out, "\\\""); break;
+			case '\\': cunit_buffer_puts(out, "\\\\"); break;
+			case '\n': cunit_buffer_puts(out, "\\n"); break;
+			case '\r': cunit_buffer_puts(out, "\\r"); break;
+			case '\t': cunit_buffer_puts(out, "\\t"); break;
+			default:
+				if (*p < 0x20) {
+					cunit_buffer_printf(out, "\\u%04x", *p);
+				} else {
+					cunit_buffer_putc(out, (char)*p);
+				}
+				break;
+		}
+	}
+	cunit_buffer_putc(out, '"');
+}
+
+// Writes the pending line. Lines are flushed one by one, so a file cut short by
+// a crash still holds every event before it.
+static void cunit__json_write(void) {
+	if (!cunit__json.file && cunit__json.path) { cunit__json.file = fopen(cunit__json.path, "wb"); }
+	if (cunit__json.file && !cunit__json.out.failed) {
+		cunit_buffer_putc(&cunit__json.out, '\n');
+		fwrite(cunit__json.out.data, 1, cunit__json.out.size, cunit__json.file);
+		fflush(cunit__json.file);
+	}
+	cunit_buffer_clear(&cunit__json.out);
+}
+
+void cunit__json_close(void) {
+	if (cunit__json.file) { fclose(cunit__json.file); }
+	cunit__json.file = NULL;
+	cunit_buffer_free(&cunit__json.out);
+	cunit_buffer_free(&cunit__json.failures);
+}
+
+// Appends the wall and CPU time of one phase as `"name":{"wall":..,"cpu":..}`.
+static void cunit__json_time(cunit_buffer_t *out, const char *name, const cunit_time_t *time) {
+	cunit_buffer_printf(out, ",\"%s\":{\"wall\":%.9g,\"cpu\":%.9g}", name, time->wall, time->cpu);
+}
+
+static void cunit__json_run_begin(void *data, int total) {
+	(void)data;
+	cunit_buffer_printf(&cunit__json.out, "{\"event\":\"run_begin\",\"total\":%d}", total);
+	cunit__json_write();
+}
+
+static void cunit__json_suite_begin(void *data, const char *suite) {
+	(void)data;
+	cunit_buffer_puts(&cunit__json.out, "{\"event\":\"suite_begin\",\"suite\":");
+	cunit__json_string(&cunit__json.out, suite);
+	cunit_buffer_putc(&cunit__json.out, '}');
+	cunit__json_write();
+}
+
+static void cunit__json_test_begin(void *data, const char *suite, const char *test) {
+	(void)data;
+	(void)suite;
+	(void)test;
+	cunit_buffer_clear(&cunit__json.failures);
+}
+
+static void cunit__json_failure(void *data, const cunit_failure_t *failure) {
+	(void)data;
+	cunit_buffer_t *failures = &cunit__json.failures;
+	cunit_buffer_puts(failures, failures->size ? ",{\"file\":" : "{\"file\":");
+	cunit__json_string(failures, failure->ctx.file ? __cunit_relative(failure->ctx.file) : NULL);
+	cunit_buffer_printf(failures, ",\"line\":%d,\"func\":", failure->ctx.line);
+	cunit__json_string(failures, failure->ctx.func);
+	cunit_buffer_puts(failures, ",\"message\":");
+	cunit__json_string(failures, failure->message);
+	cunit_buffer_puts(failures, ",\"note\":");
+	cunit__json_string(failures, failure->note);
+	cunit_buffer_printf(failures, ",\"fatal\":%s}", failure->fatal ? "true" : "false");
+}
+
+static void cunit__json_test_end(void *data, const cunit_test_report_t *test) {
+	(void)data;
+	static const char *const statuses[] = {"passed", "failed", "crashed", "timeout"};
+
+	cunit_buffer_t *out = &cunit__json.out;
+	cunit_buffer_puts(out, "{\"event\":\"test\",\"suite\":");
+	cunit__json_string(out, test->suite);
+	cunit_buffer_puts(out, ",\"test\":");
+	cunit__json_string(out, test->name);
+	cunit_buffer_printf(out, ",\"status\":\"%s\",\"duration\":%.9g,\"assertions\":%llu", statuses[test->status], test->timing->total.wall,
+						(unsigned long long)test->assertions);
+	cunit__json_time(out, "setup", &test->timing->setup);
+	cunit__json_time(out, "body", &test->timing->body);
+	cunit__json_time(out, "teardown", &test->timing->teardown);
+	cunit__json_time(out, "total", &test->timing->total);
+	if (test->status == CUNIT_STATUS_CRASHED) { cunit_buffer_printf(out, ",\"signal\":%d,\"exit_code\":%d", test->signal, test->exit_code); }
+	if (test->bench) {
+		const cunit_bench_stats_t *bench = test->bench;
+		cunit_buffer_printf(out, ",\"bench\":{\"iterations\":%llu,\"repetitions\":%d,\"min\":%.9g,\"median\":%.9g,\"mean\":%.9g,\"stddev\":%.9g,\"mad\":%.9g}",
+							(unsigned long long)bench->iterations, bench->repetitions, bench->min, bench->median, bench->mean, bench->stddev, bench->mad);
+	}
+	if (test->counters) {
+		static const char *const names[] = {"cycles", "instructions", "branch_misses", "cache_misses"};
+		const uint64_t           values[] = {test->counters->cycles, test->counters->instructions, test->counters->branch_misses,
+											 test->counters->cache_misses};
+		const char              *separator = "";
+		cunit_buffer_puts(out, ",\"counters\":{");
+		for (int i = 0; i < 4; i++) {
+			if (!(test->counters->available & (1u << i))) { continue; }
+			cunit_buffer_printf(out, "%s\"%s\":%llu", separator, names[i], (unsigned long long)values[i]);
+			separator = ",";
+		}
+		cunit_buffer_puts(out, "}");
+	}
+	if (test->alloc) {
+		const cunit_alloc_stats_t *alloc = test->alloc;
+		cunit_buffer_printf(out, ",\"alloc\":{\"count\":%llu,\"frees\":%llu,\"bytes\":%llu,\"peak\":%llu,\"unfreed\":%llu,\"unfreed_count\":%llu}",
+							(unsigned long long)alloc->count, (unsigned long long)alloc->frees, (unsigned long long)alloc->bytes,
+							(unsigned long long)alloc->peak, (unsigned long long)alloc->unfreed, (unsigned long long)alloc->unfreed_count);
+	}
+	cunit_buffer_printf(out, ",\"failures\":[%s]}", cunit_buffer_str(&cunit__json.failures));
+	cunit__json_write();
+}
+
+static void cunit__json_suite_end(void *data, const cunit_suite_report_t *suite) {
+	(void)data;
+	cunit_buffer_t *out = &cunit__json.out;
+	cunit_buffer_puts(out, "{\"event\":\"suite_end\",\"suite\":");
+	cunit__json_string(out, suite->name);
+	cunit_buffer_printf(out, ",\"passed\":%d,\"failed\":%d,\"total\":%d,\"duration\":%.9g,\"assertions\":%llu}", suite->passed, suite->failed,
+						suite->total, suite->timing->total.wall, (unsigned long long)suite->assertions);
+	cunit__json_write();
+}
+
+static void cunit__json_run_end(void *data, const cunit_run_report_t *run) {
+	(void)data;
+	cunit_buffer_printf(&cunit__json.out, "{\"event\":\"run_end\",\"passed\":%d,\"failed\":%d,\"total\":%d,\"assertions\":%llu,\"duration\":%.9g}", run->passed,
+						run->failed, run->total, (unsigned long long)run->assertions, run->duration);
+	cunit__json_write();
+	cunit__json_close();
+}
+
+static void cunit__json_flush(void *data) {
+	(void)data;
+	if (cunit__json.file) { fflush(cunit__json.file); }
+}
+
+static const cunit_reporter_t cunit__json_reporter = {
+	NULL,                     // data
+	cunit__json_run_begin,    // run_begin
+	cunit__json_suite_begin,  // suite_begin
+	cunit__json_test_begin,   // test_begin
+	cunit__json_failure,      // failure
+	cunit__json_test_end,     // test_end
+	cunit__json_suite_end,    // suite_end
+	cunit__json_run_end,      // run_end
+	cunit__json_flush,        // flush
+};
+
+// Gets the JSON Lines reporter, writing to `path`.
+const cunit_reporter_t *cunit_json_reporter(const char *path) {
+	if (cunit__json.path != path) { cunit__json_close(); }
+	cunit__json.path = path;
+	return &cunit__json_reporter;
+}
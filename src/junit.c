@@ -0,0 +1,193 @@
+#include "registry.h"
+
+// The state of the JUnit XML writer. Only the current test is held in memory.
+static struct {
+	const char    *path;      // The output file, or NULL.
+	FILE          *file;      // The open output file, or NULL.
+	long           tail;      // Where the closing tags start, or -1 if the file cannot seek.
+	bool           in_suite;  // Whether a <testsuite> element is open.
+	cunit_buffer_t out;       // The elements waiting to be written.
+	cunit_buffer_t details;   // The failures of the current test, one per line.
+	cunit_buffer_t message;   // The last failed check of the current test.
+} cunit__junit = {NULL, NULL, -1, false, CUNIT_BUFFER_INIT, CUNIT_BUFFER_INIT, CUNIT_BUFFER_INIT};
+
+// Appends `s` escaped for use in XML text and attributes.
+static void cunit__xml_escape(cunit_buffer_t *out, const char *s) {
+	for (const unsigned char *p = (const unsigned char *)s; *p; p++) {
+		switch (*p) {
+			case '&': cunit_buffer_puts(out, "&amp;"); break;
+			case '<': cunit_buffer_puts(out, "&lt;"); break;
+			case '>': cunit_buffer_puts(out, "&gt;"); break;
+			case '"': cunit_buffer_puts(out, "&quot;"); break;
+			case '\'': cunit_buffer_puts(out, "&apos;"); break;
+			case '\t':
+			case '\n':
+			case '\r': cunit_buffer_putc(out, (char)*p); break;
+			default: cunit_buffer_putc(out, *p < 0x20 ? '?' : (char)*p); break;  // Not allowed in XML 1.0.
+		}
+	}
+}
+
+// Opens the output file on the first event of a run.
+static bool cunit__junit_open(void) {
+	if (cunit__junit.file) { return true; }
+	if (!cunit__junit.path) { return false; }
+	cunit__junit.file = fopen(cunit__junit.path, "wb");
+	if (!cunit__junit.file) { return false; }
+	fputs("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<testsuites>\n", cunit__junit.file);
+	cunit__junit.tail = ftell(cunit__junit.file);
+	return true;
+}
+
+// Writes the pending elements over the closing tags and puts the closing tags back
+// after them, so that the file is a complete document after every test.
+static void cunit__junit_write(void) {
+	if (!cunit__junit_open()) {
+		cunit_buffer_clear(&cunit__junit.out);
+		return;
+	}
+	FILE *file = cunit__junit.file;
+	if (cunit__junit.tail >= 0 && fseek(file, cunit__junit.tail, SEEK_SET) != 0) { cunit__junit.tail = -1; }
+	if (cunit__junit.out.size) { fwrite(cunit__junit.out.data, 1, cunit__junit.out.size, file); }
+	cunit_buffer_clear(&cunit__junit.out);
+	if (cunit__junit.tail >= 0) {
+		cunit__junit.tail = ftell(file);
+		if (cunit__junit.in_suite) { fputs("  </testsuite>\n", file); }
+		fputs("</testsuites>\n", file);
+	}
+	fflush(file);
+}
+
+void cunit__junit_close(void) {
+	if (!cunit__junit.file) { return; }
+	if (cunit__junit.in_suite) { cunit_buffer_puts(&cunit__junit.out, "  </testsuite>\n"); }
+	cunit__junit.in_suite = false;
+	cunit__junit_write();
+	// Without seeking the closing tag can only be written once, at the end.
+	if (cunit__junit.tail < 0) { fputs("</testsuites>\n", cunit__junit.file); }
+	fclose(cunit__junit.file);
+	cunit__junit.file = NULL;
+	cunit_buffer_free(&cunit__junit.out);
+	cunit_buffer_free(&cunit__junit.details);
+	cunit_buffer_free(&cunit__junit.message);
+}
+
+static void cunit__junit_suite_begin(void *data, const char *suite) {
+	(void)data;
+	cunit_buffer_puts(&cunit__junit.out, "  <testsuite name=\"");
+	cunit__xml_escape(&cunit__junit.out, suite);
+	cunit_buffer_puts(&cunit__junit.out, "\">\n");
+	cunit__junit.in_suite = true;
+	cunit__junit_write();
+}
+
+static void cunit__junit_test_begin(void *data, const char *suite, const char *test) {
+	(void)data;
+	(void)suite;
+	(void)test;
+	cunit_buffer_clear(&cunit__junit.details);
+	cunit_buffer_clear(&cunit__junit.message);
+}
+
+static void cunit__junit_failure(void *data, const cunit_failure_t *failure) {
+	(void)data;
+	cunit_buffer_t *details = &cunit__junit.details;
+	if (failure->ctx.file) { cunit_buffer_printf(details, "%s:%d: ", __cunit_relative(failure->ctx.file), failure->ctx.line); }
+	if (failure->fatal) {
+		cunit_buffer_puts(details, "test failed");
+	} else {
+		cunit_buffer_puts(details, failure->message ? failure->message : "check failed");
+		cunit_buffer_clear(&cunit__junit.message);
+		cunit_buffer_puts(&cunit__junit.message, failure->message ? failure->message : "check failed");
+	}
+	if (failure->note) { cunit_buffer_printf(details, " (%s)", failure->note); }
+	cunit_buffer_putc(details, '\n');
+}
+
+static void cunit__junit_test_end(void *data, const cunit_test_report_t *test) {
+	(void)data;
+	cunit_buffer_t *out = &cunit__junit.out;
+	cunit_buffer_puts(out, "    <testcase classname=\"");
+	cunit__xml_escape(out, test->suite);
+	cunit_buffer_puts(out, "\" name=\"");
+	cunit__xml_escape(out, test->name);
+	cunit_buffer_printf(out, "\" time=\"%.6f\" assertions=\"%llu\"", test->timing->total.wall, (unsigned long long)test->assertions);
+
+	const char *details = cunit_buffer_str(&cunit__junit.details);
+	if (test->status == CUNIT_STATUS_PASSED && !*details) {
+		cunit_buffer_puts(out, "/>\n");
+		cunit__junit_write();
+		return;
+	}
+
+	cunit_buffer_puts(out, ">\n");
+	if (test->status == CUNIT_STATUS_CRASHED || test->status == CUNIT_STATUS_TIMEOUT) {
+		if (test->status == CUNIT_STATUS_TIMEOUT) {
+			cunit_buffer_printf(out, "      <error message=\"timed out after %.3f s\" type=\"timeout\"", test->timing->total.wall);
+		} else if (test->signal) {
+			cunit_buffer_printf(out, "      <error message=\"crashed with signal %d\" type=\"crash\"", test->signal);
+		} else {
+			cunit_buffer_printf(out, "      <error message=\"exited with code %d\" type=\"crash\"", test->exit_code);
+		}
+		if (*details) {
+			cunit_buffer_putc(out, '>');
+			cunit__xml_escape(out, details);
+			cunit_buffer_puts(out, "</error>\n");
+		} else {
+			cunit_buffer_puts(out, "/>\n");
+		}
+	} else if (test->status == CUNIT_STATUS_FAILED) {
+		// The message is what the failing assertion checked; the text lists every failure.
+		const char *message = cunit_buffer_str(&cunit__junit.message);
+		cunit_buffer_puts(out, "      <failure message=\"");
+		cunit__xml_escape(out, *message ? message : cunit__zero_assertions(test) ? "made no assertions" : "test failed");
+		cunit_buffer_puts(out, "\" type=\"assertion\">");
+		cunit__xml_escape(out, details);
+		cunit_buffer_puts(out, "</failure>\n");
+	} else {
+		// Failed checks do not fail a test, but are worth keeping.
+		cunit_buffer_puts(out, "      <system-out>");
+		cunit__xml_escape(out, details);
+		cunit_buffer_puts(out, "</system-out>\n");
+	}
+	cunit_buffer_puts(out, "    </testcase>\n");
+	cunit__junit_write();
+}
+
+static void cunit__junit_suite_end(void *data, const cunit_suite_report_t *suite) {
+	(void)data;
+	(void)suite;
+	cunit_buffer_puts(&cunit__junit.out, "  </testsuite>\n");
+	cunit__junit.in_suite = false;
+	cunit__junit_write();
+}
+
+static void cunit__junit_run_end(void *data, const cunit_run_report_t *run) {
+	(void)data;
+	(void)run;
+	cunit__junit_close();
+}
+
+static void cunit__junit_flush(void *data) {
+	(void)data;
+	if (cunit__junit.file) { fflush(cunit__junit.file); }
+}
+
+static const cunit_reporter_t cunit__junit_reporter = {
+	NULL,                      // data
+	NULL,                      // run_begin
+	cunit__junit_suite_begin,  // suite_begin
+	cunit__junit_test_begin,   // test_begin
+	cunit__junit_failure,      // failure
+	cunit__junit_test_end,     // test_end
+	cunit__junit_suite_end,    // suite_end
+	cunit__junit_run_end,      // run_end
+	cunit__junit_flush,        // flush
+};
+
+// Gets the JUnit XML reporter, writing to `path`.
+const cunit_reporter_t *cunit_junit_reporter(const char *path) {
+	if (cunit__junit.path != path) { cunit__junit_close(); }
+	cunit__junit.path = path;
+	return &cunit__junit_reporter;
+}
@@ -0,0 +1,538 @@
+#include "log.h"
+
+#include "registry.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// How much of the log file is mapped at first; the mapping doubles as it fills.
+#define CUNIT_LOG_INITIAL_SIZE (1024 * 1024)
+
+// How much output is collected before it is written out, where the log cannot be mapped.
+#define CUNIT_LOG_BUFFER_SIZE (64 * 1024)
+
+// An interned string and its id.
+typedef struct {
+	uint64_t hash;  // The hash of the string, or 0 for an empty slot.
+	uint32_t id;    // The id of its string record.
+	char    *text;  // A copy of the string.
+} cunit_log_string_t;
+
+// The state of the log writer.
+static struct {
+	const char         *path;     // The output file, or NULL.
+	bool                open;     // Whether the output file is open.
+	int                 fd;       // The mapped output file, or -1.
+	char               *map;      // The mapping of the output file, or NULL.
+	size_t              mapped;   // The size of the mapping.
+	size_t              used;     // The bytes written into the mapping.
+	FILE               *file;     // The output file, where it cannot be mapped.
+	cunit_buffer_t      pending;  // The records not yet written to `file`.
+	uint32_t            strings;  // The number of string records written.
+	cunit_log_string_t *slots;    // The interned strings, by hash.
+	size_t              nslots;   // The size of `slots`, a power of two.
+} cunit__log = {NULL, false, -1, NULL, 0, 0, NULL, CUNIT_BUFFER_INIT, 0, NULL, 0};
+
+// Rounds a payload size up to whole records.
+static inline size_t cunit__log_padded(uint64_t size) {
+	const size_t record = sizeof(cunit_log_record_t);
+	return (size_t)((size + record - 1) / record * record);
+}
+
+// Returns `size` zeroed bytes at the end of the log, or NULL if the log cannot grow.
+// The pointer is only valid until the next call.
+static char *cunit__log_reserve(size_t size) {
+#ifndef _WIN32
+	if (cunit__log.map) {
+		if (cunit__log.used + size > cunit__log.mapped) {
+			size_t mapped = cunit__log.mapped * 2;
+			while (mapped < cunit__log.used + size) { mapped *= 2; }
+			munmap(cunit__log.map, cunit__log.mapped);
+			cunit__log.map = NULL;
+			if (ftruncate(cunit__log.fd, (off_t)mapped) != 0) { return NULL; }
+			void *map = mmap(NULL, mapped, PROT_READ | PROT_WRITE, MAP_SHARED, cunit__log.fd, 0);
+			if (map == MAP_FAILED) { return NULL; }
+			cunit__log.map    = (char *)map;
+			cunit__log.mapped = mapped;
+		}
+		char *p = cunit__log.map + cunit__log.used;
+		cunit__log.used += size;
+		return p;
+	}
+#endif
+	if (!cunit__log.file || !cunit_buffer_reserve(&cunit__log.pending, size)) { return NULL; }
+	char *p = cunit__log.pending.data + cunit__log.pending.size;
+	memset(p, 0, size);
+	cunit__log.pending.size += size;
+	return p;
+}
+
+// Writes out the records collected where the log cannot be mapped.
+static void cunit__log_sync(void) {
+	if (!cunit__log.file) { return; }
+	if (cunit__log.pending.size) { fwrite(cunit__log.pending.data, 1, cunit__log.pending.size, cunit__log.file); }
+	cunit_buffer_clear(&cunit__log.pending);
+	fflush(cunit__log.file);
+}
+
+// Appends a record and its payload, given in up to two parts. The payload goes
+// in before the record, so that a reader never sees a record without it. Returns
+// false if there is no room for it.
+static bool cunit__log_emit(cunit_log_record_t *record, const void *part1, size_t size1, const void *part2, size_t size2) {
+	record->size = size1 + size2;
+	char *p      = cunit__log_reserve(sizeof(cunit_log_record_t) + cunit__log_padded(record->size));
+	if (!p) { return false; }
+	if (size1) { memcpy(p + sizeof(cunit_log_record_t), part1, size1); }
+	if (size2) { memcpy(p + sizeof(cunit_log_record_t) + size1, part2, size2); }
+	memcpy(p, record, sizeof(cunit_log_record_t));
+	if (cunit__log.file && cunit__log.pending.size >= CUNIT_LOG_BUFFER_SIZE) { cunit__log_sync(); }
+	return true;
+}
+
+// Opens the output file and writes the header on the first event of a run.
+static bool cunit__log_open(void) {
+	if (cunit__log.open) { return true; }
+	if (!cunit__log.path) { return false; }
+#ifndef _WIN32
+	cunit__log.fd = open(cunit__log.path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (cunit__log.fd >= 0 && ftruncate(cunit__log.fd, CUNIT_LOG_INITIAL_SIZE) == 0) {
+		void *map = mmap(NULL, CUNIT_LOG_INITIAL_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, cunit__log.fd, 0);
+		if (map != MAP_FAILED) {
+			cunit__log.map    = (char *)map;
+			cunit__log.mapped = CUNIT_LOG_INITIAL_SIZE;
+		}
+	}
+	if (!cunit__log.map && cunit__log.fd >= 0) {
+		close(cunit__log.fd);
+		cunit__log.fd = -1;
+	}
+#endif
+	if (!cunit__log.map) {
+		cunit__log.file = fopen(cunit__log.path, "wb");
+		if (!cunit__log.file) { return false; }
+	}
+	cunit__log.open    = true;
+	cunit__log.used    = 0;
+	cunit__log.strings = 0;
+
+	cunit_log_header_t header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, CUNIT_LOG_MAGIC, sizeof(header.magic));
+	header.version     = CUNIT_LOG_VERSION;
+	header.endian      = CUNIT_LOG_ENDIAN;
+	header.record_size = sizeof(cunit_log_record_t);
+	header.timing_size = sizeof(cunit_timing_t);
+	header.bench_size  = sizeof(cunit_bench_stats_t);
+	char *p            = cunit__log_reserve(sizeof(header));
+	if (p) { memcpy(p, &header, sizeof(header)); }
+	return true;
+}
+
+void cunit__log_close(void) {
+	if (!cunit__log.open) { return; }
+#ifndef _WIN32
+	if (cunit__log.fd >= 0) {
+		if (cunit__log.map) { munmap(cunit__log.map, cunit__log.mapped); }
+		if (ftruncate(cunit__log.fd, (off_t)cunit__log.used) != 0) {
+			// The unused tail stays; it reads as the end of the log.
+		}
+		close(cunit__log.fd);
+	}
+#endif
+	if (cunit__log.file) {
+		cunit__log_sync();
+		fclose(cunit__log.file);
+	}
+	for (size_t i = 0; i < cunit__log.nslots; i++) { free(cunit__log.slots[i].text); }
+	free(cunit__log.slots);
+	cunit_buffer_free(&cunit__log.pending);
+
+	const char *path = cunit__log.path;
+	memset(&cunit__log, 0, sizeof(cunit__log));
+	cunit__log.path = path;
+	cunit__log.fd   = -1;
+}
+
+// Hashes a string (FNV-1a), never returning 0.
+static uint64_t cunit__log_hash(const char *s) {
+	uint64_t hash = 14695981039346656037ull;
+	for (const char *p = s; *p; p++) { hash = (hash ^ (uint8_t)*p) * 1099511628211ull; }
+	return hash ? hash : 1;
+}
+
+// Doubles the string index and reinserts every string.
+static bool cunit__log_rehash(void) {
+	const size_t        nslots = cunit__log.nslots ? cunit__log.nslots * 2 : 256;
+	cunit_log_string_t *slots  = (cunit_log_string_t *)calloc(nslots, sizeof(cunit_log_string_t));
+	if (!slots) { return false; }
+	for (size_t i = 0; i < cunit__log.nslots; i++) {
+		const cunit_log_string_t *entry = &cunit__log.slots[i];
+		if (!entry->hash) { continue; }
+		size_t slot = (size_t)entry->hash & (nslots - 1);
+		while (slots[slot].hash) { slot = (slot + 1) & (nslots - 1); }
+		slots[slot] = *entry;
+	}
+	free(cunit__log.slots);
+	cunit__log.slots  = slots;
+	cunit__log.nslots = nslots;
+	return true;
+}
+
+// Returns the id of a string, writing a string record the first time it is seen.
+static uint32_t cunit__log_intern(const char *s) {
+	if (!s) { return 0; }
+	if (((size_t)cunit__log.strings + 1) * 2 > cunit__log.nslots && !cunit__log_rehash()) { return 0; }
+
+	const uint64_t hash = cunit__log_hash(s);
+	size_t         slot = (size_t)hash & (cunit__log.nslots - 1);
+	for (; cunit__log.slots[slot].hash; slot = (slot + 1) & (cunit__log.nslots - 1)) {
+		const cunit_log_string_t *entry = &cunit__log.slots[slot];
+		if (entry->hash == hash && strcmp(entry->text, s) == 0) { return entry->id; }
+	}
+
+	const size_t size = strlen(s) + 1;
+	char        *text = (char *)malloc(size);
+	if (!text) { return 0; }
+	memcpy(text, s, size);
+
+	cunit_log_record_t record;
+	memset(&record, 0, sizeof(record));
+	record.type = CUNIT_LOG_STRING;
+	if (!cunit__log_emit(&record, s, size, NULL, 0)) {
+		// The id is not taken, so the ids of the strings that follow still match their records.
+		free(text);
+		return 0;
+	}
+
+	cunit_log_string_t *entry = &cunit__log.slots[slot];
+	entry->hash               = hash;
+	entry->id                 = ++cunit__log.strings;
+	entry->text               = text;
+	return entry->id;
+}
+
+static void cunit__log_run_begin(void *data, int total) {
+	(void)data;
+	if (!cunit__log_open()) { return; }
+	cunit_log_record_t record;
+	memset(&record, 0, sizeof(record));
+	record.type = CUNIT_LOG_RUN_BEGIN;
+	record.a    = (uint32_t)total;
+	cunit__log_emit(&record, NULL, 0, NULL, 0);
+}
+
+static void cunit__log_suite_begin(void *data, const char *suite) {
+	(void)data;
+	if (!cunit__log_open()) { return; }
+	cunit_log_record_t record;
+	memset(&record, 0, sizeof(record));
+	record.type = CUNIT_LOG_SUITE_BEGIN;
+	record.x    = cunit__log_intern(suite);
+	cunit__log_emit(&record, NULL, 0, NULL, 0);
+}
+
+static void cunit__log_test_begin(void *data, const char *suite, const char *test) {
+	(void)data;
+	if (!cunit__log_open()) { return; }
+	cunit_log_record_t record;
+	memset(&record, 0, sizeof(record));
+	record.type = CUNIT_LOG_TEST_BEGIN;
+	record.x    = cunit__log_intern(suite);
+	record.y    = cunit__log_intern(test);
+	cunit__log_emit(&record, NULL, 0, NULL, 0);
+}
+
+static void cunit__log_failure(void *data, const cunit_failure_t *failure) {
+	(void)data;
+	if (!cunit__log_open()) { return; }
+	cunit_log_record_t record;
+	memset(&record, 0, sizeof(record));
+	record.type  = CUNIT_LOG_FAILURE;
+	record.flags = (uint8_t)((failure->fatal ? CUNIT_LOG_FATAL : 0) | (failure->message ? CUNIT_LOG_MESSAGE : 0) | (failure->note ? CUNIT_LOG_NOTE : 0));
+	record.a     = (uint32_t)failure->ctx.line;
+	record.x     = cunit__log_intern(failure->ctx.file ? __cunit_relative(failure->ctx.file) : NULL);
+	record.y     = cunit__log_intern(failure->ctx.func);
+	cunit__log_emit(&record, failure->message, failure->message ? strlen(failure->message) + 1 : 0, failure->note,
+					failure->note ? strlen(failure->note) + 1 : 0);
+}
+
+static void cunit__log_test_end(void *data, const cunit_test_report_t *test) {
+	(void)data;
+	if (!cunit__log_open()) { return; }
+	cunit_log_record_t record;
+	memset(&record, 0, sizeof(record));
+	record.type  = CUNIT_LOG_TEST_END;
+	record.flags = (uint8_t)test->status;
+	record.code  = (uint16_t)test->exit_code;
+	record.a     = (uint32_t)test->signal;
+	record.x     = cunit__log_intern(test->suite);
+	record.y     = cunit__log_intern(test->name);
+	// The payload has room for two parts, so the assertions go with the timing.
+	unsigned char head[sizeof(cunit_timing_t) + sizeof(uint64_t)];
+	memcpy(head, test->timing, sizeof(cunit_timing_t));
+	memcpy(head + sizeof(cunit_timing_t), &test->assertions, sizeof(uint64_t));
+	cunit__log_emit(&record, head, sizeof(head), test->bench, test->bench ? sizeof(cunit_bench_stats_t) : 0);
+}
+
+static void cunit__log_suite_end(void *data, const cunit_suite_report_t *suite) {
+	(void)data;
+	if (!cunit__log_open()) { return; }
+	cunit_log_record_t record;
+	memset(&record, 0, sizeof(record));
+	record.type = CUNIT_LOG_SUITE_END;
+	record.a    = (uint32_t)suite->passed;
+	record.x    = cunit__log_intern(suite->name);
+	record.y    = (uint64_t)(uint32_t)suite->failed << 32 | (uint32_t)suite->total;
+	cunit__log_emit(&record, suite->timing, sizeof(cunit_timing_t), &suite->assertions, sizeof(uint64_t));
+}
+
+static void cunit__log_run_end(void *data, const cunit_run_report_t *run) {
+	(void)data;
+	if (!cunit__log_open()) { return; }
+	cunit_log_record_t record;
+	memset(&record, 0, sizeof(record));
+	record.type = CUNIT_LOG_RUN_END;
+	record.a    = (uint32_t)run->passed;
+	record.x    = (uint64_t)run->failed;
+	record.y    = (uint64_t)run->total;
+	cunit__log_emit(&record, &run->assertions, sizeof(uint64_t), &run->duration, sizeof(double));
+	cunit__log_close();
+}
+
+static void cunit__log_flush(void *data) {
+	(void)data;
+	cunit__log_sync();
+}
+
+static const cunit_reporter_t cunit__log_reporter = {
+	NULL,                    // data
+	cunit__log_run_begin,    // run_begin
+	cunit__log_suite_begin,  // suite_begin
+	cunit__log_test_begin,   // test_begin
+	cunit__log_failure,      // failure
+	cunit__log_test_end,     // test_end
+	cunit__log_suite_end,    // suite_end
+	cunit__log_run_end,      // run_end
+	cunit__log_flush,        // flush
+};
+
+// Gets the binary event log reporter, writing to `path`.
+const cunit_reporter_t *cunit_log_reporter(const char *path) {
+	if (cunit__log.path != path) { cunit__log_close(); }
+	cunit__log.path = path;
+	return &cunit__log_reporter;
+}
+
+// A test kept for the list of slowest tests while a log is replayed.
+typedef struct {
+	cunit_test_report_t report;  // The test; its timing points into the next field once ranked.
+	cunit_timing_t      timing;  // Its timing.
+} cunit_log_ranked_t;
+
+// The state of a log being replayed.
+typedef struct {
+	FILE                   *file;          // The log.
+	const cunit_reporter_t *reporter;      // The reporter receiving the events.
+	char                  **strings;       // The strings read so far, by id - 1.
+	size_t                  count;         // The number of strings read.
+	size_t                  capacity;      // The size of `strings`.
+	cunit_buffer_t          payload;       // The payload of the current record.
+	cunit_log_ranked_t     *ranked;        // The slowest tests so far, slowest first.
+	int                     limit;         // The size of `ranked`.
+	int                     ranked_count;  // The number of entries in `ranked`.
+} cunit_log_reader_t;
+
+// Returns the string with the given id, or NULL.
+static inline const char *cunit__log_string(const cunit_log_reader_t *reader, uint64_t id) {
+	return id > 0 && id <= reader->count ? reader->strings[id - 1] : NULL;
+}
+
+// Reads the payload of a record. Returns false if the log is cut short.
+static bool cunit__log_read_payload(cunit_log_reader_t *reader, const cunit_log_record_t *record) {
+	const size_t padded = cunit__log_padded(record->size);
+	cunit_buffer_clear(&reader->payload);
+	if (!cunit_buffer_reserve(&reader->payload, padded)) { return false; }
+	if (fread(reader->payload.data, 1, padded, reader->file) != padded) { return false; }
+	reader->payload.size = (size_t)record->size;
+	return true;
+}
+
+// Remembers a string record.
+static bool cunit__log_read_string(cunit_log_reader_t *reader) {
+	if (reader->count == reader->capacity) {
+		const size_t capacity = reader->capacity ? reader->capacity * 2 : 256;
+		char       **strings  = (char **)realloc(reader->strings, capacity * sizeof(char *));
+		if (!strings) { return false; }
+		reader->strings  = strings;
+		reader->capacity = capacity;
+	}
+	const size_t size = reader->payload.size;
+	char        *text = (char *)malloc(size + 1);
+	if (!text) { return false; }
+	memcpy(text, reader->payload.data, size);
+	text[size]                        = '\0';
+	reader->strings[reader->count++] = text;
+	return true;
+}
+
+// Inserts a test into the list of slowest tests; ties keep log order.
+static void cunit__log_rank(cunit_log_reader_t *reader, const cunit_test_report_t *test) {
+	const int limit = reader->limit;
+	int       count = reader->ranked_count;
+	int       at    = count < limit ? count : limit;
+	while (at > 0 && reader->ranked[at - 1].timing.total.wall < test->timing->total.wall) { at--; }
+	if (at >= limit) { return; }
+	const int moved = (count < limit ? count : limit - 1) - at;
+	memmove(&reader->ranked[at + 1], &reader->ranked[at], (size_t)moved * sizeof(cunit_log_ranked_t));
+	reader->ranked[at].report = *test;
+	reader->ranked[at].timing = *test->timing;
+	if (count < limit) { reader->ranked_count++; }
+}
+
+// Passes one record to the reporter.
+static void cunit__log_dispatch(cunit_log_reader_t *reader, const cunit_log_record_t *record) {
+	const cunit_reporter_t *reporter = reader->reporter;
+	const char             *payload  = reader->payload.data;
+	switch (record->type) {
+		case CUNIT_LOG_RUN_BEGIN:
+			if (reporter->run_begin) { reporter->run_begin(reporter->data, (int)record->a); }
+			break;
+		case CUNIT_LOG_SUITE_BEGIN:
+			if (reporter->suite_begin) { reporter->suite_begin(reporter->data, cunit__log_string(reader, record->x)); }
+			break;
+		case CUNIT_LOG_TEST_BEGIN:
+			if (reporter->test_begin) { reporter->test_begin(reporter->data, cunit__log_string(reader, record->x), cunit__log_string(reader, record->y)); }
+			break;
+		case CUNIT_LOG_FAILURE: {
+			cunit_failure_t failure;
+			memset(&failure, 0, sizeof(failure));
+			failure.ctx.file = cunit__log_string(reader, record->x);
+			failure.ctx.func = cunit__log_string(reader, record->y);
+			failure.ctx.line = (int)record->a;
+			failure.fatal    = (record->flags & CUNIT_LOG_FATAL) != 0;
+			// The payload holds the message and the note, each NUL-terminated.
+			const char *end = payload + reader->payload.size;
+			const char *p   = payload;
+			if ((record->flags & CUNIT_LOG_MESSAGE) && p < end && memchr(p, '\0', (size_t)(end - p))) {
+				failure.message = p;
+				p += strlen(p) + 1;
+			}
+			if ((record->flags & CUNIT_LOG_NOTE) && p < end && memchr(p, '\0', (size_t)(end - p))) { failure.note = p; }
+			if (reporter->failure) { reporter->failure(reporter->data, &failure); }
+			break;
+		}
+		case CUNIT_LOG_TEST_END: {
+			cunit_timing_t      timing;
+			uint64_t            assertions = 0;
+			cunit_bench_stats_t bench;
+			memset(&timing, 0, sizeof(timing));
+			if (reader->payload.size >= sizeof(timing) + sizeof(assertions)) {
+				memcpy(&timing, payload, sizeof(timing));
+				memcpy(&assertions, payload + sizeof(timing), sizeof(assertions));
+			}
+			const bool has_bench = reader->payload.size >= sizeof(timing) + sizeof(assertions) + sizeof(bench);
+			if (has_bench) { memcpy(&bench, payload + sizeof(timing) + sizeof(assertions), sizeof(bench)); }
+
+			cunit_test_report_t test;
+			test.suite      = cunit__log_string(reader, record->x);
+			test.name       = cunit__log_string(reader, record->y);
+			test.status     = record->flags <= CUNIT_STATUS_TIMEOUT ? (cunit_status_t)record->flags : CUNIT_STATUS_FAILED;
+			test.signal     = (int)record->a;
+			test.exit_code  = (int)record->code;
+			test.assertions = assertions;
+			test.timing     = &timing;
+			test.bench      = has_bench ? &bench : NULL;
+			test.alloc      = NULL;
+			test.counters   = NULL;
+			if (reporter->test_end) { reporter->test_end(reporter->data, &test); }
+			if (reader->ranked) { cunit__log_rank(reader, &test); }
+			break;
+		}
+		case CUNIT_LOG_SUITE_END: {
+			cunit_timing_t timing;
+			uint64_t       assertions = 0;
+			memset(&timing, 0, sizeof(timing));
+			if (reader->payload.size >= sizeof(timing)) { memcpy(&timing, payload, sizeof(timing)); }
+			if (reader->payload.size >= sizeof(timing) + sizeof(assertions)) { memcpy(&assertions, payload + sizeof(timing), sizeof(assertions)); }
+
+			cunit_suite_report_t suite;
+			suite.name       = cunit__log_string(reader, record->x);
+			suite.passed     = (int)record->a;
+			suite.failed     = (int)(record->y >> 32);
+			suite.total      = (int)(uint32_t)record->y;
+			suite.assertions = assertions;
+			suite.timing     = &timing;
+			if (reporter->suite_end) { reporter->suite_end(reporter->data, &suite); }
+			break;
+		}
+		case CUNIT_LOG_RUN_END: {
+			cunit_test_report_t *slowest = reader->ranked_count ? (cunit_test_report_t *)calloc((size_t)reader->ranked_count, sizeof(cunit_test_report_t)) : NULL;
+			cunit_run_report_t   run;
+			memset(&run, 0, sizeof(run));
+			run.passed = (int)record->a;
+			run.failed = (int)record->x;
+			run.total  = (int)record->y;
+			if (reader->payload.size >= sizeof(run.assertions) + sizeof(run.duration)) {
+				memcpy(&run.assertions, payload, sizeof(run.assertions));
+				memcpy(&run.duration, payload + sizeof(run.assertions), sizeof(run.duration));
+			}
+			for (int i = 0; slowest && i < reader->ranked_count; i++) {
+				slowest[i]          = reader->ranked[i].report;
+				slowest[i].timing   = &reader->ranked[i].timing;
+				slowest[i].bench    = NULL;
+				slowest[i].alloc    = NULL;
+				slowest[i].counters = NULL;
+			}
+			run.slowest       = slowest;
+			run.slowest_count = slowest ? reader->ranked_count : 0;
+			if (reporter->run_end) { reporter->run_end(reporter->data, &run); }
+			free(slowest);
+			reader->ranked_count = 0;
+			break;
+		}
+		default: break;  // Records from a newer version are skipped.
+	}
+}
+
+// Replays a binary event log into a reporter.
+bool cunit_log_replay(const char *path, const cunit_reporter_t *reporter) {
+	if (!path || !reporter) { return false; }
+	cunit_log_reader_t reader;
+	memset(&reader, 0, sizeof(reader));
+	reader.reporter = reporter;
+	reader.file     = fopen(path, "rb");
+	if (!reader.file) { return false; }
+
+	cunit_log_header_t header;
+	if (fread(&header, 1, sizeof(header), reader.file) != sizeof(header) || memcmp(header.magic, CUNIT_LOG_MAGIC, sizeof(header.magic)) != 0 ||
+		header.version != CUNIT_LOG_VERSION || header.endian != CUNIT_LOG_ENDIAN || header.record_size != sizeof(cunit_log_record_t) ||
+		header.timing_size != sizeof(cunit_timing_t) || header.bench_size != sizeof(cunit_bench_stats_t)) {
+		fclose(reader.file);
+		return false;
+	}
+
+	reader.limit  = cunit__registry.slowest;
+	reader.ranked = reader.limit > 0 ? (cunit_log_ranked_t *)calloc((size_t)reader.limit, sizeof(cunit_log_ranked_t)) : NULL;
+
+	cunit_log_record_t record;
+	while (fread(&record, 1, sizeof(record), reader.file) == sizeof(record) && record.type != CUNIT_LOG_END) {
+		if (!cunit__log_read_payload(&reader, &record)) { break; }
+		if (record.type == CUNIT_LOG_STRING) {
+			if (!cunit__log_read_string(&reader)) { break; }
+			continue;
+		}
+		cunit__log_dispatch(&reader, &record);
+	}
+	if (reporter->flush) { reporter->flush(reporter->data); }
+
+	fclose(reader.file);
+	for (size_t i = 0; i < reader.count; i++) { free(reader.strings[i]); }
+	free(reader.strings);
+	free(reader.ranked);
+	cunit_buffer_free(&reader.payload);
+	return true;
+}
@@ -0,0 +1,89 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 tayne3
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ * 2. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *    SOFTWARE.
+ */
+#ifndef CUNIT_LOG_H
+#define CUNIT_LOG_H
+
+#include "cunit/def.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// The layout of a binary event log. The file starts with a header, followed by
+// fixed-size records. A record may be followed by `size` bytes of payload, padded
+// to whole records. The log ends at the first record whose type is zero, which is
+// also how a log left behind by a crashed run ends.
+//
+// Names, files and functions are interned: each is written once as a string record,
+// and the n-th string record of the log has the id n. Id 0 stands for NULL.
+
+#define CUNIT_LOG_MAGIC   "CUNITLOG"
+#define CUNIT_LOG_VERSION 2
+#define CUNIT_LOG_ENDIAN  0x01020304u
+
+// The types of records.
+enum {
+	CUNIT_LOG_END = 0,      // No more records.
+	CUNIT_LOG_STRING,       // Payload: the string and its terminator.
+	CUNIT_LOG_RUN_BEGIN,    // a = total.
+	CUNIT_LOG_SUITE_BEGIN,  // x = suite.
+	CUNIT_LOG_TEST_BEGIN,   // x = suite, y = test.
+	CUNIT_LOG_FAILURE,      // flags = CUNIT_LOG_FATAL..., a = line, x = file, y = func; payload: message and note.
+	CUNIT_LOG_TEST_END,     // flags = status, code = exit code, a = signal, x = suite, y = test; payload: timing, assertions, then bench stats.
+	CUNIT_LOG_SUITE_END,    // a = passed, x = suite, y = failed << 32 | total; payload: timing, then assertions.
+	CUNIT_LOG_RUN_END,      // a = passed, x = failed, y = total; payload: assertions, then duration.
+};
+
+// The flags of a failure record.
+#define CUNIT_LOG_FATAL   0x01  // The failure ended the test.
+#define CUNIT_LOG_MESSAGE 0x02  // The payload starts with a message.
+#define CUNIT_LOG_NOTE    0x04  // The payload ends with a note.
+
+// The header at the start of a log.
+typedef struct {
+	char     magic[8];      // CUNIT_LOG_MAGIC, without its terminator.
+	uint32_t version;       // CUNIT_LOG_VERSION.
+	uint32_t endian;        // CUNIT_LOG_ENDIAN, as written by the host.
+	uint32_t record_size;   // sizeof(cunit_log_record_t).
+	uint32_t timing_size;   // sizeof(cunit_timing_t).
+	uint32_t bench_size;    // sizeof(cunit_bench_stats_t).
+	uint32_t reserved;      // Zero.
+} cunit_log_header_t;
+
+// One record of a log.
+typedef struct {
+	uint8_t  type;   // The type of record.
+	uint8_t  flags;  // Type-specific flags.
+	uint16_t code;   // Type-specific small value.
+	uint32_t a;      // Type-specific value.
+	uint64_t x;      // Type-specific value.
+	uint64_t y;      // Type-specific value.
+	uint64_t size;   // The size of the payload that follows, in bytes.
+} cunit_log_record_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // CUNIT_LOG_H
@@ -0,0 +1,120 @@
+#include "pool.h"
+
+#include "thread.h"
+
+// A work-stealing deque holding a fixed set of item indices.
+typedef struct {
+	cunit_mutex_t lock;   // Protects head and tail.
+	size_t       *items;  // Item indices owned by this worker.
+	size_t        head;   // Next item the owner takes.
+	size_t        tail;   // One past the last item; thieves take from here.
+} cunit_deque_t;
+
+// Shared state for one pool run.
+typedef struct {
+	cunit_deque_t    *deques;   // One deque per worker.
+	int               workers;  // The number of workers.
+	cunit_pool_task_t task;     // The task callback.
+	void             *arg;      // The task argument.
+} cunit_pool_t;
+
+// Per-thread start argument.
+typedef struct {
+	cunit_pool_t *pool;   // The pool being run.
+	int           index;  // The worker index.
+} cunit_pool_worker_t;
+
+// Takes the next item from the front of the worker's own deque.
+static bool cunit__deque_pop(cunit_deque_t *deque, size_t *item) {
+	bool found = false;
+	cunit_mutex_lock(&deque->lock);
+	if (deque->head < deque->tail) {
+		*item = deque->items[deque->head++];
+		found = true;
+	}
+	cunit_mutex_unlock(&deque->lock);
+	return found;
+}
+
+// Steals an item from the back of another worker's deque.
+static bool cunit__deque_steal(cunit_deque_t *deque, size_t *item) {
+	bool found = false;
+	cunit_mutex_lock(&deque->lock);
+	if (deque->head < deque->tail) {
+		*item = deque->items[--deque->tail];
+		found = true;
+	}
+	cunit_mutex_unlock(&deque->lock);
+	return found;
+}
+
+// Runs items until no deque has work left.
+static void cunit__pool_worker(void *param) {
+	const cunit_pool_worker_t *self = (const cunit_pool_worker_t *)param;
+	cunit_pool_t              *pool = self->pool;
+
+	for (;;) {
+		size_t item;
+		if (cunit__deque_pop(&pool->deques[self->index], &item)) {
+			pool->task(pool->arg, item, self->index);
+			continue;
+		}
+
+		// Items are never added once the run starts, so a full sweep
+		// over every deque without a successful steal means we are done.
+		bool stolen = false;
+		for (int i = 1; i < pool->workers && !stolen; i++) {
+			stolen = cunit__deque_steal(&pool->deques[(self->index + i) % pool->workers], &item);
+		}
+		if (!stolen) { return; }
+		pool->task(pool->arg, item, self->index);
+	}
+}
+
+void cunit__pool_run(size_t count, int workers, cunit_pool_task_t task, void *arg) {
+	if (workers > (int)count) { workers = (int)count; }
+	if (workers < 1) { workers = 1; }
+
+	cunit_deque_t       *deques  = (cunit_deque_t *)calloc((size_t)workers, sizeof(cunit_deque_t));
+	size_t              *items   = (size_t *)malloc((count ? count : 1) * sizeof(size_t));
+	cunit_pool_worker_t *starts  = (cunit_pool_worker_t *)calloc((size_t)workers, sizeof(cunit_pool_worker_t));
+	cunit_thread_t      *threads = (cunit_thread_t *)calloc((size_t)workers, sizeof(cunit_thread_t));
+	if (!deques || !items || !starts || !threads) {
+		for (size_t i = 0; i < count; i++) { task(arg, i, 0); }
+		goto cleanup;
+	}
+
+	// Deal items round-robin so every deque starts with the same mix of
+	// early and late work, and lay each deque out contiguously.
+	size_t offset = 0;
+	for (int w = 0; w < workers; w++) {
+		cunit_deque_t *deque = &deques[w];
+		cunit_mutex_init(&deque->lock);
+		deque->items = items + offset;
+		for (size_t i = (size_t)w; i < count; i += (size_t)workers) { deque->items[deque->tail++] = i; }
+		offset += deque->tail;
+	}
+
+	cunit_pool_t pool = {deques, workers, task, arg};
+	int          started;
+	for (started = 1; started < workers; started++) {
+		starts[started].pool  = &pool;
+		starts[started].index = started;
+		if (cunit_thread_create(&threads[started], cunit__pool_worker, &starts[started]) != 0) { break; }
+	}
+
+	// The calling thread is worker 0; it also picks up the work of any
+	// worker that failed to start by stealing from its deque.
+	starts[0].pool  = &pool;
+	starts[0].index = 0;
+	cunit__pool_worker(&starts[0]);
+
+	for (int w = 1; w < started; w++) { cunit_thread_join(threads[w]); }
+	for (int w = 0; w < workers; w++) { cunit_mutex_destroy(&deques[w].lock); }
+
+cleanup:
+	free(threads);
+	free(starts);
+	free(items);
+	free(deques);
+}
@@ -0,0 +1,49 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 tayne3
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ * 2. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *    SOFTWARE.
+ */
+#ifndef CUNIT_POOL_H
+#define CUNIT_POOL_H
+
+#include "cunit/def.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Task callback: runs work item `item` on worker `worker` (0 is the calling thread).
+typedef void (*cunit_pool_task_t)(void *arg, size_t item, int worker);
+
+/**
+ * Runs `count` work items on `workers` threads using per-worker deques.
+ * Items are dealt round-robin in the given order; each worker drains its own
+ * deque from the front and steals from the back of the others once empty.
+ * Returns after every item has completed. Falls back to running everything
+ * on the calling thread if the worker threads cannot be created.
+ */
+void cunit__pool_run(size_t count, int workers, cunit_pool_task_t task, void *arg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // CUNIT_POOL_H
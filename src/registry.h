@@ -0,0 +1,424 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 tayne3
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ * 2. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *    SOFTWARE.
+ */
+#ifndef CUNIT_REGISTRY_H
+#define CUNIT_REGISTRY_H
+
+#include <setjmp.h>
+
+#include "arena.h"
+#include "buffer.h"
+#include "cunit/reporter.h"
+#include "cunit/set.h"
+#include "db.h"
+#include "thread.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Represents the result of one test run. Plain data, so that forked
+// workers can send it back to the parent as-is.
+typedef struct {
+	cunit_status_t      status;      // The outcome of the test.
+	int                 signal;      // The signal that killed the worker, if it crashed.
+	int                 exit_code;   // The exit code of the worker, if it exited mid-test.
+	cunit_timing_t      timing;      // Time spent in setup, test and teardown.
+	cunit_bench_stats_t bench;       // The measurement, if the test is a benchmark that completed it.
+	cunit_alloc_stats_t alloc;       // The heap use of the test, if allocations are tracked.
+	cunit_counters_t    counters;    // The hardware counters of the test body, if measured.
+	uint64_t            assertions;  // The checks and assertions the test made.
+} cunit_result_t;
+
+// Represents a single test case.
+struct cunit_test {
+	const char        *name;         // The name of the test.
+	cunit_test_func_t  func;         // A pointer to the test function.
+	cunit_bench_func_t bench;        // A pointer to the benchmark function, if the test is a benchmark.
+	const char        *tags;         // The tags of the test, separated by commas or spaces, or NULL.
+	double             timeout;      // The longest time the test may take in seconds, or 0 for the global timeout.
+	struct cunit_test *next;         // A pointer to the next test in the suite.
+	struct cunit_test *twin;         // The next test of the suite with the same name, in registration order.
+	bool               matched;      // Whether the test passes the filter.
+	bool               selected;     // Whether the test is part of the current run.
+	bool               failed_last;  // Whether the test failed in the last recorded run.
+	cunit_result_t     result;       // The result of the last run.
+	char              *events;       // The failures recorded while it ran off the main thread, if any.
+	size_t             events_size;  // The size of `events` in bytes.
+};
+
+// Represents a test suite, which is a collection of tests.
+struct cunit_suite {
+	const char           *name;            // The name of the test suite.
+	cunit_setup_func_t    setup;           // A pointer to the setup function for the suite.
+	cunit_teardown_func_t teardown;        // A pointer to the teardown function for the suite.
+	cunit_test_t         *tests;           // A pointer to the first test in the suite.
+	cunit_test_t         *last_test;       // A pointer to the last test in the suite.
+	struct cunit_suite   *next;            // A pointer to the next test suite.
+	struct cunit_suite   *twin;            // The next suite with the same name, in registration order.
+	int                   test_count;      // The number of tests in the suite.
+	int                   selected_count;  // The number of tests selected for the current run.
+	int                   passed_count;    // The number of passed tests in the suite.
+	int                   failed_count;    // The number of failed tests in the suite.
+	cunit_timing_t        timing;          // The summed timing of the tests reported so far.
+	uint64_t              assertions;      // The checks and assertions made by the tests reported so far.
+};
+
+// An entry of the name index: a suite, or a test of the suite `owner`.
+typedef struct {
+	uint64_t             hash;   // The hash of the owner and name, or 0 for an empty slot.
+	const cunit_suite_t *owner;  // The suite of a test, or NULL for a suite.
+	void                *entry;  // The first cunit_suite_t or cunit_test_t of the name.
+	void                *last;   // The last of them, to which the next one is chained as its twin.
+} cunit_index_slot_t;
+
+// A hash index of suites by name and of tests by suite and name.
+typedef struct {
+	cunit_index_slot_t *slots;   // The entries, by hash.
+	size_t              nslots;  // The size of `slots`, a power of two.
+	size_t              count;   // The number of entries.
+	bool                partial; // Whether a suite or test could not be added.
+} cunit_index_t;
+
+// The number of hardware counters, one per cunit_counter_t.
+#define CUNIT_COUNTERS 4
+
+// The hardware counters a thread has opened.
+typedef struct {
+	bool opened;               // Whether the counters were opened, even if the kernel refused them.
+	int  pid;                  // The process that opened them, since a forked child must open its own.
+	int  fds[CUNIT_COUNTERS];  // The file descriptor of each counter, or -1.
+	int  grouped;              // The counters that count together in the group led by fds[0], one bit each.
+} cunit_perf_t;
+
+// Represents the per-thread state of a thread executing tests.
+typedef struct cunit_worker {
+	bool                 test_failed;      // A flag indicating whether the current test has failed.
+	jmp_buf              test_jmp_buf;     // Jump buffer for early test exit in COLLECT mode.
+	int                  passed;           // The number of tests this thread has passed.
+	int                  failed;           // The number of tests this thread has failed.
+	uint64_t             wall;             // When the current test body started (wall clock).
+	uint64_t             cpu;              // When the current test body started (thread CPU time).
+	cunit_bench_stats_t  bench;            // The measurement of the current benchmark.
+	bool                 record;           // Whether failures are recorded for later replay instead of reported.
+	cunit_buffer_t       events;           // The failures recorded for the current test.
+#ifndef _WIN32
+	sigjmp_buf           timeout_jmp_buf;  // Jump buffer for leaving a test that ran past its timeout.
+#endif
+	cunit_thread_t       thread;           // The thread running the watched test.
+	cunit_suite_t       *suite;            // The suite of the running test.
+	cunit_test_t        *test;             // The running test.
+	uint64_t             started;          // When the running test started.
+	uint64_t             deadline;         // When the watchdog acts next on the watched test.
+	volatile bool        timed_out;        // Whether the watched test ran past its timeout.
+	struct cunit_worker *armed_next;       // The next worker whose test the watchdog watches.
+	cunit_perf_t         perf;             // The hardware counters of the thread.
+} cunit_worker_t;
+
+// Represents the global registry for all test suites and test results.
+typedef struct {
+	cunit_suite_t          *suites;                          // A pointer to the first test suite.
+	cunit_suite_t          *current_suite;                   // A pointer to the current test suite being added to.
+	cunit_suite_t          *last_suite;                      // A pointer to the last test suite in the list.
+	int                     total_suites;                    // The total number of suites.
+	int                     total_tests;                     // The total number of tests across all suites.
+	int                     total_selected;                  // The total number of tests selected for the current run.
+	int                     total_passed;                    // The total number of passed tests across all suites.
+	int                     total_failed;                    // The total number of failed tests across all suites.
+	uint64_t                total_assertions;                // The checks and assertions made by the tests reported so far.
+	double                  total_wall;                      // The summed wall-clock time of the tests reported so far.
+	int                     total_unisolated;                // The tests of the fork mode that ran in-process, since no worker could be started.
+	cunit_arena_t           arena;                           // The memory of the suites and tests.
+	cunit_index_t           index;                           // The suites and tests by name.
+	const char             *filter;                          // The patterns selecting the tests to run, or NULL.
+	int                     jobs;                            // The number of worker threads or processes (<= 1 runs serially).
+	int                     shard_index;                     // The shard this process runs.
+	int                     shard_count;                     // The number of shards (<= 1 disables sharding).
+	int                     slowest;                         // The number of slowest tests listed after the run.
+	double                  bench_time;                      // The target seconds per benchmark repetition.
+	int                     bench_repetitions;               // The number of timed repetitions per benchmark.
+	double                  bench_threshold;                 // The allowed slowdown against the baseline, in percent.
+	double                  bench_sigmas;                    // The robust standard deviations a slowdown must exceed.
+	bool                    bench_update;                    // Whether to overwrite the baseline instead of comparing.
+	const char             *bench_baseline;                  // The benchmark baseline file, or NULL.
+	cunit_db_t              baseline;                        // The benchmark baseline (values = median, MAD, mean, stddev).
+	const cunit_reporter_t *reporters[CUNIT_MAX_REPORTERS];  // The installed reporters.
+	int                     reporter_count;                  // The number of installed reporters.
+	const char             *timing_file;                     // The timing history file, or NULL.
+	cunit_db_t              timings;                         // The timing history (values[0] = seconds).
+	const char             *failed_file;                     // The file listing the tests that failed last, or NULL.
+	cunit_db_t              failed;                          // The tests that failed last.
+	cunit_rerun_mode_t      rerun_mode;                      // Whether failed tests run first or alone.
+	double                  timeout;                         // The longest time a test may take in seconds (0 = none).
+	bool                    counters;                        // Whether to measure hardware counters around test bodies.
+	cunit_zero_assertions_t zero_assertions;                 // How a test that made no checks or assertions is treated.
+	int                     hex_context;                     // The rows shown around each difference of a hex diff.
+	int                     hex_ranges;                      // The ranges of differences a hex diff shows (0 = all).
+	bool                    update_golden;                   // Whether golden-file checks rewrite the files rather than compare.
+	cunit_error_mode_t      error_mode;                      // The error handling mode.
+	cunit_exec_mode_t       exec_mode;                       // The test execution mode.
+	bool                    is_initialized;                  // A flag indicating whether the registry has been initialized.
+	bool                    test_running;                    // A flag indicating whether a test is currently running.
+	bool                    auto_registered;                 // Whether the CUNIT_TEST_AUTO() tests have been added.
+	bool                    stopped;                         // Whether a failure stopped the run in FAIL_FAST mode.
+} cunit_registry_t;
+
+// Initializes a cunit_registry_t struct with default values.
+#define CUNIT_REGISTRY_INIT                              \
+	{                                                    \
+		.suites            = NULL,                       \
+		.current_suite     = NULL,                       \
+		.last_suite        = NULL,                       \
+		.total_suites      = 0,                          \
+		.total_tests       = 0,                          \
+		.total_selected    = 0,                          \
+		.total_passed      = 0,                          \
+		.total_failed      = 0,                          \
+		.total_assertions  = 0,                          \
+		.total_wall        = 0.0,                        \
+		.total_unisolated  = 0,                          \
+		.arena             = CUNIT_ARENA_INIT,           \
+		.filter            = NULL,                       \
+		.jobs              = 1,                          \
+		.shard_index       = 0,                          \
+		.shard_count       = 0,                          \
+		.slowest           = 5,                          \
+		.bench_time        = 0.01,                       \
+		.bench_repetitions = 10,                         \
+		.bench_threshold   = 10.0,                       \
+		.bench_sigmas      = 3.0,                        \
+		.bench_update      = false,                      \
+		.bench_baseline    = NULL,                       \
+		.reporters         = {&cunit__console_reporter}, \
+		.reporter_count    = 1,                          \
+		.timing_file       = NULL,                       \
+		.failed_file       = NULL,                       \
+		.rerun_mode        = CUNIT_RERUN_ALL,            \
+		.timeout           = 0.0,                        \
+		.counters          = false,                      \
+		.zero_assertions   = CUNIT_ZERO_ASSERTIONS_WARN, \
+		.hex_context       = 2,                          \
+		.hex_ranges        = 1,                          \
+		.update_golden     = false,                      \
+		.error_mode        = CUNIT_ERROR_MODE_COLLECT,   \
+		.exec_mode         = CUNIT_EXEC_MODE_THREAD,     \
+		.is_initialized    = false,                      \
+		.test_running      = false,                      \
+		.auto_registered   = false,                      \
+		.stopped           = false,                      \
+	}
+
+// A unit of work for the thread and process pools.
+typedef struct {
+	cunit_suite_t *suite;  // The suite the work belongs to.
+	cunit_test_t  *test;   // The test to run, or NULL to run every test in the suite.
+	bool           first;  // Whether the work must start before any other, for CUNIT_RERUN_FAILED_FIRST.
+	double         cost;   // The expected duration in seconds, for scheduling.
+	size_t         order;  // The registration order, used to break ties.
+} cunit_work_t;
+
+// The largest number of repetitions a benchmark can be measured with.
+#define CUNIT_BENCH_MAX_REPETITIONS 1000
+
+// The global instance of the test registry.
+extern cunit_registry_t cunit__registry;
+
+// The default reporter.
+extern const cunit_reporter_t cunit__console_reporter;
+
+// Runs a single test case on the calling thread and records its result.
+void cunit__run_test(cunit_suite_t *suite, cunit_test_t *test);
+
+// Runs work items of the fork mode on the calling thread, without crash isolation.
+// Their failures are recorded and their results left to the caller to count, as
+// for the items that ran in worker processes.
+void cunit__run_unisolated(cunit_work_t *works, size_t count);
+
+// Returns whether a test is to be warned about or failed for making no checks or assertions.
+bool cunit__zero_assertions(const cunit_test_report_t *test);
+
+// Calibrates and measures a benchmark on the calling thread.
+void cunit__bench_measure(cunit_bench_func_t func, cunit_bench_stats_t *stats);
+
+// Loads the benchmark baseline, if a baseline file is configured.
+void cunit__baseline_load(void);
+
+// Adds new (or in update mode, all) benchmark results to the baseline and saves it.
+void cunit__baseline_save(void);
+
+// Fails the current benchmark if its median regressed against the baseline.
+void cunit__baseline_check(const cunit_suite_t *suite, const cunit_test_t *test, const cunit_bench_stats_t *stats);
+
+// Reports a failed check or assertion, or records it if the calling thread runs
+// tests whose results are reported later.
+void cunit__report_failure(const cunit_failure_t *failure);
+
+// Makes the calling thread record failures for later replay.
+void cunit__record_failures(bool record);
+
+// Appends a failure to a recording.
+void cunit__events_record(cunit_buffer_t *events, const cunit_failure_t *failure);
+
+// Passes the failures of a recording to the reporters.
+void cunit__events_replay(const char *events, size_t size);
+
+// Describes a test that has run, for the reporters.
+void cunit__test_report(cunit_test_report_t *report, const cunit_suite_t *suite, const cunit_test_t *test);
+
+// Passes events to every installed reporter.
+void cunit__report_run_begin(int total);
+void cunit__report_suite_begin(const cunit_suite_t *suite);
+void cunit__report_test_begin(const cunit_suite_t *suite, const cunit_test_t *test);
+void cunit__report_dispatch(const cunit_failure_t *failure);
+void cunit__report_test_end(const cunit_suite_t *suite, const cunit_test_t *test);
+void cunit__report_suite_end(const cunit_suite_t *suite);
+void cunit__report_run_end(const cunit_run_report_t *run);
+void cunit__report_flush(void);
+
+// Closes the output files of the JUnit, JSON Lines and event log reporters.
+void cunit__junit_close(void);
+void cunit__json_close(void);
+void cunit__log_close(void);
+
+// Gives stdout a large buffer unless it is a terminal. The console reporter
+// writes into it as the tests do, and it is flushed with the reporters.
+void cunit__console_init(void);
+
+// Loads the timing history, if a timing file is configured.
+void cunit__timing_load(void);
+
+// Records the durations of the tests that ran and saves the timing history.
+void cunit__timing_save(void);
+
+// Returns the recorded duration of a test in seconds, or a negative value if unknown.
+double cunit__timing_get(const cunit_suite_t *suite, const cunit_test_t *test);
+
+// Orders units of work longest first by their recorded durations, if any.
+void cunit__timing_schedule(cunit_work_t *works, size_t count);
+
+// Returns the timeout of a test in seconds, or 0 if it has none.
+double cunit__timeout_of(const cunit_test_t *test);
+
+// Starts the watchdog that interrupts in-process tests running past their
+// timeout, unless it is running or no selected test has a timeout.
+void cunit__watchdog_start(void);
+
+// Stops the watchdog and forgets whether it aborted the run. Once a test timed
+// out, the watchdog ends the process if the report goes a second without a
+// heartbeat after the last test stopped, so it is called once the run has been reported.
+void cunit__watchdog_stop(void);
+
+// Makes the watchdog watch the test the calling thread is about to run.
+// Returns false, leaving the test out of the run, once a timeout aborted it.
+bool cunit__watchdog_arm(cunit_worker_t *worker, cunit_suite_t *suite, cunit_test_t *test);
+
+// Stops watching the calling thread's test.
+void cunit__watchdog_disarm(cunit_worker_t *worker);
+
+// Aborts the run after the calling thread's test timed out, and returns how
+// long the test ran in seconds. The watchdog goes on watching for the report.
+double cunit__watchdog_trip(cunit_worker_t *worker);
+
+// Returns whether a timeout has aborted the run.
+bool cunit__watchdog_aborted(void);
+
+// Leaves a test that has not run out of an aborted or stopped run.
+void cunit__watchdog_skip(cunit_suite_t *suite, cunit_test_t *test);
+
+// Tells the watchdog that the report of an aborted run is making progress.
+void cunit__watchdog_beat(void);
+
+// Starts counting hardware events on the calling thread, opening its counters
+// on first use, if counters are enabled.
+void cunit__counters_start(cunit_perf_t *perf);
+
+// Stops counting and reads the counts, or leaves `counters` unavailable.
+void cunit__counters_stop(cunit_perf_t *perf, cunit_counters_t *counters);
+
+// Closes the counters of a thread.
+void cunit__counters_close(cunit_perf_t *perf);
+
+// Makes the heap allocations of tests tracked. Called by the wrappers of
+// cunit::alloc when the program starts.
+void cunit__alloc_enable(void);
+
+// Notes a block allocated or freed by the calling thread.
+void cunit__alloc_note_malloc(void *ptr, size_t size);
+void cunit__alloc_note_free(void *ptr);
+
+// Starts and stops counting the calling thread's allocations for a test.
+void cunit__alloc_begin(void);
+void cunit__alloc_end(cunit_alloc_stats_t *stats);
+
+// Stops and resumes counting while cunit itself allocates for the running test.
+void cunit__alloc_suspend(void);
+void cunit__alloc_resume(void);
+
+// Registers a suite or test in the name index.
+void cunit__index_add_suite(cunit_suite_t *suite);
+void cunit__index_add_test(cunit_suite_t *suite, cunit_test_t *test);
+
+// Finds the first suite, or the first test of a suite, registered under a name.
+// The others of the same name follow it through `twin`.
+cunit_suite_t *cunit__index_find_suite(const char *name);
+cunit_test_t  *cunit__index_find_test(const cunit_suite_t *suite, const char *name);
+
+// Releases the memory of an index.
+void cunit__index_free(cunit_index_t *index);
+
+// Counts the elements of an array, of the type a set was built from, that are not in
+// the set, and stores the index of the first of them in `first` (`count` if none).
+size_t cunit__set_missing(const cunit_set_t *set, const void *array, size_t count, size_t *first);
+
+// Reads an element of an array of the type a set was built from.
+cunit_value_t cunit__set_value(const cunit_set_t *set, const void *array, size_t i);
+
+// Adds the CUNIT_TEST_AUTO() tests to the registry, once per registry.
+void cunit__auto_register(void);
+
+// Marks the tests that pass the filter as matched.
+void cunit__filter_select(void);
+
+// Marks the tests that failed last and, for CUNIT_RERUN_LAST_FAILED, unmatches the others.
+void cunit__rerun_select(void);
+
+// Moves the tests that failed last ahead of the others, for CUNIT_RERUN_FAILED_FIRST.
+void cunit__rerun_order(void);
+
+// Records the tests of `only` (or of all suites if NULL) that failed in this run.
+void cunit__rerun_save(const cunit_suite_t *only);
+
+// Marks the matched tests that belong to this process's shard as selected.
+void cunit__shard_select(void);
+
+// Runs the given tests in a pool of forked worker processes, storing each
+// result in its test. In FAIL_FAST mode, the first test that does not pass
+// stops the run: the tests that did not finish are deselected and `stopped` is
+// set. Returns false if the pool could not be started.
+bool cunit__run_forked(cunit_work_t *works, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // CUNIT_REGISTRY_H
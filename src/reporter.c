@@ -0,0 +1,132 @@
+#include "registry.h"
+
+// Calls `callback` with `args` on every installed reporter that implements it.
+// Each call is a heartbeat for the watchdog, which stands by once a test timed out.
+#define CUNIT_REPORT(callback, ...)                                          \
+	do {                                                                     \
+		for (int i = 0; i < cunit__registry.reporter_count; i++) {           \
+			const cunit_reporter_t *reporter = cunit__registry.reporters[i]; \
+			if (!reporter->callback) { continue; }                           \
+			cunit__watchdog_beat();                                          \
+			reporter->callback(reporter->data, __VA_ARGS__);                 \
+		}                                                                    \
+	} while (0)
+
+void cunit__report_run_begin(int total) { CUNIT_REPORT(run_begin, total); }
+
+void cunit__report_suite_begin(const cunit_suite_t *suite) { CUNIT_REPORT(suite_begin, suite->name); }
+
+void cunit__report_test_begin(const cunit_suite_t *suite, const cunit_test_t *test) { CUNIT_REPORT(test_begin, suite->name, test->name); }
+
+void cunit__report_dispatch(const cunit_failure_t *failure) { CUNIT_REPORT(failure, failure); }
+
+void cunit__test_report(cunit_test_report_t *report, const cunit_suite_t *suite, const cunit_test_t *test) {
+	report->suite      = suite->name;
+	report->name       = test->name;
+	report->status     = test->result.status;
+	report->signal     = test->result.signal;
+	report->exit_code  = test->result.exit_code;
+	report->assertions = test->result.assertions;
+	report->timing     = &test->result.timing;
+	report->bench      = test->result.bench.repetitions ? &test->result.bench : NULL;
+	report->alloc      = cunit_alloc_tracking() ? &test->result.alloc : NULL;
+	report->counters   = test->result.counters.available ? &test->result.counters : NULL;
+}
+
+void cunit__report_test_end(const cunit_suite_t *suite, const cunit_test_t *test) {
+	cunit_test_report_t report;
+	cunit__test_report(&report, suite, test);
+	CUNIT_REPORT(test_end, &report);
+}
+
+void cunit__report_suite_end(const cunit_suite_t *suite) {
+	cunit_suite_report_t report;
+	report.name       = suite->name;
+	report.passed     = suite->passed_count;
+	report.failed     = suite->failed_count;
+	report.total      = suite->selected_count;
+	report.assertions = suite->assertions;
+	report.timing     = &suite->timing;
+	CUNIT_REPORT(suite_end, &report);
+}
+
+void cunit__report_run_end(const cunit_run_report_t *run) { CUNIT_REPORT(run_end, run); }
+
+void cunit__report_flush(void) {
+	for (int i = 0; i < cunit__registry.reporter_count; i++) {
+		const cunit_reporter_t *reporter = cunit__registry.reporters[i];
+		if (!reporter->flush) { continue; }
+		cunit__watchdog_beat();
+		reporter->flush(reporter->data);
+	}
+}
+
+// A recorded failure is a header followed by its strings, each NUL-terminated:
+// file, func, message and note, where an empty string stands for NULL.
+typedef struct {
+	int32_t line;   // The line of the check.
+	uint8_t fatal;  // Whether the failure ended the test.
+} cunit_event_t;
+
+static inline void cunit__events_put_str(cunit_buffer_t *events, const char *s) { cunit_buffer_append(events, s ? s : "", s ? strlen(s) + 1 : 1); }
+
+void cunit__events_record(cunit_buffer_t *events, const cunit_failure_t *failure) {
+	cunit_event_t event;
+	memset(&event, 0, sizeof(event));
+	event.line  = failure->ctx.line;
+	event.fatal = failure->fatal;
+	cunit_buffer_append(events, &event, sizeof(event));
+	cunit__events_put_str(events, failure->ctx.file);
+	cunit__events_put_str(events, failure->ctx.func);
+	cunit__events_put_str(events, failure->message);
+	cunit__events_put_str(events, failure->note);
+}
+
+// Reads a string written by cunit__events_put_str, or returns NULL if the recording is cut short.
+static const char *cunit__events_get_str(const char **p, const char *end) {
+	const char *s   = *p;
+	const char *nul = (const char *)memchr(s, '\0', (size_t)(end - s));
+	if (!nul) { return NULL; }
+	*p = nul + 1;
+	return s;
+}
+
+void cunit__events_replay(const char *events, size_t size) {
+	const char *p = events, *end = events + size;
+	while ((size_t)(end - p) >= sizeof(cunit_event_t)) {
+		cunit_event_t event;
+		memcpy(&event, p, sizeof(event));
+		p += sizeof(event);
+
+		const char *file    = cunit__events_get_str(&p, end);
+		const char *func    = file ? cunit__events_get_str(&p, end) : NULL;
+		const char *message = func ? cunit__events_get_str(&p, end) : NULL;
+		const char *note    = message ? cunit__events_get_str(&p, end) : NULL;
+		if (!note) { return; }
+
+		cunit_failure_t failure;
+		failure.ctx.file = *file ? file : NULL;
+		failure.ctx.func = *func ? func : NULL;
+		failure.ctx.line = event.line;
+		failure.message  = *message ? message : NULL;
+		failure.note     = *note ? note : NULL;
+		failure.fatal    = event.fatal != 0;
+		cunit__report_dispatch(&failure);
+	}
+}
+
+// Gets the default reporter.
+const cunit_reporter_t *cunit_console_reporter(void) { return &cunit__console_reporter; }
+
+// Replaces all installed reporters with one.
+void cunit_set_reporter(const cunit_reporter_t *reporter) {
+	cunit__report_flush();
+	cunit__registry.reporters[0]   = reporter;
+	cunit__registry.reporter_count = reporter ? 1 : 0;
+}
+
+// Installs an additional reporter.
+void cunit_add_reporter(const cunit_reporter_t *reporter) {
+	if (!reporter || cunit__registry.reporter_count >= CUNIT_MAX_REPORTERS) { return; }
+	cunit__registry.reporters[cunit__registry.reporter_count++] = reporter;
+}
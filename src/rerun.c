@@ -0,0 +1,98 @@
+#include "registry.h"
+
+// The file used when a rerun mode is set without one.
+#define CUNIT_FAILED_FILE_DEFAULT ".cunit-failed"
+
+// Returns the file listing the tests that failed last, or NULL if none is kept.
+static const char *cunit__failed_path(void) {
+	if (!STR_ISEMPTY(cunit__registry.failed_file)) { return cunit__registry.failed_file; }
+	return cunit__registry.rerun_mode != CUNIT_RERUN_ALL ? CUNIT_FAILED_FILE_DEFAULT : NULL;
+}
+
+void cunit__rerun_select(void) {
+	const char *path = cunit__failed_path();
+	if (!path) { return; }
+	if (!cunit__registry.failed.count) { cunit__db_load(&cunit__registry.failed, path); }
+
+	bool any = false;
+	for (cunit_suite_t *suite = cunit__registry.suites; suite; suite = suite->next) {
+		for (cunit_test_t *test = suite->tests; test; test = test->next) {
+			test->failed_last = cunit__db_find(&cunit__registry.failed, suite->name, test->name) != NULL;
+			any               = any || (test->matched && test->failed_last);
+		}
+	}
+
+	// With nothing to rerun, every matched test runs, so that a clean state
+	// file does not turn the next run into an empty one.
+	if (cunit__registry.rerun_mode != CUNIT_RERUN_LAST_FAILED || !any) { return; }
+	for (cunit_suite_t *suite = cunit__registry.suites; suite; suite = suite->next) {
+		for (cunit_test_t *test = suite->tests; test; test = test->next) { test->matched = test->matched && test->failed_last; }
+	}
+}
+
+// Moves the tests of a suite that failed last to its front, keeping the order
+// within both groups. Returns whether any test moved there.
+static bool cunit__rerun_order_tests(cunit_suite_t *suite) {
+	cunit_test_t *failed = NULL, **failed_tail = &failed, *rest = NULL, **rest_tail = &rest;
+	for (cunit_test_t *test = suite->tests, *next; test; test = next) {
+		next = test->next;
+		if (test->selected && test->failed_last) {
+			*failed_tail = test;
+			failed_tail  = &test->next;
+		} else {
+			*rest_tail = test;
+			rest_tail  = &test->next;
+		}
+	}
+	const bool moved = failed != NULL;
+	*rest_tail       = NULL;
+	*failed_tail     = rest;
+	suite->tests     = failed;
+	for (cunit_test_t *test = suite->tests; test; test = test->next) { suite->last_test = test; }
+	return moved;
+}
+
+void cunit__rerun_order(void) {
+	if (cunit__registry.rerun_mode != CUNIT_RERUN_FAILED_FIRST) { return; }
+
+	// Suites holding such tests also move ahead of the others, so that they are
+	// run and reported first whether the run is serial or not.
+	cunit_suite_t *failed = NULL, **failed_tail = &failed, *rest = NULL, **rest_tail = &rest;
+	for (cunit_suite_t *suite = cunit__registry.suites, *next; suite; suite = next) {
+		next = suite->next;
+		if (cunit__rerun_order_tests(suite)) {
+			*failed_tail = suite;
+			failed_tail  = &suite->next;
+		} else {
+			*rest_tail = suite;
+			rest_tail  = &suite->next;
+		}
+	}
+	*rest_tail             = NULL;
+	*failed_tail           = rest;
+	cunit__registry.suites = failed;
+	for (cunit_suite_t *suite = cunit__registry.suites; suite; suite = suite->next) { cunit__registry.last_suite = suite; }
+}
+
+void cunit__rerun_save(const cunit_suite_t *only) {
+	const char *path = cunit__failed_path();
+	if (!path) { return; }
+
+	// Tests outside this run keep their state; the others are listed if they failed.
+	cunit_db_t failed = {NULL, 0, 0, NULL, 0};
+	for (size_t i = 0; i < cunit__registry.failed.count; i++) {
+		const cunit_db_entry_t *entry = &cunit__registry.failed.entries[i];
+		const cunit_suite_t    *suite = cunit__index_find_suite(entry->suite);
+		const cunit_test_t     *test  = cunit__index_find_test(suite, entry->test);
+		if (!test || !test->selected || (only && suite != only)) { cunit__db_put(&failed, entry->suite, entry->test); }
+	}
+	for (const cunit_suite_t *suite = only ? only : cunit__registry.suites; suite; suite = only ? NULL : suite->next) {
+		for (const cunit_test_t *test = suite->tests; test; test = test->next) {
+			if (test->selected && test->result.status != CUNIT_STATUS_PASSED) { cunit__db_put(&failed, suite->name, test->name); }
+		}
+	}
+	cunit__db_free(&cunit__registry.failed);
+	cunit__registry.failed = failed;
+
+	if (!cunit__db_save(&cunit__registry.failed, path)) { fprintf(stderr, "cunit: cannot write failed test file '%s'\n", path); }
+}
@@ -0,0 +1,294 @@
+#include "registry.h"
+
+// How a set stores its values.
+typedef enum {
+	CUNIT_SET_INTEGER,  // Hashed by value: integers, characters and booleans.
+	CUNIT_SET_POINTER,  // Hashed by address.
+	CUNIT_SET_STRING,   // Hashed by contents.
+	CUNIT_SET_FLOAT,    // Sorted.
+	CUNIT_SET_NONE,
+} cunit_set_kind_t;
+
+struct cunit_set {
+	enum cunit_type  type;      // The type of the elements the set was built from.
+	cunit_set_kind_t kind;      // How the values are stored.
+	size_t           size;      // The number of distinct values.
+	uint64_t        *keys;      // Open-addressing slots of integers and pointers; 0 is an empty slot.
+	const char     **strings;   // Open-addressing slots of strings; NULL is an empty slot.
+	size_t           nslots;    // The number of slots (a power of two).
+	bool             has_zero;  // Whether 0, a NULL pointer or a NULL string is in the set.
+	char            *text;      // The copied strings, one after another.
+	double          *sorted;    // The floating-point numbers, ascending, without NaN.
+	bool             has_nan;   // Whether NaN is in the set.
+};
+
+static cunit_set_kind_t cunit__set_kind(enum cunit_type type) {
+	switch (type) {
+		case CUnitType_Invalid: return CUNIT_SET_NONE;
+		case CUnitType_Pointer: return CUNIT_SET_POINTER;
+		case CUnitType_String: return CUNIT_SET_STRING;
+		case CUnitType_Float32:
+		case CUnitType_Float64: return CUNIT_SET_FLOAT;
+		default: return CUNIT_SET_INTEGER;
+	}
+}
+
+// Returns the size of an element of an array of values of a type.
+static size_t cunit__set_width(enum cunit_type type) {
+	switch (type) {
+		case CUnitType_Bool: return sizeof(bool);
+		case CUnitType_Float32: return sizeof(float);
+		case CUnitType_Float64: return sizeof(double);
+		case CUnitType_String: return sizeof(char *);
+		case CUnitType_Pointer: return sizeof(void *);
+		case CUnitType_Int: return sizeof(int);
+		case CUnitType_Uint: return sizeof(unsigned);
+		case CUnitType_Int16:
+		case CUnitType_Uint16: return 2;
+		case CUnitType_Int32:
+		case CUnitType_Uint32: return 4;
+		case CUnitType_Int64:
+		case CUnitType_Uint64: return 8;
+		default: return 1;
+	}
+}
+
+// Reads element `i` of an array of values of a type.
+static cunit_value_t cunit__set_element(enum cunit_type type, const void *array, size_t i) {
+	cunit_value_t value;
+	const size_t  width = cunit__set_width(type);
+	memset(&value, 0, sizeof(value));
+	memcpy(&value.d, (const unsigned char *)array + i * width, width);
+	value.type = type;
+	return value;
+}
+
+// Returns whether the values of a type are signed integers or characters.
+static bool cunit__set_signed(enum cunit_type type) {
+	switch (type) {
+		case CUnitType_Char:
+		case CUnitType_Int:
+		case CUnitType_Int8:
+		case CUnitType_Int16:
+		case CUnitType_Int32:
+		case CUnitType_Int64: return true;
+		default: return false;
+	}
+}
+
+// Returns the key of an integer, character, boolean or pointer: integers of any width and
+// signedness compare by value. A negative value shares its key with one above INT64_MAX,
+// so a key above INT64_MAX is only looked up among values of the same signedness.
+static uint64_t cunit__set_key(const cunit_value_t *value) {
+	switch (value->type) {
+		case CUnitType_Bool: return value->d.b;
+		case CUnitType_Char: return (uint64_t)(int64_t)value->d.c;
+		case CUnitType_Pointer: return (uint64_t)(uintptr_t)value->d.ptr;
+		case CUnitType_Int: return (uint64_t)(int64_t)value->d.i;
+		case CUnitType_Int8: return (uint64_t)(int64_t)value->d.i8;
+		case CUnitType_Int16: return (uint64_t)(int64_t)value->d.i16;
+		case CUnitType_Int32: return (uint64_t)(int64_t)value->d.i32;
+		case CUnitType_Int64: return (uint64_t)value->d.i64;
+		case CUnitType_Uint: return value->d.u;
+		case CUnitType_Uint8: return value->d.u8;
+		case CUnitType_Uint16: return value->d.u16;
+		case CUnitType_Uint32: return value->d.u32;
+		default: return value->d.u64;
+	}
+}
+
+static inline size_t cunit__set_hash_key(uint64_t key) {
+	key ^= key >> 33;
+	key *= 0xff51afd7ed558ccdull;
+	key ^= key >> 33;
+	return (size_t)key;
+}
+
+// Hashes a string (FNV-1a).
+static inline size_t cunit__set_hash_string(const char *s) {
+	uint64_t hash = 14695981039346656037ull;
+	for (; *s; s++) { hash = (hash ^ (uint8_t)*s) * 1099511628211ull; }
+	return (size_t)hash;
+}
+
+// Returns the slot holding a key or string, or the empty slot where it belongs.
+static size_t cunit__set_slot_key(const cunit_set_t *set, uint64_t key) {
+	const size_t mask = set->nslots - 1;
+	size_t       slot = cunit__set_hash_key(key) & mask;
+	while (set->keys[slot] && set->keys[slot] != key) { slot = (slot + 1) & mask; }
+	return slot;
+}
+static size_t cunit__set_slot_string(const cunit_set_t *set, const char *s) {
+	const size_t mask = set->nslots - 1;
+	size_t       slot = cunit__set_hash_string(s) & mask;
+	while (set->strings[slot] && strcmp(set->strings[slot], s) != 0) { slot = (slot + 1) & mask; }
+	return slot;
+}
+
+static int cunit__set_compare(const void *l, const void *r) {
+	const double a = *(const double *)l, b = *(const double *)r;
+	return (a > b) - (a < b);
+}
+
+// Hashes the integers, characters, booleans or pointers of an array.
+static bool cunit__set_hash_keys(cunit_set_t *set, const void *array, size_t count) {
+	set->keys = (uint64_t *)calloc(set->nslots, sizeof(uint64_t));
+	if (!set->keys) { return false; }
+	for (size_t i = 0; i < count; i++) {
+		const cunit_value_t value = cunit__set_element(set->type, array, i);
+		const uint64_t      key   = cunit__set_key(&value);
+		if (!key) {
+			set->size += !set->has_zero;
+			set->has_zero = true;
+			continue;
+		}
+		const size_t slot = cunit__set_slot_key(set, key);
+		if (!set->keys[slot]) {
+			set->keys[slot] = key;
+			set->size++;
+		}
+	}
+	return true;
+}
+
+// Copies the strings of an array into one block and hashes them.
+static bool cunit__set_hash_strings(cunit_set_t *set, const char *const *array, size_t count) {
+	size_t length = 0;
+	for (size_t i = 0; i < count; i++) {
+		if (array[i]) { length += strlen(array[i]) + 1; }
+	}
+	set->strings = (const char **)calloc(set->nslots, sizeof(char *));
+	set->text    = (char *)malloc(length ? length : 1);
+	if (!set->strings || !set->text) { return false; }
+
+	char *next = set->text;
+	for (size_t i = 0; i < count; i++) {
+		if (!array[i]) {
+			set->size += !set->has_zero;
+			set->has_zero = true;
+			continue;
+		}
+		const size_t slot = cunit__set_slot_string(set, array[i]);
+		if (set->strings[slot]) { continue; }
+		const size_t size = strlen(array[i]) + 1;
+		memcpy(next, array[i], size);
+		set->strings[slot] = next;
+		next += size;
+		set->size++;
+	}
+	return true;
+}
+
+// Sorts the floating-point numbers of an array, without duplicates or NaN.
+static bool cunit__set_sort(cunit_set_t *set, const void *array, size_t count) {
+	set->sorted = (double *)malloc((count ? count : 1) * sizeof(double));
+	if (!set->sorted) { return false; }
+	size_t n = 0;
+	for (size_t i = 0; i < count; i++) {
+		const cunit_value_t value = cunit__set_element(set->type, array, i);
+		const double        x     = set->type == CUnitType_Float32 ? (double)value.d.f32 : value.d.f64;
+		if (x != x) {
+			set->has_nan = true;
+		} else {
+			set->sorted[n++] = x;
+		}
+	}
+	qsort(set->sorted, n, sizeof(double), cunit__set_compare);
+	for (size_t i = 0; i < n; i++) {
+		if (set->size == 0 || set->sorted[set->size - 1] != set->sorted[i]) { set->sorted[set->size++] = set->sorted[i]; }
+	}
+	set->size += set->has_nan;
+	return true;
+}
+
+cunit_set_t *cunit_set_new(enum cunit_type type, const void *array, size_t count) {
+	const cunit_set_kind_t kind = cunit__set_kind(type);
+	if (kind == CUNIT_SET_NONE || (!array && count)) { return NULL; }
+
+	cunit_set_t *set = (cunit_set_t *)calloc(1, sizeof(cunit_set_t));
+	if (!set) { return NULL; }
+	set->type = type;
+	set->kind = kind;
+
+	// Keep the load factor at or below one half.
+	set->nslots = 16;
+	while (set->nslots < count * 2) { set->nslots *= 2; }
+
+	bool built;
+	switch (kind) {
+		case CUNIT_SET_STRING: built = cunit__set_hash_strings(set, (const char *const *)array, count); break;
+		case CUNIT_SET_FLOAT: built = cunit__set_sort(set, array, count); break;
+		default: built = cunit__set_hash_keys(set, array, count); break;
+	}
+	if (!built) {
+		cunit_set_free(set);
+		return NULL;
+	}
+	return set;
+}
+
+void cunit_set_free(cunit_set_t *set) {
+	if (!set) { return; }
+	free(set->keys);
+	free((void *)set->strings);
+	free(set->text);
+	free(set->sorted);
+	free(set);
+}
+
+size_t cunit_set_size(const cunit_set_t *set) { return set ? set->size : 0; }
+
+// Whether a sorted set holds a number within FLT_EPSILON or DBL_EPSILON of `x`, compared in
+// the precision of the set as check_in_array() compares. Only numbers within twice that of
+// `x` can be, so the search starts there.
+static bool cunit__set_near(const cunit_set_t *set, double x) {
+	if (x != x) { return set->has_nan; }
+	const size_t count   = set->size - set->has_nan;
+	const double epsilon = set->type == CUnitType_Float32 ? FLT_EPSILON : DBL_EPSILON;
+	size_t       lo = 0, hi = count;
+	while (lo < hi) {
+		const size_t mid = lo + (hi - lo) / 2;
+		if (set->sorted[mid] < x - 2 * epsilon) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	for (size_t i = lo; i < count && set->sorted[i] <= x + 2 * epsilon; i++) {
+		if (set->type == CUnitType_Float32) {
+			const float a = (float)set->sorted[i], b = (float)x;
+			if (a == b || fabsf(a - b) <= FLT_EPSILON) { return true; }
+		} else if (set->sorted[i] == x || fabs(set->sorted[i] - x) <= DBL_EPSILON) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool cunit_set_contains(const cunit_set_t *set, cunit_value_t value) {
+	if (!set || cunit__set_kind(value.type) != set->kind) { return false; }
+	switch (set->kind) {
+		case CUNIT_SET_STRING:
+			if (!value.d.str) { return set->has_zero; }
+			return set->strings[cunit__set_slot_string(set, value.d.str)] != NULL;
+		case CUNIT_SET_FLOAT: return cunit__set_near(set, value.type == CUnitType_Float32 ? (double)value.d.f32 : value.d.f64);
+		default: {
+			const uint64_t key = cunit__set_key(&value);
+			if (!key) { return set->has_zero; }
+			if (key > INT64_MAX && cunit__set_signed(value.type) != cunit__set_signed(set->type)) { return false; }
+			return set->keys[cunit__set_slot_key(set, key)] != 0;
+		}
+	}
+}
+
+size_t cunit__set_missing(const cunit_set_t *set, const void *array, size_t count, size_t *first) {
+	size_t missing = 0;
+	*first         = count;
+	for (size_t i = 0; i < count; i++) {
+		if (cunit_set_contains(set, cunit__set_element(set->type, array, i))) { continue; }
+		if (!missing++) { *first = i; }
+	}
+	return missing;
+}
+
+cunit_value_t cunit__set_value(const cunit_set_t *set, const void *array, size_t i) { return cunit__set_element(set->type, array, i); }
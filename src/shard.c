@@ -0,0 +1,90 @@
+#include "registry.h"
+
+// A test and its expected cost, for balancing shards.
+typedef struct {
+	cunit_test_t *test;   // The test.
+	double        cost;   // The expected duration in seconds.
+	size_t        order;  // The registration order, used to break ties.
+} cunit_shard_item_t;
+
+// Orders items by descending cost, then by registration order.
+static int cunit__shard_compare(const void *a, const void *b) {
+	const cunit_shard_item_t *l = (const cunit_shard_item_t *)a;
+	const cunit_shard_item_t *r = (const cunit_shard_item_t *)b;
+	if (l->cost != r->cost) { return l->cost > r->cost ? -1 : 1; }
+	return (l->order > r->order) - (l->order < r->order);
+}
+
+// Assigns tests to shards greedily, longest first, each to the least loaded
+// shard. Every shard computes the same assignment from the same timing file,
+// which is why a sharded run does not update it (see cunit__timing_save()).
+static bool cunit__shard_balance(int index, int count) {
+	const size_t        total = (size_t)cunit__registry.total_tests;
+	cunit_shard_item_t *items = (cunit_shard_item_t *)malloc((total ? total : 1) * sizeof(cunit_shard_item_t));
+	double             *loads = (double *)calloc((size_t)count, sizeof(double));
+	if (!items || !loads) {
+		free(items);
+		free(loads);
+		return false;
+	}
+
+	size_t n = 0, known = 0;
+	double sum = 0;
+	for (cunit_suite_t *suite = cunit__registry.suites; suite; suite = suite->next) {
+		for (cunit_test_t *test = suite->tests; test && n < total; test = test->next) {
+			// Only the tests that pass the filter are spread over the shards.
+			test->selected = false;
+			if (!test->matched) { continue; }
+			items[n].test  = test;
+			items[n].cost  = cunit__timing_get(suite, test);
+			items[n].order = n;
+			if (items[n].cost >= 0) {
+				sum += items[n].cost;
+				known++;
+			}
+			n++;
+		}
+	}
+
+	// Tests without history count as an average test.
+	const double fallback = known ? sum / (double)known : 1.0;
+	for (size_t i = 0; i < n; i++) {
+		if (items[i].cost < 0) { items[i].cost = fallback; }
+	}
+	qsort(items, n, sizeof(cunit_shard_item_t), cunit__shard_compare);
+
+	for (size_t i = 0; i < n; i++) {
+		int lightest = 0;
+		for (int s = 1; s < count; s++) {
+			if (loads[s] < loads[lightest]) { lightest = s; }
+		}
+		loads[lightest] += items[i].cost;
+		items[i].test->selected = lightest == index;
+	}
+
+	free(loads);
+	free(items);
+	return true;
+}
+
+void cunit__shard_select(void) {
+	const int  index    = cunit__registry.shard_index;
+	const int  count    = cunit__registry.shard_count;
+	const bool sharding = count > 1 && index >= 0 && index < count;
+
+	bool balanced = false;
+	if (sharding && cunit__registry.timings.count) { balanced = cunit__shard_balance(index, count); }
+
+	size_t n = 0;
+	cunit__registry.total_selected = 0;
+	for (cunit_suite_t *suite = cunit__registry.suites; suite; suite = suite->next) {
+		suite->selected_count = 0;
+		for (cunit_test_t *test = suite->tests; test; test = test->next) {
+			// Without history, deal the matched tests round-robin in registration order.
+			if (!balanced) { test->selected = test->matched && (!sharding || (int)(n % (size_t)count) == index); }
+			if (test->matched) { n++; }
+			if (test->selected) { suite->selected_count++; }
+		}
+		cunit__registry.total_selected += suite->selected_count;
+	}
+}
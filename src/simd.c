@@ -0,0 +1,367 @@
+#include "simd.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__)) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CUNIT_SIMD_SSE2 1
+#include <emmintrin.h>
+// AVX2 is compiled for the functions that use it alone, and used if the CPU has it.
+#if defined(__GNUC__) || defined(__clang__)
+#define CUNIT_SIMD_AVX2 1
+#include <immintrin.h>
+#endif
+#endif
+
+// Forces a loop written once for all element sizes into each caller that passes a constant size.
+#if defined(__GNUC__) || defined(__clang__)
+#define CUNIT_SIMD_INLINE static inline __attribute__((always_inline))
+#elif defined(_MSC_VER)
+#define CUNIT_SIMD_INLINE static __forceinline
+#else
+#define CUNIT_SIMD_INLINE static inline
+#endif
+
+// Returns the index of the lowest set bit of a non-zero mask.
+static inline unsigned cunit__ctz(uint32_t mask) {
+#if defined(__GNUC__) || defined(__clang__)
+	return (unsigned)__builtin_ctz(mask);
+#elif defined(_MSC_VER)
+	unsigned long index;
+	_BitScanForward(&index, mask);
+	return (unsigned)index;
+#else
+	unsigned index = 0;
+	while (!(mask & 1)) {
+		mask >>= 1;
+		index++;
+	}
+	return index;
+#endif
+}
+
+// Returns the index of the lowest set bit of a non-zero 64-bit mask.
+static inline unsigned cunit__ctz64(uint64_t mask) {
+	const uint32_t low = (uint32_t)mask;
+	return low ? cunit__ctz(low) : 32 + cunit__ctz((uint32_t)(mask >> 32));
+}
+
+// Finds the first difference from `at` on, a word at a time.
+static size_t cunit__mismatch_scalar(const unsigned char *l, const unsigned char *r, size_t at, size_t size) {
+	for (; at + sizeof(uint64_t) <= size; at += sizeof(uint64_t)) {
+		uint64_t a, b;
+		memcpy(&a, l + at, sizeof(a));
+		memcpy(&b, r + at, sizeof(b));
+		if (a != b) { break; }
+	}
+	while (at < size && l[at] == r[at]) { at++; }
+	return at;
+}
+
+#ifdef CUNIT_SIMD_SSE2
+// Compares 64 bytes per iteration, and the block that differs 16 bytes at a time.
+static size_t cunit__mismatch_sse2(const unsigned char *l, const unsigned char *r, size_t size) {
+	size_t at = 0;
+	for (; at + 64 <= size; at += 64) {
+		const __m128i a = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(l + at)), _mm_loadu_si128((const __m128i *)(r + at)));
+		const __m128i b = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(l + at + 16)), _mm_loadu_si128((const __m128i *)(r + at + 16)));
+		const __m128i c = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(l + at + 32)), _mm_loadu_si128((const __m128i *)(r + at + 32)));
+		const __m128i d = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(l + at + 48)), _mm_loadu_si128((const __m128i *)(r + at + 48)));
+		if (_mm_movemask_epi8(_mm_and_si128(_mm_and_si128(a, b), _mm_and_si128(c, d))) != 0xFFFF) { break; }
+	}
+	for (; at + 16 <= size; at += 16) {
+		const __m128i  eq   = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(l + at)), _mm_loadu_si128((const __m128i *)(r + at)));
+		const uint32_t diff = (uint32_t)_mm_movemask_epi8(eq) ^ 0xFFFFu;
+		if (diff) { return at + cunit__ctz(diff); }
+	}
+	return cunit__mismatch_scalar(l, r, at, size);
+}
+#endif
+
+#ifdef CUNIT_SIMD_AVX2
+// Compares 128 bytes per iteration, and the block that differs 32 bytes at a time.
+__attribute__((target("avx2"))) static size_t cunit__mismatch_avx2(const unsigned char *l, const unsigned char *r, size_t size) {
+	size_t at = 0;
+	for (; at + 128 <= size; at += 128) {
+		const __m256i a = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(l + at)), _mm256_loadu_si256((const __m256i *)(r + at)));
+		const __m256i b = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(l + at + 32)), _mm256_loadu_si256((const __m256i *)(r + at + 32)));
+		const __m256i c = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(l + at + 64)), _mm256_loadu_si256((const __m256i *)(r + at + 64)));
+		const __m256i d = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(l + at + 96)), _mm256_loadu_si256((const __m256i *)(r + at + 96)));
+		if ((uint32_t)_mm256_movemask_epi8(_mm256_and_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, d))) != 0xFFFFFFFFu) { break; }
+	}
+	for (; at + 32 <= size; at += 32) {
+		const __m256i  eq   = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(l + at)), _mm256_loadu_si256((const __m256i *)(r + at)));
+		const uint32_t diff = (uint32_t)_mm256_movemask_epi8(eq) ^ 0xFFFFFFFFu;
+		if (diff) { return at + cunit__ctz(diff); }
+	}
+	return cunit__mismatch_scalar(l, r, at, size);
+}
+#endif
+
+// Finds the first element from `at` on that equals `value`, one at a time.
+CUNIT_SIMD_INLINE size_t cunit__find_scalar(const unsigned char *array, size_t at, size_t count, size_t size, const void *value) {
+	uint64_t wanted = 0, element = 0;
+	memcpy(&wanted, value, size);
+	for (; at < count; at++) {
+		memcpy(&element, array + at * size, size);
+		if (element == wanted) { break; }
+	}
+	return at;
+}
+
+#ifdef CUNIT_SIMD_SSE2
+// Compares the elements of a vector of `size` bytes each, setting all their bytes where they are equal.
+CUNIT_SIMD_INLINE __m128i cunit__equal_sse2(__m128i a, __m128i b, size_t size) {
+	switch (size) {
+		case 1: return _mm_cmpeq_epi8(a, b);
+		case 2: return _mm_cmpeq_epi16(a, b);
+		case 4: return _mm_cmpeq_epi32(a, b);
+		default: {
+			// SSE2 has no 64-bit comparison: both 32-bit halves must be equal.
+			const __m128i eq = _mm_cmpeq_epi32(a, b);
+			return _mm_and_si128(eq, _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1)));
+		}
+	}
+}
+
+// Scans 64 bytes per iteration, then 16 bytes at a time. Elements divide the blocks evenly,
+// so the lowest byte of a match is the first byte of the element that matched.
+CUNIT_SIMD_INLINE size_t cunit__find_sse2(const unsigned char *array, size_t count, size_t size, const void *value) {
+	uint64_t wanted = 0;
+	memcpy(&wanted, value, size);
+	const __m128i v     = size == 1 ? _mm_set1_epi8((char)wanted)
+						  : size == 2 ? _mm_set1_epi16((short)wanted)
+						  : size == 4 ? _mm_set1_epi32((int)wanted)
+									  : _mm_set_epi32((int)(wanted >> 32), (int)wanted, (int)(wanted >> 32), (int)wanted);
+	const size_t  bytes = count * size;
+	size_t        at    = 0;
+	for (; at + 64 <= bytes; at += 64) {
+		const __m128i a = cunit__equal_sse2(_mm_loadu_si128((const __m128i *)(array + at)), v, size);
+		const __m128i b = cunit__equal_sse2(_mm_loadu_si128((const __m128i *)(array + at + 16)), v, size);
+		const __m128i c = cunit__equal_sse2(_mm_loadu_si128((const __m128i *)(array + at + 32)), v, size);
+		const __m128i d = cunit__equal_sse2(_mm_loadu_si128((const __m128i *)(array + at + 48)), v, size);
+		if (_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d)))) {
+			const uint64_t found = (uint64_t)(uint32_t)_mm_movemask_epi8(a) | (uint64_t)(uint32_t)_mm_movemask_epi8(b) << 16 |
+								   (uint64_t)(uint32_t)_mm_movemask_epi8(c) << 32 | (uint64_t)(uint32_t)_mm_movemask_epi8(d) << 48;
+			return (at + cunit__ctz64(found)) / size;
+		}
+	}
+	for (; at + 16 <= bytes; at += 16) {
+		const uint32_t found = (uint32_t)_mm_movemask_epi8(cunit__equal_sse2(_mm_loadu_si128((const __m128i *)(array + at)), v, size));
+		if (found) { return (at + cunit__ctz(found)) / size; }
+	}
+	return cunit__find_scalar(array, at / size, count, size, value);
+}
+
+static size_t cunit__find_sse2_any(const unsigned char *array, size_t count, size_t size, const void *value) {
+	switch (size) {
+		case 1: return cunit__find_sse2(array, count, 1, value);
+		case 2: return cunit__find_sse2(array, count, 2, value);
+		case 4: return cunit__find_sse2(array, count, 4, value);
+		default: return cunit__find_sse2(array, count, 8, value);
+	}
+}
+#endif
+
+#ifdef CUNIT_SIMD_AVX2
+__attribute__((target("avx2"))) CUNIT_SIMD_INLINE __m256i cunit__equal_avx2(__m256i a, __m256i b, size_t size) {
+	switch (size) {
+		case 1: return _mm256_cmpeq_epi8(a, b);
+		case 2: return _mm256_cmpeq_epi16(a, b);
+		case 4: return _mm256_cmpeq_epi32(a, b);
+		default: return _mm256_cmpeq_epi64(a, b);
+	}
+}
+
+// Scans 128 bytes per iteration, then 32 bytes at a time, as cunit__find_sse2() does.
+__attribute__((target("avx2"))) CUNIT_SIMD_INLINE size_t cunit__find_avx2(const unsigned char *array, size_t count, size_t size, const void *value) {
+	uint64_t wanted = 0;
+	memcpy(&wanted, value, size);
+	const __m256i v     = size == 1 ? _mm256_set1_epi8((char)wanted)
+						  : size == 2 ? _mm256_set1_epi16((short)wanted)
+						  : size == 4 ? _mm256_set1_epi32((int)wanted)
+									  : _mm256_set1_epi64x((long long)wanted);
+	const size_t  bytes = count * size;
+	size_t        at    = 0;
+	for (; at + 128 <= bytes; at += 128) {
+		const __m256i a = cunit__equal_avx2(_mm256_loadu_si256((const __m256i *)(array + at)), v, size);
+		const __m256i b = cunit__equal_avx2(_mm256_loadu_si256((const __m256i *)(array + at + 32)), v, size);
+		const __m256i c = cunit__equal_avx2(_mm256_loadu_si256((const __m256i *)(array + at + 64)), v, size);
+		const __m256i d = cunit__equal_avx2(_mm256_loadu_si256((const __m256i *)(array + at + 96)), v, size);
+		if (!_mm256_testz_si256(_mm256_or_si256(_mm256_or_si256(a, b), _mm256_or_si256(c, d)), _mm256_set1_epi8(-1))) {
+			const uint64_t low  = (uint64_t)(uint32_t)_mm256_movemask_epi8(a) | (uint64_t)(uint32_t)_mm256_movemask_epi8(b) << 32;
+			const uint64_t high = (uint64_t)(uint32_t)_mm256_movemask_epi8(c) | (uint64_t)(uint32_t)_mm256_movemask_epi8(d) << 32;
+			return (at + (low ? cunit__ctz64(low) : 64 + cunit__ctz64(high))) / size;
+		}
+	}
+	for (; at + 32 <= bytes; at += 32) {
+		const uint32_t found = (uint32_t)_mm256_movemask_epi8(cunit__equal_avx2(_mm256_loadu_si256((const __m256i *)(array + at)), v, size));
+		if (found) { return (at + cunit__ctz(found)) / size; }
+	}
+	return cunit__find_scalar(array, at / size, count, size, value);
+}
+
+__attribute__((target("avx2"))) static size_t cunit__find_avx2_any(const unsigned char *array, size_t count, size_t size, const void *value) {
+	switch (size) {
+		case 1: return cunit__find_avx2(array, count, 1, value);
+		case 2: return cunit__find_avx2(array, count, 2, value);
+		case 4: return cunit__find_avx2(array, count, 4, value);
+		default: return cunit__find_avx2(array, count, 8, value);
+	}
+}
+#endif
+
+size_t cunit__find(const void *array, size_t count, size_t size, const void *value) {
+	const unsigned char *a = (const unsigned char *)array;
+#ifdef CUNIT_SIMD_AVX2
+	if (count * size >= 32 && __builtin_cpu_supports("avx2")) { return cunit__find_avx2_any(a, count, size, value); }
+#endif
+#ifdef CUNIT_SIMD_SSE2
+	return cunit__find_sse2_any(a, count, size, value);
+#else
+	return cunit__find_scalar(a, 0, count, size, value);
+#endif
+}
+
+size_t cunit__mismatch(const void *l, const void *r, size_t size) {
+	const unsigned char *a = (const unsigned char *)l;
+	const unsigned char *b = (const unsigned char *)r;
+#ifdef CUNIT_SIMD_AVX2
+	if (size >= 32 && __builtin_cpu_supports("avx2")) { return cunit__mismatch_avx2(a, b, size); }
+#endif
+#ifdef CUNIT_SIMD_SSE2
+	return cunit__mismatch_sse2(a, b, size);
+#else
+	return cunit__mismatch_scalar(a, b, 0, size);
+#endif
+}
+
+// Whether two numbers are within a tolerance of each other, in the same arithmetic as the
+// vector loops below: a difference or a relative difference in the precision of the numbers.
+static inline bool cunit__float_near(float l, float r, cunit_tolerance_kind_t kind, float tolerance, uint32_t ulps) {
+	if (l == r) { return true; }
+	if (l != l || r != r) { return l != l && r != r; }
+	const float diff = fabsf(l - r);
+	switch (kind) {
+		case CUNIT_TOLERANCE_ULPS: return cunit__float_ulps(l, r) <= ulps;
+		case CUNIT_TOLERANCE_REL: return diff < INFINITY && diff <= tolerance * fmaxf(fabsf(l), fabsf(r));
+		default: return diff <= tolerance;
+	}
+}
+static inline bool cunit__double_near(double l, double r, cunit_tolerance_kind_t kind, double tolerance, uint64_t ulps) {
+	if (l == r) { return true; }
+	if (l != l || r != r) { return l != l && r != r; }
+	const double diff = fabs(l - r);
+	switch (kind) {
+		case CUNIT_TOLERANCE_ULPS: return cunit__double_ulps(l, r) <= ulps;
+		case CUNIT_TOLERANCE_REL: return diff < INFINITY && diff <= tolerance * fmax(fabs(l), fabs(r));
+		default: return diff <= tolerance;
+	}
+}
+
+static size_t cunit__float_far_scalar(const float *l, const float *r, size_t at, size_t count, cunit_tolerance_kind_t kind, float tolerance, uint32_t ulps) {
+	while (at < count && cunit__float_near(l[at], r[at], kind, tolerance, ulps)) { at++; }
+	return at;
+}
+static size_t cunit__double_far_scalar(const double *l, const double *r, size_t at, size_t count, cunit_tolerance_kind_t kind, double tolerance, uint64_t ulps) {
+	while (at < count && cunit__double_near(l[at], r[at], kind, tolerance, ulps)) { at++; }
+	return at;
+}
+
+#ifdef CUNIT_SIMD_AVX2
+// Compares 8 floats per iteration. Each lane is near if the two are equal or both NaN, or, when
+// neither is NaN, within the tolerance; ulps are counted on the ordered bits of cunit__float_order().
+__attribute__((target("avx2"))) static size_t cunit__float_far_avx2(const float *l, const float *r, size_t at, size_t count, cunit_tolerance_kind_t kind, float tolerance,
+																	uint32_t ulps) {
+	const __m256  magnitude = _mm256_castsi256_ps(_mm256_set1_epi32(INT32_MAX));
+	const __m256  limit     = _mm256_set1_ps(tolerance);
+	const __m256  infinity  = _mm256_set1_ps(INFINITY);
+	const __m256i bias      = _mm256_set1_epi32(INT32_MIN);
+	const __m256i max_ulps  = _mm256_set1_epi32((int32_t)(ulps ^ 0x80000000u));
+	for (; at + 8 <= count; at += 8) {
+		const __m256 a    = _mm256_loadu_ps(l + at);
+		const __m256 b    = _mm256_loadu_ps(r + at);
+		const __m256 nan  = _mm256_and_ps(_mm256_cmp_ps(a, a, _CMP_UNORD_Q), _mm256_cmp_ps(b, b, _CMP_UNORD_Q));
+		const __m256 diff = _mm256_and_ps(_mm256_sub_ps(a, b), magnitude);
+		__m256       near;
+		switch (kind) {
+			case CUNIT_TOLERANCE_ULPS: {
+				const __m256i x     = _mm256_castps_si256(a);
+				const __m256i y     = _mm256_castps_si256(b);
+				const __m256i ox    = _mm256_blendv_epi8(x, _mm256_sub_epi32(bias, x), _mm256_srai_epi32(x, 31));
+				const __m256i oy    = _mm256_blendv_epi8(y, _mm256_sub_epi32(bias, y), _mm256_srai_epi32(y, 31));
+				const __m256i apart = _mm256_blendv_epi8(_mm256_sub_epi32(oy, ox), _mm256_sub_epi32(ox, oy), _mm256_cmpgt_epi32(ox, oy));
+				const __m256i far   = _mm256_cmpgt_epi32(_mm256_xor_si256(apart, bias), max_ulps);
+				near = _mm256_andnot_ps(_mm256_castsi256_ps(far), _mm256_cmp_ps(a, b, _CMP_ORD_Q));
+			} break;
+			case CUNIT_TOLERANCE_REL: {
+				const __m256 larger = _mm256_max_ps(_mm256_and_ps(a, magnitude), _mm256_and_ps(b, magnitude));
+				near = _mm256_and_ps(_mm256_cmp_ps(diff, infinity, _CMP_LT_OQ), _mm256_cmp_ps(diff, _mm256_mul_ps(limit, larger), _CMP_LE_OQ));
+			} break;
+			default: near = _mm256_cmp_ps(diff, limit, _CMP_LE_OQ); break;
+		}
+		near = _mm256_or_ps(near, _mm256_or_ps(_mm256_cmp_ps(a, b, _CMP_EQ_OQ), nan));
+
+		const uint32_t far = (uint32_t)_mm256_movemask_ps(near) ^ 0xFFu;
+		if (far) { return at + cunit__ctz(far); }
+	}
+	return cunit__float_far_scalar(l, r, at, count, kind, tolerance, ulps);
+}
+
+// Compares 4 doubles per iteration, as cunit__float_far_avx2() does floats.
+__attribute__((target("avx2"))) static size_t cunit__double_far_avx2(const double *l, const double *r, size_t at, size_t count, cunit_tolerance_kind_t kind,
+																	 double tolerance, uint64_t ulps) {
+	const __m256d magnitude = _mm256_castsi256_pd(_mm256_set1_epi64x(INT64_MAX));
+	const __m256d limit     = _mm256_set1_pd(tolerance);
+	const __m256d infinity  = _mm256_set1_pd(INFINITY);
+	const __m256i zero      = _mm256_setzero_si256();
+	const __m256i bias      = _mm256_set1_epi64x(INT64_MIN);
+	const __m256i max_ulps  = _mm256_set1_epi64x((int64_t)(ulps ^ 0x8000000000000000ull));
+	for (; at + 4 <= count; at += 4) {
+		const __m256d a    = _mm256_loadu_pd(l + at);
+		const __m256d b    = _mm256_loadu_pd(r + at);
+		const __m256d nan  = _mm256_and_pd(_mm256_cmp_pd(a, a, _CMP_UNORD_Q), _mm256_cmp_pd(b, b, _CMP_UNORD_Q));
+		const __m256d diff = _mm256_and_pd(_mm256_sub_pd(a, b), magnitude);
+		__m256d       near;
+		switch (kind) {
+			case CUNIT_TOLERANCE_ULPS: {
+				const __m256i x     = _mm256_castpd_si256(a);
+				const __m256i y     = _mm256_castpd_si256(b);
+				const __m256i ox    = _mm256_blendv_epi8(x, _mm256_sub_epi64(bias, x), _mm256_cmpgt_epi64(zero, x));
+				const __m256i oy    = _mm256_blendv_epi8(y, _mm256_sub_epi64(bias, y), _mm256_cmpgt_epi64(zero, y));
+				const __m256i apart = _mm256_blendv_epi8(_mm256_sub_epi64(oy, ox), _mm256_sub_epi64(ox, oy), _mm256_cmpgt_epi64(ox, oy));
+				const __m256i far   = _mm256_cmpgt_epi64(_mm256_xor_si256(apart, bias), max_ulps);
+				near = _mm256_andnot_pd(_mm256_castsi256_pd(far), _mm256_cmp_pd(a, b, _CMP_ORD_Q));
+			} break;
+			case CUNIT_TOLERANCE_REL: {
+				const __m256d larger = _mm256_max_pd(_mm256_and_pd(a, magnitude), _mm256_and_pd(b, magnitude));
+				near = _mm256_and_pd(_mm256_cmp_pd(diff, infinity, _CMP_LT_OQ), _mm256_cmp_pd(diff, _mm256_mul_pd(limit, larger), _CMP_LE_OQ));
+			} break;
+			default: near = _mm256_cmp_pd(diff, limit, _CMP_LE_OQ); break;
+		}
+		near = _mm256_or_pd(near, _mm256_or_pd(_mm256_cmp_pd(a, b, _CMP_EQ_OQ), nan));
+
+		const uint32_t far = (uint32_t)_mm256_movemask_pd(near) ^ 0xFu;
+		if (far) { return at + cunit__ctz(far); }
+	}
+	return cunit__double_far_scalar(l, r, at, count, kind, tolerance, ulps);
+}
+#endif
+
+size_t cunit__float_far(const float *l, const float *r, size_t at, size_t count, cunit_tolerance_t tolerance) {
+	const float    limit = (float)tolerance.value;
+	const uint32_t ulps  = !(tolerance.value > 0) ? 0 : tolerance.value >= (double)UINT32_MAX ? UINT32_MAX : (uint32_t)tolerance.value;
+#ifdef CUNIT_SIMD_AVX2
+	if (count - at >= 8 && __builtin_cpu_supports("avx2")) { return cunit__float_far_avx2(l, r, at, count, tolerance.kind, limit, ulps); }
+#endif
+	return cunit__float_far_scalar(l, r, at, count, tolerance.kind, limit, ulps);
+}
+
+size_t cunit__double_far(const double *l, const double *r, size_t at, size_t count, cunit_tolerance_t tolerance) {
+	const uint64_t ulps = !(tolerance.value > 0) ? 0 : tolerance.value >= 18446744073709551616.0 ? UINT64_MAX : (uint64_t)tolerance.value;
+#ifdef CUNIT_SIMD_AVX2
+	if (count - at >= 4 && __builtin_cpu_supports("avx2")) { return cunit__double_far_avx2(l, r, at, count, tolerance.kind, tolerance.value, ulps); }
+#endif
+	return cunit__double_far_scalar(l, r, at, count, tolerance.kind, tolerance.value, ulps);
+}
@@ -0,0 +1,76 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 tayne3
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ * 2. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *    SOFTWARE.
+ */
+#ifndef CUNIT_SIMD_H
+#define CUNIT_SIMD_H
+
+#include "cunit/compare.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Returns the offset of the first byte at which two buffers of `size` bytes
+// differ, or `size` if they are equal. Compares with AVX2 or SSE2 where the
+// CPU has them, a word at a time elsewhere.
+size_t cunit__mismatch(const void *l, const void *r, size_t size);
+
+// Returns the index of the first of `count` elements of `size` bytes (1, 2, 4
+// or 8) that equals the one at `value`, or `count` if there is none. Compares
+// with AVX2 or SSE2 where the CPU has them, an element at a time elsewhere.
+size_t cunit__find(const void *array, size_t count, size_t size, const void *value);
+
+// The bits of a floating-point number as a signed integer ordered as the numbers
+// are, with consecutive numbers one apart and -0 the same as +0.
+static inline int32_t cunit__float_order(float f) {
+	int32_t bits;
+	memcpy(&bits, &f, sizeof(bits));
+	return bits < 0 ? INT32_MIN - bits : bits;
+}
+static inline int64_t cunit__double_order(double f) {
+	int64_t bits;
+	memcpy(&bits, &f, sizeof(bits));
+	return bits < 0 ? INT64_MIN - bits : bits;
+}
+
+// Returns how many representable numbers apart two numbers that are not NaN are.
+static inline uint32_t cunit__float_ulps(float l, float r) {
+	const int32_t a = cunit__float_order(l), b = cunit__float_order(r);
+	return a > b ? (uint32_t)a - (uint32_t)b : (uint32_t)b - (uint32_t)a;
+}
+static inline uint64_t cunit__double_ulps(double l, double r) {
+	const int64_t a = cunit__double_order(l), b = cunit__double_order(r);
+	return a > b ? (uint64_t)a - (uint64_t)b : (uint64_t)b - (uint64_t)a;
+}
+
+// Returns the index of the first pair of elements from `at` on that are not
+// within `tolerance` of each other, or `count` if there is none. Compares with
+// AVX2 where the CPU has it, an element at a time elsewhere.
+size_t cunit__float_far(const float *l, const float *r, size_t at, size_t count, cunit_tolerance_t tolerance);
+size_t cunit__double_far(const double *l, const double *r, size_t at, size_t count, cunit_tolerance_t tolerance);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // CUNIT_SIMD_H
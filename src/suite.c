@@ -1,140 +1,398 @@
-#include <setjmp.h>
-
+#include "clock.h"
 #include "cunit.h"
 #include "init.h"
 #include "once.h"
+#include "pool.h"
+#include "registry.h"
+#include "thread.h"
 
-// Represents a single test case.
-struct cunit_test {
-	const char        *name;  // The name of the test.
-	cunit_test_func_t  func;  // A pointer to the test function.
-	struct cunit_test *next;  // A pointer to the next test in the suite.
-};
-
-// Represents a test suite, which is a collection of tests.
-struct cunit_suite {
-	const char           *name;          // The name of the test suite.
-	cunit_setup_func_t    setup;         // A pointer to the setup function for the suite.
-	cunit_teardown_func_t teardown;      // A pointer to the teardown function for the suite.
-	cunit_test_t         *tests;         // A pointer to the first test in the suite.
-	cunit_test_t         *last_test;     // A pointer to the last test in the suite.
-	struct cunit_suite   *next;          // A pointer to the next test suite.
-	int                   test_count;    // The number of tests in the suite.
-	int                   passed_count;  // The number of passed tests in the suite.
-	int                   failed_count;  // The number of failed tests in the suite.
-};
-
-// Represents the global registry for all test suites and test results.
-typedef struct {
-	cunit_suite_t     *suites;          // A pointer to the first test suite.
-	cunit_suite_t     *current_suite;   // A pointer to the current test suite being added to.
-	cunit_suite_t     *last_suite;      // A pointer to the last test suite in the list.
-	int                total_tests;     // The total number of tests across all suites.
-	int                total_passed;    // The total number of passed tests across all suites.
-	int                total_failed;    // The total number of failed tests across all suites.
-	cunit_error_mode_t error_mode;      // The error handling mode.
-	bool               is_initialized;  // A flag indicating whether the registry has been initialized.
-	bool               test_running;    // A flag indicating whether a test is currently running.
-	bool               test_failed;     // A flag indicating whether the current test has failed.
-	jmp_buf            test_jmp_buf;    // Jump buffer for early test exit in COLLECT mode.
-} cunit_registry_t;
-
-// Initializes a cunit_registry_t struct with default values.
-#define CUNIT_REGISTRY_INIT                         \
-	{                                               \
-		.suites         = NULL,                     \
-		.current_suite  = NULL,                     \
-		.last_suite     = NULL,                     \
-		.total_tests    = 0,                        \
-		.total_passed   = 0,                        \
-		.total_failed   = 0,                        \
-		.error_mode     = CUNIT_ERROR_MODE_COLLECT, \
-		.is_initialized = false,                    \
-		.test_running   = false,                    \
-		.test_failed    = false,                    \
+// The global instance of the test registry.
+cunit_registry_t cunit__registry = CUNIT_REGISTRY_INIT;
+
+// The state of the main thread, also used by threads that cunit did not start.
+static cunit_worker_t cunit__main_worker;
+
+// The state of the calling thread while it executes tests.
+static CUNIT_THREAD_LOCAL cunit_worker_t *cunit__worker = NULL;
+
+// Returns the state of the calling thread.
+static inline cunit_worker_t *cunit__current_worker(void) { return cunit__worker ? cunit__worker : &cunit__main_worker; }
+
+// Returns the time elapsed since the given wall-clock and CPU timestamps.
+static inline cunit_time_t cunit__time_since(uint64_t wall, uint64_t cpu) {
+	cunit_time_t time;
+	time.wall = (double)(cunit_clock_now() - wall) / 1e9;
+	time.cpu  = (double)(cunit_clock_cpu() - cpu) / 1e9;
+	return time;
+}
+
+// Adds the phases of `timing` to `sum`.
+static void cunit__timing_add(cunit_timing_t *sum, const cunit_timing_t *timing) {
+	sum->setup.wall += timing->setup.wall;
+	sum->setup.cpu += timing->setup.cpu;
+	sum->body.wall += timing->body.wall;
+	sum->body.cpu += timing->body.cpu;
+	sum->teardown.wall += timing->teardown.wall;
+	sum->teardown.cpu += timing->teardown.cpu;
+	sum->total.wall += timing->total.wall;
+	sum->total.cpu += timing->total.cpu;
+}
+
+// Runs the body of a test, or measures it if it is a benchmark.
+static inline void cunit__run_body(const cunit_suite_t *suite, cunit_test_t *test) {
+	if (test->bench) {
+		cunit_bench_stats_t *stats = &cunit__current_worker()->bench;
+		cunit__bench_measure(test->bench, stats);
+		cunit__baseline_check(suite, test, stats);
+	} else {
+		test->func();
 	}
+}
 
-// The global instance of the test registry.
-static cunit_registry_t cunit__registry = CUNIT_REGISTRY_INIT;
+// Hands the failures recorded off the main thread to the test, to be replayed when it is reported.
+static void cunit__keep_events(cunit_worker_t *worker, cunit_test_t *test) {
+	free(test->events);
+	test->events      = NULL;
+	test->events_size = 0;
+	if (worker->record && worker->events.size) {
+		test->events      = worker->events.data;
+		test->events_size = worker->events.size;
+		memset(&worker->events, 0, sizeof(cunit_buffer_t));
+	}
+}
 
-// Runs a single test case.
-static void cunit__run_test(cunit_suite_t *suite, cunit_test_t *test) {
-	cunit__registry.test_failed = false;
+// Records the result of a test that the watchdog interrupted. Its teardown is
+// skipped, since the state it would clean up is unknown.
+static void cunit__run_timeout(cunit_test_t *test) {
+	cunit_worker_t  *worker  = cunit__current_worker();
+	const double     elapsed = cunit__watchdog_trip(worker);
+	cunit_counters_t counters;
+	// The counts are left out, since the test may have stopped before the counters started.
+	cunit__counters_stop(&worker->perf, &counters);
+
+	memset(&test->result, 0, sizeof(cunit_result_t));
+	test->result.status = CUNIT_STATUS_TIMEOUT;
+	// Where the test stopped is unknown, so all of the time counts as body time.
+	test->result.timing.body.wall  = elapsed;
+	test->result.timing.total.wall = elapsed;
+	test->result.assertions        = __cunit_assertions;
+	cunit__alloc_end(&test->result.alloc);
+	cunit__keep_events(worker, test);
+	worker->failed++;
+}
 
-	if (suite->setup) { suite->setup(); }
+// Runs a single test case and records its result.
+void cunit__run_test(cunit_suite_t *suite, cunit_test_t *test) {
+#ifndef _WIN32
+	// Set up before the watchdog starts watching, which may jump back here at any time.
+	if (cunit__timeout_of(test) > 0) {
+		if (sigsetjmp(cunit__current_worker()->timeout_jmp_buf, 1) != 0) {
+			cunit__run_timeout(test);
+			return;
+		}
+	}
+#endif
+	cunit__current_worker()->suite   = suite;
+	cunit__current_worker()->test    = test;
+	cunit__current_worker()->started = cunit_clock_now();
+	if (!cunit__watchdog_arm(cunit__current_worker(), suite, test)) { return; }
+
+	cunit_timing_t timing;
+	memset(&timing, 0, sizeof(cunit_timing_t));
+	cunit__current_worker()->test_failed = false;
+	cunit_buffer_clear(&cunit__current_worker()->events);
+	cunit__alloc_begin();
+	__cunit_assertions = 0;
+
+	uint64_t wall = cunit_clock_now(), cpu = cunit_clock_cpu();
+	if (suite->setup) {
+		suite->setup();
+		timing.setup = cunit__time_since(wall, cpu);
+	}
+
+	// Saved in the worker, since locals modified here are indeterminate after longjmp.
+	memset(&cunit__current_worker()->bench, 0, sizeof(cunit_bench_stats_t));
+	// The counters start first and stop last, so that the body time does not include them.
+	cunit__counters_start(&cunit__current_worker()->perf);
+	cunit__current_worker()->wall = cunit_clock_now();
+	cunit__current_worker()->cpu  = cunit_clock_cpu();
 
 	// Use setjmp/longjmp for early exit in COLLECT mode
 	if (cunit__registry.error_mode == CUNIT_ERROR_MODE_COLLECT) {
-		if (setjmp(cunit__registry.test_jmp_buf) == 0) {
+		if (setjmp(cunit__current_worker()->test_jmp_buf) == 0) {
 			// First time through - run the test
-			test->func();
+			cunit__run_body(suite, test);
 		}
 		// If longjmp was called, we jump here and skip the rest of the test
 	} else {
 		// In FAIL_FAST mode, run normally (will exit on first failure)
-		test->func();
+		cunit__run_body(suite, test);
 	}
 
-	if (suite->teardown) { suite->teardown(); }
+	cunit_worker_t  *worker = cunit__current_worker();
+	cunit_counters_t counters;
+	timing.body = cunit__time_since(worker->wall, worker->cpu);
+	cunit__counters_stop(&worker->perf, &counters);
 
-	if (cunit__registry.test_failed) {
-		suite->failed_count++;
-		cunit__registry.total_failed++;
-		printf("[ \033[31mFAILED\033[0m ] %s\n", test->name);
+	if (suite->teardown) {
+		wall = cunit_clock_now();
+		cpu  = cunit_clock_cpu();
+		suite->teardown();
+		timing.teardown = cunit__time_since(wall, cpu);
+	}
+	cunit__watchdog_disarm(worker);
+
+	timing.total.wall = timing.setup.wall + timing.body.wall + timing.teardown.wall;
+	timing.total.cpu  = timing.setup.cpu + timing.body.cpu + timing.teardown.cpu;
+
+	memset(&test->result, 0, sizeof(cunit_result_t));
+	test->result.timing     = timing;
+	test->result.bench      = worker->bench;
+	test->result.counters   = counters;
+	test->result.assertions = __cunit_assertions;
+	cunit__alloc_end(&test->result.alloc);
+
+	cunit__keep_events(worker, test);
+
+	if (worker->test_failed || (!test->result.assertions && !test->bench && cunit__registry.zero_assertions == CUNIT_ZERO_ASSERTIONS_FAIL)) {
+		test->result.status = CUNIT_STATUS_FAILED;
+		worker->failed++;
 	} else {
-		suite->passed_count++;
-		cunit__registry.total_passed++;
-		printf("[ \033[32mPASSED\033[0m ] %s\n", test->name);
+		test->result.status = CUNIT_STATUS_PASSED;
+		worker->passed++;
 	}
 }
 
-// Marks the current test as failed.
-static inline void cunit__mark_failed(void) { cunit__registry.test_failed = true; }
+// Runs work items of the fork mode on the calling thread, without crash isolation.
+void cunit__run_unisolated(cunit_work_t *works, size_t count) {
+	cunit_worker_t *worker = cunit__current_worker();
+	const bool      record = worker->record;
+	const int       passed = worker->passed, failed = worker->failed;
+	worker->record         = true;
+	for (size_t i = 0; i < count; i++) { cunit__run_test(works[i].suite, works[i].test); }
+	worker->record = record;
+	worker->passed = passed;
+	worker->failed = failed;
+	cunit__registry.total_unisolated += (int)count;
+}
 
-// Prints the header for a test suite.
-static inline void cunit__print_header(const char *suite_name) { printf("\n\033[33mRunning test suite: %s\033[0m\n", suite_name); }
+// Accounts for a test that has already run and reports its result.
+static void cunit__report_test(cunit_suite_t *suite, cunit_test_t *test) {
+	cunit__timing_add(&suite->timing, &test->result.timing);
+	suite->assertions += test->result.assertions;
+	cunit__registry.total_assertions += test->result.assertions;
+	cunit__registry.total_wall += test->result.timing.total.wall;
+	if (test->result.status == CUNIT_STATUS_PASSED) {
+		suite->passed_count++;
+	} else {
+		suite->failed_count++;
+	}
+	cunit__report_test_end(suite, test);
+}
 
-// Prints the summary for a test suite.
-static void cunit__print_summary(cunit_suite_t *suite) {
-	printf("\033[33mSuite Summary: %d passed, %d failed, %d total\033[0m\n", suite->passed_count, suite->failed_count, suite->test_count);
+// Returns whether a test is to be warned about or failed for making no checks or assertions.
+bool cunit__zero_assertions(const cunit_test_report_t *test) {
+	if (test->assertions || test->bench || cunit__registry.zero_assertions == CUNIT_ZERO_ASSERTIONS_IGNORE) { return false; }
+	return test->status == CUNIT_STATUS_PASSED || test->status == CUNIT_STATUS_FAILED;
 }
 
-// Prints the final summary of all test results.
-static inline void cunit__print_final(void) {
-	printf("\n\033[33mFinal Summary: %d passed, %d failed, %d total\033[0m\n", cunit__registry.total_passed, cunit__registry.total_failed,
-		   cunit__registry.total_tests);
+// Marks the current test as failed.
+static inline void cunit__mark_failed(void) { cunit__current_worker()->test_failed = true; }
+
+// Reports the end of a run, along with the tests that took the longest wall-clock time.
+static void cunit__report_run(void) {
+	cunit_run_report_t run;
+	memset(&run, 0, sizeof(cunit_run_report_t));
+	run.passed     = cunit__registry.total_passed;
+	run.failed     = cunit__registry.total_failed;
+	run.total      = cunit__registry.total_selected;
+	run.assertions = cunit__registry.total_assertions;
+	run.duration   = cunit__registry.total_wall;
+	run.unisolated = cunit__registry.total_unisolated;
+
+	const int            limit  = cunit__registry.slowest;
+	cunit_test_report_t *ranked = limit > 0 && run.total > 0 ? (cunit_test_report_t *)calloc((size_t)limit, sizeof(cunit_test_report_t)) : NULL;
+
+	// Insertion into a short sorted array; ties keep registration order.
+	int count = 0;
+	for (const cunit_suite_t *suite = cunit__registry.suites; ranked && suite; suite = suite->next) {
+		for (const cunit_test_t *test = suite->tests; test; test = test->next) {
+			if (!test->selected) { continue; }
+			const double wall = test->result.timing.total.wall;
+			int          at   = count < limit ? count : limit;
+			while (at > 0 && ranked[at - 1].timing->total.wall < wall) { at--; }
+			if (at >= limit) { continue; }
+			const int moved = (count < limit ? count : limit - 1) - at;
+			memmove(&ranked[at + 1], &ranked[at], (size_t)moved * sizeof(cunit_test_report_t));
+			cunit__test_report(&ranked[at], suite, test);
+			if (count < limit) { count++; }
+		}
+	}
+
+	run.slowest       = ranked;
+	run.slowest_count = count;
+	cunit__report_run_end(&run);
+	cunit__report_flush();
+	free(ranked);
 }
 
 // This function is called when a test passes.
 void cunit__handle_pass(const cunit_context_t ctx) {
 	if (!cunit__registry.test_running) {
+		cunit__report_flush();
 		printf("\033[32;2m%s:%d\033[0m ", __cunit_relative(ctx.file), ctx.line);
 		fputs("test passed!" STR_NEWLINE, stdout);
 		exit(EXIT_SUCCESS);
 	}
 }
 
+// Reports the end of a run that a failure ends in FAIL_FAST mode: the failed test,
+// its suite and the run, so that the output files record the failure and are complete.
+static void cunit__fail_fast(cunit_worker_t *worker) {
+	cunit_suite_t *suite = worker->suite;
+	cunit_test_t  *test  = worker->test;
+	if (worker->record) {
+		// Off the main thread nothing of the suite has been reported yet.
+		cunit__report_suite_begin(suite);
+		cunit__report_test_begin(suite, test);
+		cunit__events_replay(worker->events.data, worker->events.size);
+	}
+	memset(&test->result, 0, sizeof(cunit_result_t));
+	test->result.status = CUNIT_STATUS_FAILED;
+	// Where the test stopped is unknown, so all of the time counts as body time.
+	test->result.timing.body.wall  = (double)(cunit_clock_now() - worker->started) / 1e9;
+	test->result.timing.total.wall = test->result.timing.body.wall;
+	test->result.assertions        = __cunit_assertions;
+	cunit__registry.total_failed++;
+	cunit__report_test(suite, test);
+	cunit__report_suite_end(suite);
+	cunit__report_run();
+	cunit__junit_close();
+	cunit__json_close();
+	cunit__log_close();
+}
+
 // This function is called when a test fails.
 void cunit__handle_fail(const cunit_context_t ctx) {
-	printf("\033[31;2m%s:%d\033[0m ", __cunit_relative(ctx.file), ctx.line);
-	fputs("test failed!" STR_NEWLINE, stdout);
-	if (!cunit__registry.test_running) { exit(EXIT_FAILURE); }
+	cunit_failure_t failure;
+	failure.ctx     = ctx;
+	failure.message = NULL;
+	failure.note    = NULL;
+	failure.fatal   = true;
+	cunit__report_failure(&failure);
+	if (!cunit__registry.test_running) {
+		cunit__report_flush();
+		exit(EXIT_FAILURE);
+	}
 	cunit__mark_failed();
 	if (cunit__registry.error_mode == CUNIT_ERROR_MODE_FAIL_FAST) {
-		printf("[ \033[31mFAILED\033[0m ] Stopping on first failure\n");
+		cunit__fail_fast(cunit__current_worker());
 		exit(EXIT_FAILURE);
 	} else if (cunit__registry.error_mode == CUNIT_ERROR_MODE_COLLECT) {
 		// In COLLECT mode, jump back to the test runner to skip the rest of the test
-		longjmp(cunit__registry.test_jmp_buf, 1);
+		longjmp(cunit__current_worker()->test_jmp_buf, 1);
 	}
 }
 
+// Reports a failure, or records it if the calling thread's tests are reported later.
+void cunit__report_failure(const cunit_failure_t *failure) {
+	cunit_worker_t *worker = cunit__current_worker();
+	// The memory kept for the failure is not the test's.
+	cunit__alloc_suspend();
+	if (worker->record) {
+		cunit__events_record(&worker->events, failure);
+	} else {
+		cunit__report_dispatch(failure);
+	}
+	cunit__alloc_resume();
+}
+
+// Makes the calling thread record failures for later replay.
+void cunit__record_failures(bool record) { cunit__current_worker()->record = record; }
+
+// Sets the rerun mode from its name, returning false if the name is unknown.
+static bool cunit__rerun_parse(const char *name) {
+	if (strcmp(name, "failed-first") == 0) {
+		cunit__registry.rerun_mode = CUNIT_RERUN_FAILED_FIRST;
+	} else if (strcmp(name, "last-failed") == 0) {
+		cunit__registry.rerun_mode = CUNIT_RERUN_LAST_FAILED;
+	} else if (strcmp(name, "all") == 0) {
+		cunit__registry.rerun_mode = CUNIT_RERUN_ALL;
+	} else {
+		return false;
+	}
+	return true;
+}
+
+// Sets the zero-assertion mode from its name, returning false if the name is unknown.
+static bool cunit__zero_assertions_parse(const char *name) {
+	if (strcmp(name, "ignore") == 0) {
+		cunit__registry.zero_assertions = CUNIT_ZERO_ASSERTIONS_IGNORE;
+	} else if (strcmp(name, "warn") == 0) {
+		cunit__registry.zero_assertions = CUNIT_ZERO_ASSERTIONS_WARN;
+	} else if (strcmp(name, "fail") == 0) {
+		cunit__registry.zero_assertions = CUNIT_ZERO_ASSERTIONS_FAIL;
+	} else {
+		return false;
+	}
+	return true;
+}
+
 // Initializes the cunit framework.
 void cunit__internal_init(void) {
 	if (cunit__registry.is_initialized) { return; }
 	cunit__internal_relative_init();
+	cunit__console_init();
 	cunit__registry.error_mode     = CUNIT_ERROR_MODE_COLLECT;
 	cunit__registry.is_initialized = true;
+
+	const char *jobs = getenv("CUNIT_JOBS");
+	if (!STR_ISEMPTY(jobs)) { cunit_set_jobs(strcmp(jobs, "auto") == 0 ? 0 : atoi(jobs)); }
+	const char *exec_mode = getenv("CUNIT_EXEC_MODE");
+	if (!STR_ISEMPTY(exec_mode) && strcmp(exec_mode, "fork") == 0) { cunit__registry.exec_mode = CUNIT_EXEC_MODE_FORK; }
+	const char *shard_index = getenv("CUNIT_SHARD_INDEX");
+	const char *shard_count = getenv("CUNIT_SHARD_COUNT");
+	if (!STR_ISEMPTY(shard_index) && !STR_ISEMPTY(shard_count)) { cunit_set_shard(atoi(shard_index), atoi(shard_count)); }
+	const char *timing_file = getenv("CUNIT_TIMING_FILE");
+	if (!STR_ISEMPTY(timing_file)) { cunit__registry.timing_file = timing_file; }
+	const char *slowest = getenv("CUNIT_SLOWEST");
+	if (!STR_ISEMPTY(slowest)) { cunit_set_slowest(atoi(slowest)); }
+	const char *bench_time = getenv("CUNIT_BENCH_TIME");
+	if (!STR_ISEMPTY(bench_time)) { cunit_set_bench_time(atof(bench_time)); }
+	const char *bench_repetitions = getenv("CUNIT_BENCH_REPETITIONS");
+	if (!STR_ISEMPTY(bench_repetitions)) { cunit_set_bench_repetitions(atoi(bench_repetitions)); }
+	const char *bench_baseline = getenv("CUNIT_BENCH_BASELINE");
+	if (!STR_ISEMPTY(bench_baseline)) { cunit__registry.bench_baseline = bench_baseline; }
+	const char *bench_update = getenv("CUNIT_BENCH_UPDATE");
+	if (!STR_ISEMPTY(bench_update)) { cunit__registry.bench_update = strcmp(bench_update, "0") != 0; }
+	const char *bench_threshold = getenv("CUNIT_BENCH_THRESHOLD");
+	if (!STR_ISEMPTY(bench_threshold)) { cunit__registry.bench_threshold = atof(bench_threshold); }
+	const char *bench_sigmas = getenv("CUNIT_BENCH_SIGMAS");
+	if (!STR_ISEMPTY(bench_sigmas)) { cunit__registry.bench_sigmas = atof(bench_sigmas); }
+	const char *junit_file = getenv("CUNIT_JUNIT_FILE");
+	if (!STR_ISEMPTY(junit_file)) { cunit_add_reporter(cunit_junit_reporter(junit_file)); }
+	const char *json_file = getenv("CUNIT_JSON_FILE");
+	if (!STR_ISEMPTY(json_file)) { cunit_add_reporter(cunit_json_reporter(json_file)); }
+	const char *failed_file = getenv("CUNIT_FAILED_FILE");
+	if (!STR_ISEMPTY(failed_file)) { cunit__registry.failed_file = failed_file; }
+	const char *rerun = getenv("CUNIT_RERUN");
+	if (!STR_ISEMPTY(rerun)) { cunit__rerun_parse(rerun); }
+	const char *filter = getenv("CUNIT_FILTER");
+	if (!STR_ISEMPTY(filter)) { cunit__registry.filter = filter; }
+	const char *timeout = getenv("CUNIT_TIMEOUT");
+	if (!STR_ISEMPTY(timeout)) { cunit_set_timeout(atof(timeout)); }
+	const char *counters = getenv("CUNIT_COUNTERS");
+	if (!STR_ISEMPTY(counters)) { cunit__registry.counters = strcmp(counters, "0") != 0; }
+	const char *zero_assertions = getenv("CUNIT_ZERO_ASSERTIONS");
+	if (!STR_ISEMPTY(zero_assertions)) { cunit__zero_assertions_parse(zero_assertions); }
+	const char *hex_context = getenv("CUNIT_HEX_CONTEXT");
+	if (!STR_ISEMPTY(hex_context)) { cunit_set_hex_context(atoi(hex_context)); }
+	const char *hex_ranges = getenv("CUNIT_HEX_RANGES");
+	if (!STR_ISEMPTY(hex_ranges)) { cunit_set_hex_ranges(atoi(hex_ranges)); }
+	const char *update_golden = getenv("CUNIT_UPDATE_GOLDEN");
+	if (!STR_ISEMPTY(update_golden)) { cunit__registry.update_golden = strcmp(update_golden, "0") != 0; }
+	const char *event_log = getenv("CUNIT_EVENT_LOG");
+	if (!STR_ISEMPTY(event_log)) { cunit_add_reporter(cunit_log_reporter(event_log)); }
 }
 
 // Initializes the cunit framework using a once-only mechanism.
@@ -145,26 +403,26 @@ void cunit_init(void) {
 
 // Cleans up all resources used by cunit.
 void cunit_cleanup(void) {
-	cunit_suite_t *suite = cunit__registry.suites;
-	while (suite) {
-		cunit_test_t *test = suite->tests;
-		while (test) {
-			cunit_test_t *next_test = test->next;
-			free(test);
-			test = next_test;
-		}
-		cunit_suite_t *next_suite = suite->next;
-		free(suite);
-		suite = next_suite;
-	}
-	memset(&cunit__registry, 0, sizeof(cunit_registry_t));
+	// Recorded failures are freed once replayed, so the suites and tests own
+	// no other memory and go with their arena.
+	cunit_arena_free(&cunit__registry.arena);
+	cunit__db_free(&cunit__registry.timings);
+	cunit__db_free(&cunit__registry.baseline);
+	cunit__db_free(&cunit__registry.failed);
+	cunit__index_free(&cunit__registry.index);
+	cunit__junit_close();
+	cunit__json_close();
+	cunit__log_close();
+	cunit__counters_close(&cunit__main_worker.perf);
+	const cunit_registry_t initial = CUNIT_REGISTRY_INIT;
+	cunit__registry                = initial;
 }
 
 // Adds a new test suite to the registry.
 void cunit_suite(const char *name, cunit_setup_func_t setup, cunit_teardown_func_t teardown) {
 	if (!cunit__registry.is_initialized) { cunit_init(); }
 
-	cunit_suite_t *suite = (cunit_suite_t *)calloc(1, sizeof(cunit_suite_t));
+	cunit_suite_t *suite = (cunit_suite_t *)cunit_arena_alloc(&cunit__registry.arena, sizeof(cunit_suite_t));
 	if (!suite) { return; }
 
 	suite->name     = name;
@@ -178,17 +436,21 @@ void cunit_suite(const char *name, cunit_setup_func_t setup, cunit_teardown_func
 	}
 	cunit__registry.last_suite    = suite;
 	cunit__registry.current_suite = suite;
+	cunit__registry.total_suites++;
+	cunit__index_add_suite(suite);
 }
 
-// Adds a new test to the current test suite.
-void cunit_test(const char *name, cunit_test_func_t test_func) {
-	if (!cunit__registry.current_suite) { return; }
+// Adds a new test or benchmark to the current test suite. Returns the test, or NULL on failure.
+static cunit_test_t *cunit__add_test(const char *name, cunit_test_func_t test_func, cunit_bench_func_t bench_func, const char *tags) {
+	if (!cunit__registry.current_suite) { return NULL; }
 
-	cunit_test_t *test = (cunit_test_t *)calloc(1, sizeof(cunit_test_t));
-	if (!test) { return; }
+	cunit_test_t *test = (cunit_test_t *)cunit_arena_alloc(&cunit__registry.arena, sizeof(cunit_test_t));
+	if (!test) { return NULL; }
 
-	test->name = name;
-	test->func = test_func;
+	test->name  = name;
+	test->func  = test_func;
+	test->bench = bench_func;
+	test->tags  = tags;
 
 	cunit_suite_t *current_suite = cunit__registry.current_suite;
 	if (!current_suite->tests) {
@@ -199,25 +461,209 @@ void cunit_test(const char *name, cunit_test_func_t test_func) {
 	current_suite->last_test = test;
 	current_suite->test_count++;
 	cunit__registry.total_tests++;
+	cunit__index_add_test(current_suite, test);
+	return test;
 }
 
-// Runs all test suites.
-int cunit_run(void) {
-	cunit__registry.test_running = true;
+// Adds a new test to the current test suite.
+void cunit_test(const char *name, cunit_test_func_t test_func) { cunit__add_test(name, test_func, NULL, NULL); }
+
+// Adds a new test with tags to the current test suite.
+void cunit_test_tagged(const char *name, cunit_test_func_t test_func, const char *tags) { cunit__add_test(name, test_func, NULL, tags); }
+
+// Adds a new test with its own timeout to the current test suite.
+void cunit_test_timeout(const char *name, cunit_test_func_t test_func, double seconds) {
+	cunit_test_t *test = cunit__add_test(name, test_func, NULL, NULL);
+	if (test) { test->timeout = seconds > 0 ? seconds : 0; }
+}
 
-	cunit_suite_t *suite = cunit__registry.suites;
-	while (suite) {
-		cunit__print_header(suite->name);
-		cunit_test_t *test = suite->tests;
-		while (test) {
-			cunit__run_test(suite, test);
-			test = test->next;
+// Adds a new benchmark to the current test suite.
+void cunit_bench(const char *name, cunit_bench_func_t bench_func) { cunit__add_test(name, NULL, bench_func, NULL); }
+
+// Shared state for one parallel run.
+typedef struct {
+	const cunit_work_t *works;    // The units of work.
+	cunit_worker_t     *workers;  // The per-thread state, indexed by pool worker.
+} cunit_parallel_t;
+
+// Runs one unit of work on a pool thread.
+static void cunit__run_work(void *arg, size_t item, int worker) {
+	cunit_parallel_t   *parallel = (cunit_parallel_t *)arg;
+	const cunit_work_t *work     = &parallel->works[item];
+
+	cunit__worker = &parallel->workers[worker];
+	if (work->test) {
+		cunit__run_test(work->suite, work->test);
+		return;
+	}
+	for (cunit_test_t *test = work->suite->tests; test; test = test->next) {
+		if (test->selected && !test->bench) { cunit__run_test(work->suite, test); }
+	}
+}
+
+// Returns the number of selected tests in `suite` that may run in parallel.
+static int cunit__count_parallel(const cunit_suite_t *suite) {
+	int count = 0;
+	for (const cunit_test_t *test = suite->tests; test; test = test->next) {
+		if (test->selected && !test->bench) { count++; }
+	}
+	return count;
+}
+
+// Lists the units of work for `suite` (or for all suites if NULL). With
+// `group_fixtures`, a suite with a setup or teardown function becomes a
+// single unit so that its fixtures never overlap. Benchmarks are left out:
+// they run serially afterwards so that they are not measured under load.
+// With timing history, the longest units come first.
+static cunit_work_t *cunit__collect_works(cunit_suite_t *only, bool group_fixtures, size_t *count) {
+	size_t total = 0;
+	for (cunit_suite_t *suite = only ? only : cunit__registry.suites; suite; suite = only ? NULL : suite->next) {
+		const int tests = cunit__count_parallel(suite);
+		if (!tests) { continue; }
+		total += (group_fixtures && (suite->setup || suite->teardown)) ? 1 : (size_t)tests;
+	}
+
+	cunit_work_t *works = (cunit_work_t *)calloc(total ? total : 1, sizeof(cunit_work_t));
+	if (!works) { return NULL; }
+
+	size_t index = 0;
+	for (cunit_suite_t *suite = only ? only : cunit__registry.suites; suite; suite = only ? NULL : suite->next) {
+		if (!cunit__count_parallel(suite)) { continue; }
+		if (group_fixtures && (suite->setup || suite->teardown)) {
+			works[index].suite  = suite;
+			works[index++].test = NULL;
+			continue;
+		}
+		for (cunit_test_t *test = suite->tests; test; test = test->next) {
+			if (!test->selected || test->bench) { continue; }
+			works[index].suite  = suite;
+			works[index++].test = test;
+		}
+	}
+	*count = index;
+	cunit__timing_schedule(works, index);
+	return works;
+}
+
+// Runs the tests of `suite` (or of all suites if NULL) in forked workers.
+// Every test is its own unit, since each process has its own fixtures.
+static bool cunit__run_isolated(cunit_suite_t *only) {
+	size_t        count = 0;
+	cunit_work_t *works = cunit__collect_works(only, false, &count);
+	if (!works) { return false; }
+
+	const bool ran = cunit__run_forked(works, count);
+	for (size_t i = 0; ran && i < count; i++) {
+		if (!works[i].test->selected) { continue; }
+		if (works[i].test->result.status == CUNIT_STATUS_PASSED) {
+			cunit__registry.total_passed++;
+		} else {
+			cunit__registry.total_failed++;
 		}
-		cunit__print_summary(suite);
-		suite = suite->next;
 	}
+	free(works);
+	return ran;
+}
+
+// Runs the tests of `suite` (or of all suites if NULL) on the thread pool.
+static bool cunit__run_parallel(cunit_suite_t *only) {
+	if (cunit__registry.exec_mode == CUNIT_EXEC_MODE_FORK && cunit__run_isolated(only)) { return true; }
+	if (cunit__registry.jobs <= 1) { return false; }
+
+	const int       jobs    = cunit__registry.jobs;
+	size_t          count   = 0;
+	cunit_work_t   *works   = cunit__collect_works(only, true, &count);
+	cunit_worker_t *workers = (cunit_worker_t *)calloc((size_t)jobs, sizeof(cunit_worker_t));
+	if (!works || !workers) {
+		free(works);
+		free(workers);
+		return false;
+	}
+
+	for (int i = 0; i < jobs; i++) { workers[i].record = true; }
+	cunit_parallel_t parallel = {works, workers};
+	cunit__watchdog_start();
+	cunit__pool_run(count, jobs, cunit__run_work, &parallel);
+	cunit__worker = NULL;
+
+	for (int i = 0; i < jobs; i++) {
+		cunit__registry.total_passed += workers[i].passed;
+		cunit__registry.total_failed += workers[i].failed;
+		cunit_buffer_free(&workers[i].events);
+		cunit__counters_close(&workers[i].perf);
+	}
+	free(workers);
+	free(works);
+	return true;
+}
+
+// Returns whether a timeout aborted the run, or a failure stopped it in FAIL_FAST mode.
+static bool cunit__run_stopped(void) { return cunit__registry.stopped || cunit__watchdog_aborted(); }
+
+// Runs the tests of `suite` (or of all suites if NULL) and reports them.
+static void cunit__run_suites(cunit_suite_t *only) {
+	cunit__auto_register();
+	cunit__registry.test_running = true;
+	cunit__registry.stopped      = false;
+	cunit__timing_load();
+	cunit__baseline_load();
+	cunit__filter_select();
+	cunit__rerun_select();
+	cunit__shard_select();
+	cunit__rerun_order();
+	if (!only) { cunit__report_run_begin(cunit__registry.total_selected); }
+
+	// In parallel mode all tests run first and are then reported in
+	// registration order, so the output matches that of a serial run.
+	const bool ran = cunit__run_parallel(only);
+	cunit__watchdog_start();
+
+	for (cunit_suite_t *suite = only ? only : cunit__registry.suites; suite; suite = only ? NULL : suite->next) {
+		// Once the run was stopped, the tests that would run now are left out.
+		for (cunit_test_t *test = suite->tests; cunit__run_stopped() && test; test = test->next) {
+			if (test->selected && (!ran || test->bench)) { cunit__watchdog_skip(suite, test); }
+		}
+		// Suites whose tests all belong to other shards are left out entirely.
+		if (suite->test_count && !suite->selected_count) { continue; }
+		cunit__report_suite_begin(suite);
+		for (cunit_test_t *test = suite->tests; test; test = test->next) {
+			if (!test->selected) { continue; }
+			if ((!ran || test->bench) && cunit__run_stopped()) {
+				cunit__watchdog_skip(suite, test);
+				continue;
+			}
+			cunit__report_test_begin(suite, test);
+			if (!ran || test->bench) {
+				cunit__run_test(suite, test);
+			} else if (test->events) {
+				cunit__events_replay(test->events, test->events_size);
+				free(test->events);
+				test->events      = NULL;
+				test->events_size = 0;
+			}
+			cunit__report_test(suite, test);
+		}
+		cunit__report_suite_end(suite);
+	}
+
+	// Tests that ran on this thread: all of them when serial, else the benchmarks.
+	cunit__registry.total_passed += cunit__main_worker.passed;
+	cunit__registry.total_failed += cunit__main_worker.failed;
+	cunit__main_worker.passed = 0;
+	cunit__main_worker.failed = 0;
+	cunit__watchdog_beat();
+	cunit__timing_save();
+	cunit__watchdog_beat();
+	cunit__baseline_save();
+	cunit__watchdog_beat();
+	cunit__rerun_save(only);
+}
 
-	cunit__print_final();
+// Runs all test suites.
+int cunit_run(void) {
+	cunit__run_suites(NULL);
+	cunit__report_run();
+	cunit__watchdog_stop();
 
 	const int failed_count = cunit__registry.total_failed;
 	cunit_cleanup();
@@ -226,23 +672,91 @@ int cunit_run(void) {
 
 // Runs a specific test suite.
 int cunit_run_suite(const char *suite_name) {
-	cunit_suite_t *suite = cunit__registry.suites;
-	while (suite) {
-		if (strcmp(suite->name, suite_name) == 0) {
-			cunit__registry.test_running = true;
-			cunit__print_header(suite->name);
-			cunit_test_t *test = suite->tests;
-			while (test) {
-				cunit__run_test(suite, test);
-				test = test->next;
-			}
-			cunit__print_summary(suite);
-			cunit__registry.test_running = false;
-			return suite->failed_count;
+	cunit__auto_register();
+	cunit_suite_t *suite = cunit__index_find_suite(suite_name);
+	if (!suite) { return -1; }  // Suite not found
+	cunit__run_suites(suite);
+	cunit__report_flush();
+	cunit__watchdog_stop();
+	cunit__registry.test_running = false;
+	return suite->failed_count;
+}
+
+// Sets the number of worker threads used to run tests.
+void cunit_set_jobs(int jobs) { cunit__registry.jobs = jobs > 0 ? jobs : cunit_cpu_count(); }
+
+// Sets the test execution mode.
+void cunit_set_exec_mode(cunit_exec_mode_t mode) { cunit__registry.exec_mode = mode; }
+
+// Sets the shard of the registered tests this process runs.
+void cunit_set_shard(int index, int count) {
+	cunit__registry.shard_index = index;
+	cunit__registry.shard_count = count;
+}
+
+// Sets the file used to record and read per-test durations.
+void cunit_set_timing_file(const char *path) { cunit__registry.timing_file = path; }
+
+// Sets how many of the slowest tests are listed after the run.
+void cunit_set_slowest(int count) { cunit__registry.slowest = count > 0 ? count : 0; }
+
+// Sets the file that lists the tests that failed in the last run.
+void cunit_set_failed_file(const char *path) { cunit__registry.failed_file = path; }
+
+// Sets whether the tests that failed last run first, or alone.
+void cunit_set_rerun_mode(cunit_rerun_mode_t mode) { cunit__registry.rerun_mode = mode; }
+
+// Sets the longest time any test may take.
+void cunit_set_timeout(double seconds) { cunit__registry.timeout = seconds > 0 ? seconds : 0; }
+
+// Enables or disables hardware performance counters.
+void cunit_set_counters(bool enable) { cunit__registry.counters = enable; }
+
+// Sets how a test that made no checks or assertions is treated.
+void cunit_set_zero_assertions(cunit_zero_assertions_t mode) { cunit__registry.zero_assertions = mode; }
+
+// Sets the rows of context shown around each difference of a hex diff.
+void cunit_set_hex_context(int rows) { cunit__registry.hex_context = rows > 0 ? rows : 0; }
+
+// Sets how many ranges of differences a hex diff shows.
+void cunit_set_hex_ranges(int ranges) { cunit__registry.hex_ranges = ranges > 0 ? ranges : 0; }
+
+// Makes golden-file checks rewrite the golden files rather than compare with them.
+void cunit_set_update_golden(bool enable) { cunit__registry.update_golden = enable; }
+
+// Applies the cunit options among the command-line arguments and removes them.
+int cunit_parse_args(int argc, char **argv) {
+	if (!cunit__registry.is_initialized) { cunit_init(); }
+
+	int kept = argc > 0 ? 1 : 0;
+	for (int i = kept; i < argc; i++) {
+		const char *arg = argv[i];
+		if (strncmp(arg, "--rerun=", 8) == 0 && cunit__rerun_parse(arg + 8)) { continue; }
+		if (strncmp(arg, "--zero-assertions=", 18) == 0 && cunit__zero_assertions_parse(arg + 18)) { continue; }
+		if (strcmp(arg, "--failed-first") == 0) {
+			cunit__registry.rerun_mode = CUNIT_RERUN_FAILED_FIRST;
+		} else if (strcmp(arg, "--last-failed") == 0) {
+			cunit__registry.rerun_mode = CUNIT_RERUN_LAST_FAILED;
+		} else if (strncmp(arg, "--failed-file=", 14) == 0) {
+			cunit__registry.failed_file = arg + 14;
+		} else if (strncmp(arg, "--filter=", 9) == 0) {
+			cunit__registry.filter = arg + 9;
+		} else if (strncmp(arg, "--timeout=", 10) == 0) {
+			cunit_set_timeout(atof(arg + 10));
+		} else if (strcmp(arg, "--counters") == 0) {
+			cunit__registry.counters = true;
+		} else if (strncmp(arg, "--hex-context=", 14) == 0) {
+			cunit_set_hex_context(atoi(arg + 14));
+		} else if (strncmp(arg, "--hex-ranges=", 13) == 0) {
+			cunit_set_hex_ranges(atoi(arg + 13));
+		} else if (strcmp(arg, "--update-golden") == 0) {
+			cunit__registry.update_golden = true;
+		} else {
+			argv[kept++] = argv[i];
 		}
-		suite = suite->next;
 	}
-	return -1;  // Suite not found
+	if (kept < argc) { argv[kept] = NULL; }
+	return kept;
 }
 
 // Sets the error handling mode.
@@ -254,13 +768,51 @@ int cunit_test_count(void) { return cunit__registry.total_tests; }
 // Gets the total number of failed tests.
 int cunit_failure_count(void) { return cunit__registry.total_failed; }
 
+// Gets the total number of checks and assertions made.
+uint64_t cunit_assertion_count(void) { return cunit__registry.total_assertions; }
+
 // Gets the total number of test suites.
 int cunit_suite_count(void) {
-	int            count = 0;
-	cunit_suite_t *suite = cunit__registry.suites;
-	while (suite) {
-		count++;
-		suite = suite->next;
-	}
-	return count;
+	cunit__auto_register();
+	return cunit__registry.total_suites;
+}
+
+// Gets the hardware counters of a test from the last run.
+bool cunit_test_counters(const char *suite_name, const char *test_name, cunit_counters_t *counters) {
+	const cunit_test_t *test = cunit__index_find_test(cunit__index_find_suite(suite_name), test_name);
+	if (!test || !test->selected || !test->result.counters.available) { return false; }
+	*counters = test->result.counters;
+	return true;
+}
+
+// Gets the number of checks and assertions a test made in the last run.
+bool cunit_test_assertions(const char *suite_name, const char *test_name, uint64_t *count) {
+	const cunit_test_t *test = cunit__index_find_test(cunit__index_find_suite(suite_name), test_name);
+	if (!test || !test->selected) { return false; }
+	*count = test->result.assertions;
+	return true;
+}
+
+// Gets the timing of a test from the last run.
+bool cunit_test_timing(const char *suite_name, const char *test_name, cunit_timing_t *timing) {
+	const cunit_test_t *test = cunit__index_find_test(cunit__index_find_suite(suite_name), test_name);
+	if (!test || !test->selected) { return false; }
+	*timing = test->result.timing;
+	return true;
+}
+
+// Gets the summed timing of the tests of a suite from the last run.
+bool cunit_suite_timing(const char *suite_name, cunit_timing_t *timing) {
+	const cunit_suite_t *suite = cunit__index_find_suite(suite_name);
+	if (!suite) { return false; }
+	*timing = suite->timing;
+	return true;
+}
+
+// Gets the statistics of a benchmark from the last run.
+bool cunit_bench_stats(const char *suite_name, const char *bench_name, cunit_bench_stats_t *stats) {
+	const cunit_test_t *test = cunit__index_find_test(cunit__index_find_suite(suite_name), bench_name);
+	if (!test || !test->bench || !test->selected || !test->result.bench.repetitions) { return false; }
+	*stats = test->result.bench;
+	return true;
 }
@@ -0,0 +1,150 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 tayne3
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ * 2. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *    SOFTWARE.
+ */
+#ifndef CUNIT_THREAD_H
+#define CUNIT_THREAD_H
+
+#include "cunit/def.h"
+
+#ifdef _WIN32
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef HANDLE           cunit_thread_t;
+typedef CRITICAL_SECTION cunit_mutex_t;
+typedef void (*cunit_thread_routine_t)(void *arg);
+
+typedef struct {
+	cunit_thread_routine_t routine;
+	void                  *arg;
+} __cunit_thread_start_t;
+
+static inline DWORD WINAPI __cunit_thread_trampoline(LPVOID param) {
+	__cunit_thread_start_t start = *(__cunit_thread_start_t *)param;
+	free(param);
+	start.routine(start.arg);
+	return 0;
+}
+
+static inline int cunit_thread_create(cunit_thread_t *thread, cunit_thread_routine_t routine, void *arg) {
+	__cunit_thread_start_t *start = (__cunit_thread_start_t *)malloc(sizeof(__cunit_thread_start_t));
+	if (!start) { return -1; }
+	start->routine = routine;
+	start->arg     = arg;
+	*thread        = CreateThread(NULL, 0, __cunit_thread_trampoline, start, 0, NULL);
+	if (!*thread) {
+		free(start);
+		return -1;
+	}
+	return 0;
+}
+
+static inline void cunit_thread_join(cunit_thread_t thread) {
+	WaitForSingleObject(thread, INFINITE);
+	CloseHandle(thread);
+}
+
+static inline void cunit_mutex_init(cunit_mutex_t *mutex) { InitializeCriticalSection(mutex); }
+static inline void cunit_mutex_destroy(cunit_mutex_t *mutex) { DeleteCriticalSection(mutex); }
+static inline void cunit_mutex_lock(cunit_mutex_t *mutex) { EnterCriticalSection(mutex); }
+static inline void cunit_mutex_unlock(cunit_mutex_t *mutex) { LeaveCriticalSection(mutex); }
+
+static inline int cunit_cpu_count(void) {
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return info.dwNumberOfProcessors > 0 ? (int)info.dwNumberOfProcessors : 1;
+}
+
+// Returns a pseudo handle, which only refers to the calling thread.
+static inline cunit_thread_t cunit_thread_self(void) { return GetCurrentThread(); }
+
+static inline void cunit_sleep_ms(unsigned ms) { Sleep(ms); }
+
+#ifdef __cplusplus
+}
+#endif
+#else
+#include <errno.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef pthread_t       cunit_thread_t;
+typedef pthread_mutex_t cunit_mutex_t;
+typedef void (*cunit_thread_routine_t)(void *arg);
+
+typedef struct {
+	cunit_thread_routine_t routine;
+	void                  *arg;
+} __cunit_thread_start_t;
+
+static inline void *__cunit_thread_trampoline(void *param) {
+	__cunit_thread_start_t start = *(__cunit_thread_start_t *)param;
+	free(param);
+	start.routine(start.arg);
+	return NULL;
+}
+
+static inline int cunit_thread_create(cunit_thread_t *thread, cunit_thread_routine_t routine, void *arg) {
+	__cunit_thread_start_t *start = (__cunit_thread_start_t *)malloc(sizeof(__cunit_thread_start_t));
+	if (!start) { return -1; }
+	start->routine = routine;
+	start->arg     = arg;
+	if (pthread_create(thread, NULL, __cunit_thread_trampoline, start) != 0) {
+		free(start);
+		return -1;
+	}
+	return 0;
+}
+
+static inline void cunit_thread_join(cunit_thread_t thread) { pthread_join(thread, NULL); }
+
+static inline void cunit_mutex_init(cunit_mutex_t *mutex) { pthread_mutex_init(mutex, NULL); }
+static inline void cunit_mutex_destroy(cunit_mutex_t *mutex) { pthread_mutex_destroy(mutex); }
+static inline void cunit_mutex_lock(cunit_mutex_t *mutex) { pthread_mutex_lock(mutex); }
+static inline void cunit_mutex_unlock(cunit_mutex_t *mutex) { pthread_mutex_unlock(mutex); }
+
+static inline int cunit_cpu_count(void) {
+	const long count = sysconf(_SC_NPROCESSORS_ONLN);
+	return count > 0 ? (int)count : 1;
+}
+
+static inline cunit_thread_t cunit_thread_self(void) { return pthread_self(); }
+
+static inline void cunit_sleep_ms(unsigned ms) {
+	struct timespec delay;
+	delay.tv_sec  = (time_t)(ms / 1000);
+	delay.tv_nsec = (long)(ms % 1000) * 1000000L;
+	while (nanosleep(&delay, &delay) != 0 && errno == EINTR) {}
+}
+
+#ifdef __cplusplus
+}
+#endif
+#endif
+
+#endif  // CUNIT_THREAD_H
@@ -0,0 +1,79 @@
+#include "registry.h"
+
+void cunit__timing_load(void) {
+	if (STR_ISEMPTY(cunit__registry.timing_file) || cunit__registry.timings.count) { return; }
+	cunit__db_load(&cunit__registry.timings, cunit__registry.timing_file);
+}
+
+void cunit__timing_save(void) {
+	// Every shard must balance from the same history, so shards only read it.
+	if (STR_ISEMPTY(cunit__registry.timing_file) || cunit__registry.shard_count > 1) { return; }
+
+	// Entries for tests outside this run (e.g. other shards) are kept as they are.
+	for (cunit_suite_t *suite = cunit__registry.suites; suite; suite = suite->next) {
+		for (cunit_test_t *test = suite->tests; test; test = test->next) {
+			if (!test->selected || test->result.status != CUNIT_STATUS_PASSED) { continue; }
+			cunit_db_entry_t *entry = cunit__db_put(&cunit__registry.timings, suite->name, test->name);
+			if (entry) { entry->values[0] = test->result.timing.total.wall; }
+		}
+	}
+	if (!cunit__db_save(&cunit__registry.timings, cunit__registry.timing_file)) {
+		fprintf(stderr, "cunit: cannot write timing file '%s'\n", cunit__registry.timing_file);
+	}
+}
+
+double cunit__timing_get(const cunit_suite_t *suite, const cunit_test_t *test) {
+	const cunit_db_entry_t *entry = cunit__db_find(&cunit__registry.timings, suite->name, test->name);
+	return entry ? entry->values[0] : -1.0;
+}
+
+// Orders works that must start first ahead of the others, then by descending
+// cost, then by registration order.
+static int cunit__work_compare(const void *a, const void *b) {
+	const cunit_work_t *l = (const cunit_work_t *)a;
+	const cunit_work_t *r = (const cunit_work_t *)b;
+	if (l->first != r->first) { return l->first ? -1 : 1; }
+	if (l->cost != r->cost) { return l->cost > r->cost ? -1 : 1; }
+	return (l->order > r->order) - (l->order < r->order);
+}
+
+// Adds the cost of one test to a unit of work, returning false if it has no history.
+static bool cunit__work_add(cunit_work_t *work, const cunit_test_t *test, double *longest) {
+	work->first       = work->first || (cunit__registry.rerun_mode == CUNIT_RERUN_FAILED_FIRST && test->failed_last);
+	const double cost = cunit__timing_get(work->suite, test);
+	if (cost < 0) { return false; }
+	work->cost += cost;
+	if (cost > *longest) { *longest = cost; }
+	return true;
+}
+
+void cunit__timing_schedule(cunit_work_t *works, size_t count) {
+	if (!cunit__registry.timings.count || count < 2) { return; }
+
+	// The cost of a unit is the sum of its tests; `unknown` counts the tests without history.
+	double  longest = 0;
+	size_t *unknown = (size_t *)calloc(count, sizeof(size_t));
+	if (!unknown) { return; }
+	for (size_t i = 0; i < count; i++) {
+		cunit_work_t *work = &works[i];
+		work->first        = false;
+		work->cost         = 0;
+		work->order        = i;
+		if (work->test) {
+			unknown[i] += !cunit__work_add(work, work->test, &longest);
+			continue;
+		}
+		for (const cunit_test_t *test = work->suite->tests; test; test = test->next) {
+			if (test->selected && !test->bench) { unknown[i] += !cunit__work_add(work, test, &longest); }
+		}
+	}
+
+	// A new test may well be long, and starting it early costs little if it is
+	// not, so it counts as the longest test on record.
+	for (size_t i = 0; i < count; i++) { works[i].cost += (double)unknown[i] * longest; }
+	free(unknown);
+
+	// The pools hand out work in this order, so the long tests start first and
+	// the short ones fill the gaps at the end.
+	qsort(works, count, sizeof(cunit_work_t), cunit__work_compare);
+}
@@ -0,0 +1,244 @@
+#include "clock.h"
+#include "registry.h"
+
+#ifndef _WIN32
+#include <signal.h>
+#include <unistd.h>
+#endif
+
+// How often the watchdog looks at the tests it watches, in milliseconds.
+#define CUNIT_WATCHDOG_TICK 10
+
+// How long an interrupted test may take to give up control, and the report of an
+// aborted run may go without a heartbeat once no test runs, in nanoseconds.
+#define CUNIT_WATCHDOG_GRACE 1000000000ull
+
+#ifndef _WIN32
+// The signal that interrupts a test. Ignored by default, so that one arriving
+// late does no harm.
+#define CUNIT_WATCHDOG_SIGNAL SIGURG
+#endif
+
+// The state of the watchdog.
+static struct {
+	cunit_mutex_t   lock;     // Protects the fields below, and the selection of tests once aborted.
+	cunit_thread_t  thread;   // The watchdog thread.
+	bool            running;  // Whether the watchdog thread runs.
+	bool            stop;     // Whether the watchdog thread must return.
+	bool            aborted;  // Whether a test timed out and the run was aborted.
+	cunit_worker_t *armed;    // The workers running tests, watched if their tests have a timeout.
+	// The first test that timed out. The code it was running when interrupted may
+	// have held a lock the report needs, so the report is watched in its place.
+	struct {
+		const cunit_suite_t *suite;
+		const cunit_test_t  *test;
+		uint64_t             started;   // When the test started.
+		uint64_t             deadline;  // When the report must have made progress again.
+	} tripped;
+#ifndef _WIN32
+	struct sigaction previous;  // The action of CUNIT_WATCHDOG_SIGNAL before the watchdog started.
+#endif
+} cunit__watchdog;
+
+// The worker of the calling thread while its test is watched.
+static CUNIT_THREAD_LOCAL cunit_worker_t *volatile cunit__watchdog_self = NULL;
+
+double cunit__timeout_of(const cunit_test_t *test) { return test->timeout > 0 ? test->timeout : cunit__registry.timeout; }
+
+// Ends the process, for a test that could not be interrupted or a run that could
+// not be reported after one was. The stdio locks may be held by the thread that
+// stopped, so stdout is flushed only if it is free, and stderr is not used.
+static void cunit__watchdog_exit(const cunit_suite_t *suite, const cunit_test_t *test, const char *what, uint64_t elapsed) {
+	char message[512];
+	snprintf(message, sizeof(message), "cunit: %s/%s %s after %.2f s; aborting" STR_NEWLINE, suite->name, test->name, what, (double)elapsed / 1e9);
+#ifdef _WIN32
+	fflush(stdout);
+	fputs(message, stderr);
+	fflush(stderr);
+#else
+	if (ftrylockfile(stdout) == 0) {
+		fflush(stdout);
+		funlockfile(stdout);
+	}
+	const ssize_t written = write(STDERR_FILENO, message, strlen(message));
+	(void)written;
+#endif
+	_exit(EXIT_FAILURE);
+}
+
+// The body of the watchdog thread.
+static void cunit__watchdog_main(void *arg) {
+	(void)arg;
+	cunit_mutex_lock(&cunit__watchdog.lock);
+	while (!cunit__watchdog.stop) {
+		const uint64_t now = cunit_clock_now();
+		for (cunit_worker_t *worker = cunit__watchdog.armed; worker; worker = worker->armed_next) {
+			if (!worker->deadline || now < worker->deadline) { continue; }
+#ifndef _WIN32
+			if (!worker->timed_out) {
+				// The test jumps out from the signal handler, or the next check gives up on it.
+				worker->timed_out = true;
+				worker->deadline  = now + CUNIT_WATCHDOG_GRACE;
+				pthread_kill(worker->thread, CUNIT_WATCHDOG_SIGNAL);
+				continue;
+			}
+#endif
+			cunit__watchdog_exit(worker->suite, worker->test, "is still running and cannot be interrupted", now - worker->started);
+		}
+		if (cunit__watchdog.tripped.test) {
+			// The report starts once no test runs, and moves the deadline on each heartbeat.
+			if (cunit__watchdog.armed) {
+				cunit__watchdog.tripped.deadline = now + CUNIT_WATCHDOG_GRACE;
+			} else if (now >= cunit__watchdog.tripped.deadline) {
+				cunit__watchdog_exit(cunit__watchdog.tripped.suite, cunit__watchdog.tripped.test, "timed out and the run cannot be reported",
+									 now - cunit__watchdog.tripped.started);
+			}
+		}
+		cunit_mutex_unlock(&cunit__watchdog.lock);
+		cunit_sleep_ms(CUNIT_WATCHDOG_TICK);
+		cunit_mutex_lock(&cunit__watchdog.lock);
+	}
+	cunit_mutex_unlock(&cunit__watchdog.lock);
+}
+
+#ifndef _WIN32
+// Leaves the interrupted test through the jump buffer set up before it started.
+static void cunit__watchdog_signal(int signal) {
+	(void)signal;
+	cunit_worker_t *worker = cunit__watchdog_self;
+	if (worker && worker->timed_out) { siglongjmp(worker->timeout_jmp_buf, 1); }
+}
+#endif
+
+void cunit__watchdog_start(void) {
+	if (cunit__watchdog.running) { return; }
+	bool any = cunit__registry.timeout > 0;
+	for (const cunit_suite_t *suite = cunit__registry.suites; suite && !any; suite = suite->next) {
+		for (const cunit_test_t *test = suite->tests; test && !any; test = test->next) { any = test->selected && test->timeout > 0; }
+	}
+	if (!any) { return; }
+
+	cunit_mutex_init(&cunit__watchdog.lock);
+	cunit__watchdog.stop  = false;
+	cunit__watchdog.armed = NULL;
+	memset(&cunit__watchdog.tripped, 0, sizeof(cunit__watchdog.tripped));
+#ifndef _WIN32
+	struct sigaction action;
+	memset(&action, 0, sizeof(action));
+	action.sa_handler = cunit__watchdog_signal;
+	sigemptyset(&action.sa_mask);
+	sigaction(CUNIT_WATCHDOG_SIGNAL, &action, &cunit__watchdog.previous);
+#endif
+	cunit__watchdog.running = cunit_thread_create(&cunit__watchdog.thread, cunit__watchdog_main, NULL) == 0;
+	if (!cunit__watchdog.running) {
+#ifndef _WIN32
+		sigaction(CUNIT_WATCHDOG_SIGNAL, &cunit__watchdog.previous, NULL);
+#endif
+		cunit_mutex_destroy(&cunit__watchdog.lock);
+	}
+}
+
+void cunit__watchdog_stop(void) {
+	cunit__watchdog.aborted = false;
+	if (!cunit__watchdog.running) { return; }
+	cunit_mutex_lock(&cunit__watchdog.lock);
+	cunit__watchdog.stop = true;
+	cunit_mutex_unlock(&cunit__watchdog.lock);
+	cunit_thread_join(cunit__watchdog.thread);
+#ifndef _WIN32
+	sigaction(CUNIT_WATCHDOG_SIGNAL, &cunit__watchdog.previous, NULL);
+#endif
+	cunit_mutex_destroy(&cunit__watchdog.lock);
+	cunit__watchdog.running = false;
+}
+
+// Takes a test out of the run. Called with the lock held.
+static void cunit__watchdog_deselect(cunit_suite_t *suite, cunit_test_t *test) {
+	test->selected = false;
+	suite->selected_count--;
+	cunit__registry.total_selected--;
+}
+
+bool cunit__watchdog_arm(cunit_worker_t *worker, cunit_suite_t *suite, cunit_test_t *test) {
+	// Without the watchdog nothing is watched, and the run is never aborted.
+	if (!cunit__watchdog.running) { return true; }
+	const double timeout = cunit__timeout_of(test);
+
+	cunit_mutex_lock(&cunit__watchdog.lock);
+	if (cunit__watchdog.aborted) {
+		cunit__watchdog_deselect(suite, test);
+		cunit_mutex_unlock(&cunit__watchdog.lock);
+		return false;
+	}
+	// Tests without a timeout are linked as well, so that the watchdog knows when none runs.
+	worker->thread        = cunit_thread_self();
+	worker->deadline      = timeout > 0 ? worker->started + (uint64_t)(timeout * 1e9) : 0;
+	worker->timed_out     = false;
+	worker->armed_next    = cunit__watchdog.armed;
+	cunit__watchdog.armed = worker;
+	cunit__watchdog_self  = worker;
+	cunit_mutex_unlock(&cunit__watchdog.lock);
+	return true;
+}
+
+// Stops watching a worker. Called with the lock held.
+static void cunit__watchdog_unlink(cunit_worker_t *worker) {
+	for (cunit_worker_t **link = &cunit__watchdog.armed; *link; link = &(*link)->armed_next) {
+		if (*link == worker) {
+			*link = worker->armed_next;
+			break;
+		}
+	}
+	worker->armed_next = NULL;
+	worker->deadline   = 0;
+}
+
+void cunit__watchdog_disarm(cunit_worker_t *worker) {
+	if (cunit__watchdog_self != worker) { return; }
+	// The test is over: a signal still on its way is ignored from here on.
+	cunit__watchdog_self = NULL;
+	cunit_mutex_lock(&cunit__watchdog.lock);
+	cunit__watchdog_unlink(worker);
+	cunit_mutex_unlock(&cunit__watchdog.lock);
+}
+
+double cunit__watchdog_trip(cunit_worker_t *worker) {
+	cunit__watchdog_self = NULL;
+	const uint64_t now   = cunit_clock_now();
+	cunit_mutex_lock(&cunit__watchdog.lock);
+	cunit__watchdog_unlink(worker);
+	cunit__watchdog.aborted = true;
+	if (!cunit__watchdog.tripped.test) {
+		cunit__watchdog.tripped.suite    = worker->suite;
+		cunit__watchdog.tripped.test     = worker->test;
+		cunit__watchdog.tripped.started  = worker->started;
+		cunit__watchdog.tripped.deadline = now + CUNIT_WATCHDOG_GRACE;
+	}
+	cunit_mutex_unlock(&cunit__watchdog.lock);
+	return (double)(now - worker->started) / 1e9;
+}
+
+bool cunit__watchdog_aborted(void) {
+	if (!cunit__watchdog.running) { return false; }
+	cunit_mutex_lock(&cunit__watchdog.lock);
+	const bool aborted = cunit__watchdog.aborted;
+	cunit_mutex_unlock(&cunit__watchdog.lock);
+	return aborted;
+}
+
+void cunit__watchdog_beat(void) {
+	if (!cunit__watchdog.running) { return; }
+	cunit_mutex_lock(&cunit__watchdog.lock);
+	if (cunit__watchdog.tripped.test) { cunit__watchdog.tripped.deadline = cunit_clock_now() + CUNIT_WATCHDOG_GRACE; }
+	cunit_mutex_unlock(&cunit__watchdog.lock);
+}
+
+void cunit__watchdog_skip(cunit_suite_t *suite, cunit_test_t *test) {
+	if (!cunit__watchdog.running) {
+		cunit__watchdog_deselect(suite, test);
+		return;
+	}
+	cunit_mutex_lock(&cunit__watchdog.lock);
+	cunit__watchdog_deselect(suite, test);
+	cunit_mutex_unlock(&cunit__watchdog.lock);
+}
@@ -0,0 +1,47 @@
+// The allocation wrappers of cunit::alloc. The program is linked with
+// --wrap=malloc and friends, so that its calls land here and the ones to
+// __real_malloc() reach the C library.
+#include "registry.h"
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t count, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+void  __real_free(void *ptr);
+
+void *__wrap_malloc(size_t size);
+void *__wrap_calloc(size_t count, size_t size);
+void *__wrap_realloc(void *ptr, size_t size);
+void  __wrap_free(void *ptr);
+
+// Turns tracking on before main() runs.
+__attribute__((constructor)) static void cunit__alloc_wrap_init(void) { cunit__alloc_enable(); }
+
+void *__wrap_malloc(size_t size) {
+	void *ptr = __real_malloc(size);
+	if (ptr) { cunit__alloc_note_malloc(ptr, size); }
+	return ptr;
+}
+
+void *__wrap_calloc(size_t count, size_t size) {
+	void *ptr = __real_calloc(count, size);
+	// The product cannot overflow, or calloc() would have failed.
+	if (ptr) { cunit__alloc_note_malloc(ptr, count * size); }
+	return ptr;
+}
+
+void *__wrap_realloc(void *ptr, size_t size) {
+	void *moved = __real_realloc(ptr, size);
+	if (moved) {
+		if (ptr) { cunit__alloc_note_free(ptr); }
+		cunit__alloc_note_malloc(moved, size);
+	} else if (ptr && size == 0) {
+		// realloc(ptr, 0) may free the block and return NULL.
+		cunit__alloc_note_free(ptr);
+	}
+	return moved;
+}
+
+void __wrap_free(void *ptr) {
+	if (ptr) { cunit__alloc_note_free(ptr); }
+	__real_free(ptr);
+}
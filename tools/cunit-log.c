@@ -0,0 +1,50 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "cunit.h"
+
+static int usage(void) {
+	fputs("usage: cunit-log [--format console|junit|json] [--output FILE] LOG\n"
+		  "Converts a binary event log written with CUNIT_EVENT_LOG.\n"
+		  "JUnit XML and JSON Lines need an output file; console text goes to stdout.\n",
+		  stderr);
+	return 2;
+}
+
+int main(int argc, char **argv) {
+	const char *format = "console";
+	const char *output = NULL;
+	const char *log    = NULL;
+	for (int i = 1; i < argc; i++) {
+		if ((strcmp(argv[i], "--format") == 0 || strcmp(argv[i], "-f") == 0) && i + 1 < argc) {
+			format = argv[++i];
+		} else if ((strcmp(argv[i], "--output") == 0 || strcmp(argv[i], "-o") == 0) && i + 1 < argc) {
+			output = argv[++i];
+		} else if (argv[i][0] != '-' && !log) {
+			log = argv[i];
+		} else {
+			return usage();
+		}
+	}
+	if (!log) { return usage(); }
+
+	const cunit_reporter_t *reporter;
+	if (strcmp(format, "console") == 0) {
+		reporter = cunit_console_reporter();
+	} else if (strcmp(format, "junit") == 0 && output) {
+		reporter = cunit_junit_reporter(output);
+	} else if (strcmp(format, "json") == 0 && output) {
+		reporter = cunit_json_reporter(output);
+	} else {
+		return usage();
+	}
+
+	const bool ok = cunit_log_replay(log, reporter);
+	// Closes the output of a log that ends before the end of its run.
+	cunit_cleanup();
+	if (!ok) {
+		fprintf(stderr, "cunit-log: %s is not a readable event log\n", log);
+		return 1;
+	}
+	return 0;
+}